@@ -9,6 +9,7 @@
 
 #include "CVCalibrationWindow.h"
 #include "Export/CSVExporter.h"
+#include "Export/FirmwareExporter.h"
 #include "Export/JSONExporter.h"
 #include "Export/OrnamentCrimeExporter.h"
 #include "ModernLookAndFeel.h"
@@ -26,6 +27,16 @@ CVSetupScreen::CVSetupScreen(CVCalibrationWindow* p, CVOutputManager* cv)
     titleLabel.setJustificationType(Justification::centred);
     addAndMakeVisible(titleLabel);
 
+    // Calibration Mode
+    modeLabel.setText("Mode:", dontSendNotification);
+    addAndMakeVisible(modeLabel);
+
+    modeCombo.addItem("Stepped (note by note)", 1);
+    modeCombo.addItem("Continuous sweep", 2);
+    modeCombo.setSelectedId(1);
+    modeCombo.addListener(this);
+    addAndMakeVisible(modeCombo);
+
     // Voltage Standard
     standardLabel.setText("Voltage Standard:", dontSendNotification);
     addAndMakeVisible(standardLabel);
@@ -67,6 +78,7 @@ CVSetupScreen::CVSetupScreen(CVCalibrationWindow* p, CVOutputManager* cv)
     stepCombo.addItem("Every octave", 2);
     stepCombo.addItem("Every 2 semitones", 3);
     stepCombo.addItem("Every 3 semitones", 4);
+    stepCombo.addItem("Adaptive (octaves, refined)", 5);
     stepCombo.setSelectedId(1);
     stepCombo.addListener(this);
     addAndMakeVisible(stepCombo);
@@ -80,17 +92,69 @@ CVSetupScreen::CVSetupScreen(CVCalibrationWindow* p, CVOutputManager* cv)
     settleSlider.setTextBoxStyle(Slider::TextBoxRight, false, 60, 20);
     addAndMakeVisible(settleSlider);
 
+    // Repeats (stepped mode only, outliers among three or more are replaced)
+    repeatsLabel.setText("Repeats per Note:", dontSendNotification);
+    addAndMakeVisible(repeatsLabel);
+
+    repeatsSlider.setRange(1, 5, 1);
+    repeatsSlider.setValue(1);
+    repeatsSlider.setTextBoxStyle(Slider::TextBoxRight, false, 60, 20);
+    addAndMakeVisible(repeatsSlider);
+
+    // Sweep Time (continuous mode only)
+    sweepLabel.setText("Sweep Time (s):", dontSendNotification);
+    addAndMakeVisible(sweepLabel);
+
+    sweepSlider.setRange(6, 60, 1);
+    sweepSlider.setValue(16);
+    sweepSlider.setTextBoxStyle(Slider::TextBoxRight, false, 60, 20);
+    sweepSlider.setEnabled(false);
+    addAndMakeVisible(sweepSlider);
+
+    // Interface loopback calibration (patch CV output 1 into the selected input)
+    addAndMakeVisible(loopbackLabel);
+
+    for (int i = 1; i <= 8; ++i)
+        loopbackInputCombo.addItem("Input " + String(i), i);
+    loopbackInputCombo.setSelectedId(2);
+    addAndMakeVisible(loopbackInputCombo);
+
+    loopbackButton.setButtonText("Loopback Cal");
+    loopbackButton.addListener(this);
+    addAndMakeVisible(loopbackButton);
+
+    if (auto* loopback = parent->getLoopbackCalibrator())
+        loopback->addListener(this);
+    updateLoopbackStatus();
+
+    // Optional CSV log that grows point by point during the run
+    pointLogToggle.setButtonText("Log points to CSV");
+    addAndMakeVisible(pointLogToggle);
+
     // Buttons
     startButton.setButtonText("Start Calibration");
     startButton.addListener(this);
     addAndMakeVisible(startButton);
 
+    // Only offered when an interrupted run left a journal behind
+    resumeButton.setButtonText("Resume Previous");
+    resumeButton.addListener(this);
+    addChildComponent(resumeButton);
+    resumeButton.setVisible(parent->getEngine() != nullptr && parent->getEngine()->hasResumableSession());
+
     cancelButton.setButtonText("Cancel");
     cancelButton.addListener(this);
     addAndMakeVisible(cancelButton);
 }
 
-CVSetupScreen::~CVSetupScreen() {}
+CVSetupScreen::~CVSetupScreen()
+{
+    if (auto* loopback = parent->getLoopbackCalibrator())
+    {
+        loopback->removeListener(this);
+        loopback->cancel();
+    }
+}
 
 void CVSetupScreen::resized()
 {
@@ -104,6 +168,11 @@ void CVSetupScreen::resized()
     const int spacing = 10;
 
     auto row = bounds.removeFromTop(rowHeight);
+    modeLabel.setBounds(row.removeFromLeft(labelWidth));
+    modeCombo.setBounds(row.reduced(spacing, 0));
+    bounds.removeFromTop(spacing);
+
+    row = bounds.removeFromTop(rowHeight);
     standardLabel.setBounds(row.removeFromLeft(labelWidth));
     standardCombo.setBounds(row.reduced(spacing, 0));
     bounds.removeFromTop(spacing);
@@ -126,13 +195,32 @@ void CVSetupScreen::resized()
     row = bounds.removeFromTop(rowHeight);
     settleLabel.setBounds(row.removeFromLeft(labelWidth));
     settleSlider.setBounds(row.reduced(spacing, 0));
+    bounds.removeFromTop(spacing);
+
+    row = bounds.removeFromTop(rowHeight);
+    repeatsLabel.setBounds(row.removeFromLeft(labelWidth));
+    repeatsSlider.setBounds(row.reduced(spacing, 0));
+    bounds.removeFromTop(spacing);
+
+    row = bounds.removeFromTop(rowHeight);
+    sweepLabel.setBounds(row.removeFromLeft(labelWidth));
+    sweepSlider.setBounds(row.reduced(spacing, 0));
+    bounds.removeFromTop(spacing);
+
+    row = bounds.removeFromTop(rowHeight);
+    loopbackLabel.setBounds(row.removeFromLeft(labelWidth + 80));
+    loopbackButton.setBounds(row.removeFromRight(110));
+    loopbackInputCombo.setBounds(row.reduced(spacing, 0));
     bounds.removeFromTop(30);
 
     // Buttons at bottom
     auto buttonRow = bounds.removeFromBottom(35);
     cancelButton.setBounds(buttonRow.removeFromLeft(100));
     buttonRow.removeFromLeft(spacing);
+    pointLogToggle.setBounds(buttonRow.removeFromLeft(150));
     startButton.setBounds(buttonRow.removeFromRight(150));
+    buttonRow.removeFromRight(spacing);
+    resumeButton.setBounds(buttonRow.removeFromRight(150));
 }
 
 void CVSetupScreen::paint(Graphics& g)
@@ -148,20 +236,93 @@ void CVSetupScreen::buttonClicked(Button* button)
 {
     if (button == &startButton)
     {
-        parent->startCalibration(getSettings());
+        auto settings = getSettings();
+        if (pointLogToggle.getToggleState())
+        {
+            FileChooser chooser("Save calibration log...", File(), "*.csv");
+            if (!chooser.browseForFileToSave(true))
+                return;
+            settings.pointLogFile = chooser.getResult().withFileExtension("csv");
+        }
+        parent->startCalibration(settings);
+    }
+    else if (button == &resumeButton)
+    {
+        parent->resumeCalibration();
     }
     else if (button == &cancelButton)
     {
         parent->close();
     }
+    else if (button == &loopbackButton)
+    {
+        auto* loopback = parent->getLoopbackCalibrator();
+        if (loopback == nullptr)
+            return;
+
+        if (loopback->isRunning())
+        {
+            loopback->cancel();
+            updateLoopbackStatus();
+            return;
+        }
+
+        LoopbackCalibrator::Settings loopbackSettings;
+        loopbackSettings.inputChannel = loopbackInputCombo.getSelectedId() - 1;
+
+        if (loopback->start(loopbackSettings))
+            loopbackButton.setButtonText("Stop");
+    }
+}
+
+void CVSetupScreen::updateLoopbackStatus()
+{
+    const auto& calibration = cvOutput->getInterfaceCalibration();
+
+    if (calibration.isCalibrated)
+        loopbackLabel.setText("Interface: calibrated (" + String(calibration.calibrationPoints.size()) + " points)",
+                              dontSendNotification);
+    else
+        loopbackLabel.setText("Interface: uncalibrated", dontSendNotification);
+
+    loopbackButton.setButtonText("Loopback Cal");
+}
+
+void CVSetupScreen::loopbackProgress(int step, int numSteps)
+{
+    loopbackLabel.setText("Loopback: step " + String(step + 1) + " / " + String(numSteps),
+                          dontSendNotification);
+}
+
+void CVSetupScreen::loopbackFinished(const CVOutputManager::InterfaceCalibration&)
+{
+    updateLoopbackStatus();
+}
+
+void CVSetupScreen::loopbackFailed(const String& error)
+{
+    updateLoopbackStatus();
+    loopbackLabel.setText(error, dontSendNotification);
 }
 
-void CVSetupScreen::comboBoxChanged(ComboBox*) {}
+void CVSetupScreen::comboBoxChanged(ComboBox* combo)
+{
+    if (combo == &modeCombo)
+    {
+        sweepSlider.setEnabled(modeCombo.getSelectedId() == 2);
+        repeatsSlider.setEnabled(modeCombo.getSelectedId() == 1);
+    }
+}
 
 CalibrationEngine::CalibrationSettings CVSetupScreen::getSettings() const
 {
     CalibrationEngine::CalibrationSettings settings;
 
+    // Mode
+    settings.mode = (modeCombo.getSelectedId() == 2)
+        ? CalibrationEngine::Mode::ContinuousSweep
+        : CalibrationEngine::Mode::Stepped;
+
     // Voltage standard
     settings.standard = (standardCombo.getSelectedId() == 1)
         ? CVOutputManager::VoltageStandard::OneVoltPerOctave
@@ -184,10 +345,13 @@ CalibrationEngine::CalibrationSettings CVSetupScreen::getSettings() const
         case 2: settings.noteStep = 12; break;
         case 3: settings.noteStep = 2; break;
         case 4: settings.noteStep = 3; break;
+        case 5: settings.noteStep = 1; settings.adaptive = true; break;
         default: settings.noteStep = 1; break;
     }
 
     settings.settleTimeMs = static_cast<int>(settleSlider.getValue());
+    settings.measurementsPerNote = static_cast<int>(repeatsSlider.getValue());
+    settings.sweepTimeSeconds = static_cast<float>(sweepSlider.getValue());
 
     return settings;
 }
@@ -354,6 +518,15 @@ void CVRunningScreen::calibrationPointCompleted(const CalibrationEngine::Calibra
 {
     currentNoteLabel.setText("Current Note: MIDI " + String(point.targetMidiNote), dontSendNotification);
     currentVoltageLabel.setText("Output Voltage: " + String(point.targetVoltage, 3) + " V", dontSendNotification);
+
+    if (!point.valid)
+    {
+        measuredFreqLabel.setText("Measured Frequency: -", dontSendNotification);
+        errorLabel.setColour(Label::textColourId, Colours::red);
+        errorLabel.setText("Skipped: " + point.failureReason.upToFirstOccurrenceOf(".", false, false), dontSendNotification);
+        return;
+    }
+
     measuredFreqLabel.setText("Measured Frequency: " + String(point.measuredFrequency, 2) + " Hz", dontSendNotification);
 
     String errorText = "Pitch Error: " + String(point.errorCents, 1) + " cents";
@@ -430,6 +603,10 @@ CVResultsScreen::CVResultsScreen(CVCalibrationWindow* p, const CalibrationTable&
     addAndMakeVisible(tableBox);
 
     // Export buttons
+    saveTableButton.setButtonText("Save Table");
+    saveTableButton.addListener(this);
+    addAndMakeVisible(saveTableButton);
+
     exportCSVButton.setButtonText("Export CSV");
     exportCSVButton.addListener(this);
     addAndMakeVisible(exportCSVButton);
@@ -442,6 +619,10 @@ CVResultsScreen::CVResultsScreen(CVCalibrationWindow* p, const CalibrationTable&
     exportOCButton.addListener(this);
     addAndMakeVisible(exportOCButton);
 
+    exportFirmwareButton.setButtonText("Export Firmware");
+    exportFirmwareButton.addListener(this);
+    addAndMakeVisible(exportFirmwareButton);
+
     doneButton.setButtonText("Done");
     doneButton.addListener(this);
     addAndMakeVisible(doneButton);
@@ -463,11 +644,15 @@ void CVResultsScreen::resized()
     auto buttonRow = bounds.removeFromBottom(35);
     doneButton.setBounds(buttonRow.removeFromRight(80));
     buttonRow.removeFromRight(10);
+    exportFirmwareButton.setBounds(buttonRow.removeFromRight(120));
+    buttonRow.removeFromRight(10);
     exportOCButton.setBounds(buttonRow.removeFromRight(100));
     buttonRow.removeFromRight(10);
     exportJSONButton.setBounds(buttonRow.removeFromRight(100));
     buttonRow.removeFromRight(10);
     exportCSVButton.setBounds(buttonRow.removeFromRight(100));
+    buttonRow.removeFromRight(10);
+    saveTableButton.setBounds(buttonRow.removeFromRight(100));
 
     bounds.removeFromBottom(10);
     tableBox.setBounds(bounds);
@@ -484,7 +669,16 @@ void CVResultsScreen::paint(Graphics& g)
 
 void CVResultsScreen::buttonClicked(Button* button)
 {
-    if (button == &exportCSVButton)
+    if (button == &saveTableButton)
+    {
+        // the stored table can be reloaded, e.g. for batch reports
+        FileChooser chooser("Save calibration table...", File(), "*.json");
+        if (chooser.browseForFileToSave(true))
+        {
+            calibrationTable.saveToFile(chooser.getResult().withFileExtension("json"));
+        }
+    }
+    else if (button == &exportCSVButton)
     {
         FileChooser chooser("Save CSV...", File(), "*.csv");
         if (chooser.browseForFileToSave(true))
@@ -508,6 +702,42 @@ void CVResultsScreen::buttonClicked(Button* button)
             OrnamentCrimeExporter::exportAsCHeader(calibrationTable, chooser.getResult().withFileExtension("h"));
         }
     }
+    else if (button == &exportFirmwareButton)
+    {
+        // built-in profiles plus the user's profile files
+        const File profileDirectory = FirmwareProfile::getDefaultDirectory();
+        StringArray errors;
+        const Array<FirmwareProfile> profiles = FirmwareProfile::loadAll(profileDirectory, errors);
+
+        const int showProfileFolder = 1;
+        const int firstProfile = 100;
+
+        PopupMenu menu;
+        for (int i = 0; i < profiles.size(); ++i)
+            menu.addItem(firstProfile + i, profiles[i].name);
+        menu.addSeparator();
+        menu.addItem(showProfileFolder, "Show Profile Folder");
+
+        const int choice = menu.showAt(&exportFirmwareButton);
+        if (choice != 0 && errors.size() > 0)
+            NativeMessageBox::showMessageBoxAsync(AlertWindow::WarningIcon, "Firmware Profiles",
+                                                  "These profiles were skipped:\n\n" + errors.joinIntoString("\n"));
+
+        if (choice == showProfileFolder)
+        {
+            profileDirectory.createDirectory();
+            profileDirectory.startAsProcess();
+        }
+        if (choice < firstProfile)
+            return;
+
+        const FirmwareProfile& profile = profiles.getReference(choice - firstProfile);
+        FileChooser chooser("Save " + profile.name + " Table...", File(), "*." + profile.fileExtension);
+        if (chooser.browseForFileToSave(true))
+        {
+            FirmwareExporter::exportCalibration(calibrationTable, profile, chooser.getResult().withFileExtension(profile.fileExtension));
+        }
+    }
     else if (button == &doneButton)
     {
         parent->close();
@@ -568,14 +798,21 @@ CVCalibrationWindow::CVCalibrationWindow(VCOTuner* t, CVOutputManager* cv, Visua
     : tuner(t), cvOutput(cv), visualizer(v)
 {
     engine = std::make_unique<CalibrationEngine>(tuner, cvOutput);
+
+    if (tuner != nullptr && cvOutput != nullptr && tuner->getAudioDeviceManager() != nullptr)
+        loopback = std::make_unique<LoopbackCalibrator>(*tuner->getAudioDeviceManager(), *cvOutput);
+
     showSetupScreen();
-    setSize(500, 450);
+    setSize(500, 610);
 }
 
 CVCalibrationWindow::~CVCalibrationWindow()
 {
     if (engine->isRunning())
         engine->cancelCalibration();
+
+    currentScreen.reset();
+    loopback.reset();
 }
 
 void CVCalibrationWindow::resized()
@@ -602,6 +839,17 @@ void CVCalibrationWindow::startCalibration(const CalibrationEngine::CalibrationS
     engine->startCalibration(settings);
 }
 
+void CVCalibrationWindow::resumeCalibration()
+{
+    currentScreen = std::make_unique<CVRunningScreen>(this, engine.get());
+    addAndMakeVisible(currentScreen.get());
+    currentScreenType = Screen::Running;
+    resized();
+
+    if (!engine->resumeFromJournal())
+        showSetupScreen();
+}
+
 void CVCalibrationWindow::showResults(const CalibrationTable& table)
 {
     currentScreen = std::make_unique<CVResultsScreen>(this, table);
@@ -13,6 +13,7 @@
 #include "VCOTuner.h"
 #include "Visualizer.h"
 #include "CVOutput/CVOutputManager.h"
+#include "CVOutput/LoopbackCalibrator.h"
 #include "Calibration/CalibrationEngine.h"
 #include "Calibration/CalibrationTable.h"
 
@@ -22,7 +23,8 @@ class CVCalibrationWindow;
 // Setup Screen - Configure calibration parameters
 class CVSetupScreen : public Component,
                       public Button::Listener,
-                      public ComboBox::Listener
+                      public ComboBox::Listener,
+                      public LoopbackCalibrator::Listener
 {
 public:
     CVSetupScreen(CVCalibrationWindow* parent, CVOutputManager* cvOut);
@@ -35,12 +37,22 @@ public:
 
     CalibrationEngine::CalibrationSettings getSettings() const;
 
+    // LoopbackCalibrator::Listener
+    void loopbackProgress(int step, int numSteps) override;
+    void loopbackFinished(const CVOutputManager::InterfaceCalibration& calibration) override;
+    void loopbackFailed(const String& error) override;
+
 private:
+    void updateLoopbackStatus();
+
     CVCalibrationWindow* parent;
     CVOutputManager* cvOutput;
 
     Label titleLabel;
 
+    Label modeLabel;
+    ComboBox modeCombo;
+
     Label standardLabel;
     ComboBox standardCombo;
 
@@ -56,7 +68,20 @@ private:
     Label settleLabel;
     Slider settleSlider;
 
+    Label repeatsLabel;
+    Slider repeatsSlider;
+
+    Label sweepLabel;
+    Slider sweepSlider;
+
+    Label loopbackLabel;
+    ComboBox loopbackInputCombo;
+    TextButton loopbackButton;
+
+    ToggleButton pointLogToggle;
+
     TextButton startButton;
+    TextButton resumeButton;
     TextButton cancelButton;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CVSetupScreen)
@@ -136,9 +161,11 @@ private:
 
     TableListBox tableBox;
 
+    TextButton saveTableButton;
     TextButton exportCSVButton;
     TextButton exportJSONButton;
     TextButton exportOCButton;
+    TextButton exportFirmwareButton;
     TextButton doneButton;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CVResultsScreen)
@@ -157,12 +184,14 @@ public:
     // Screen navigation
     void showSetupScreen();
     void startCalibration(const CalibrationEngine::CalibrationSettings& settings);
+    void resumeCalibration();
     void showResults(const CalibrationTable& table);
     void close();
 
     VCOTuner* getTuner() { return tuner; }
     CVOutputManager* getCVOutput() { return cvOutput; }
     CalibrationEngine* getEngine() { return engine.get(); }
+    LoopbackCalibrator* getLoopbackCalibrator() { return loopback.get(); }
 
 private:
     enum class Screen { Setup, Running, Results };
@@ -172,6 +201,7 @@ private:
     Visualizer* visualizer;
 
     std::unique_ptr<CalibrationEngine> engine;
+    std::unique_ptr<LoopbackCalibrator> loopback;
     std::unique_ptr<Component> currentScreen;
     Screen currentScreenType = Screen::Setup;
 
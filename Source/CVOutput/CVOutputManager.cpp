@@ -8,20 +8,23 @@
 */
 
 #include "CVOutputManager.h"
+#include "../Calibration/CalibrationTable.h"
+#include "InterfaceCorrectionLUT.h"
+
+//==============================================================================
+// CVOutputManager
+//==============================================================================
 
 CVOutputManager::CVOutputManager()
 {
+    for (int i = 0; i < maxNumChannels; ++i)
+        channels.push_back(std::unique_ptr<Channel>(new Channel(*this, i)));
 }
 
 CVOutputManager::~CVOutputManager()
 {
 }
 
-void CVOutputManager::setVoltageStandard(VoltageStandard standard)
-{
-    currentStandard = standard;
-}
-
 void CVOutputManager::setInterfaceType(InterfaceType type)
 {
     interfaceType = type;
@@ -54,50 +57,249 @@ void CVOutputManager::setCustomVoltageRange(float minVolts, float maxVolts)
     interfaceType = InterfaceType::Custom;
 }
 
-void CVOutputManager::outputVoltage(float volts)
+void CVOutputManager::fillOutputBuffers(float* const* outputs, int numOutputs, int numSamples)
 {
-    // Clamp to interface range
-    volts = juce::jlimit(interfaceMinVolts, interfaceMaxVolts, volts);
+    const int64 blockStart = outputSamplePosition.load();
+    outputSamplePosition.store(blockStart + numSamples);
 
-    // Apply interface calibration if available
-    if (interfaceCalibration.isCalibrated)
+    // Outputs without an active channel carry 0V
+    for (int ch = 0; ch < numOutputs; ++ch)
+    {
+        if (outputs[ch] != nullptr)
+            std::fill(outputs[ch], outputs[ch] + numSamples, 0.0f);
+    }
+
+    for (auto& channel : channels)
+    {
+        if (!channel->isActive())
+            continue;
+
+        const int index = channel->getOutputIndex();
+        if (isPositiveAndBelow(index, numOutputs) && outputs[index] != nullptr)
+            channel->render(outputs[index], numSamples, blockStart);
+    }
+}
+
+float CVOutputManager::voltageToSample(float volts) const
+{
+    // Map voltage range to -1.0 to +1.0 sample range
+    // For Expert Sleepers: -10V to +10V maps to -1.0 to +1.0
+    float range = interfaceMaxVolts - interfaceMinVolts;
+    float normalized = (volts - interfaceMinVolts) / range;  // 0 to 1
+    return normalized * 2.0f - 1.0f;  // -1 to +1
+}
+
+float CVOutputManager::sampleToVoltage(float sample) const
+{
+    // Map -1.0 to +1.0 sample range to voltage range
+    float normalized = (sample + 1.0f) / 2.0f;  // 0 to 1
+    float range = interfaceMaxVolts - interfaceMinVolts;
+    return interfaceMinVolts + normalized * range;
+}
+
+void CVOutputManager::saveCalibration(const File& file, int channel) const
+{
+    const auto& interfaceCalibration = getChannel(channel).getInterfaceCalibration();
+
+    var calibData(new DynamicObject());
+
+    calibData.getDynamicObject()->setProperty("isCalibrated", interfaceCalibration.isCalibrated);
+    calibData.getDynamicObject()->setProperty("gain", interfaceCalibration.gain);
+    calibData.getDynamicObject()->setProperty("offset", interfaceCalibration.offset);
+    calibData.getDynamicObject()->setProperty("interfaceName", interfaceCalibration.interfaceName);
+    calibData.getDynamicObject()->setProperty("calibrationDate",
+        interfaceCalibration.calibrationDate.toISO8601(true));
+    calibData.getDynamicObject()->setProperty("channel", channel);
+
+    Array<var> pointsArray;
+    for (const auto& p : interfaceCalibration.calibrationPoints)
+    {
+        var point(new DynamicObject());
+        point.getDynamicObject()->setProperty("ideal", p.first);
+        point.getDynamicObject()->setProperty("actual", p.second);
+        pointsArray.add(point);
+    }
+    calibData.getDynamicObject()->setProperty("points", pointsArray);
+
+    file.replaceWithText(JSON::toString(calibData, true));
+}
+
+bool CVOutputManager::loadCalibration(const File& file, int channel)
+{
+    if (!file.existsAsFile())
+        return false;
+
+    var calibData = JSON::parse(file.loadFileAsString());
+
+    if (!calibData.isObject())
+        return false;
+
+    InterfaceCalibration interfaceCalibration;
+    interfaceCalibration.isCalibrated = calibData.getProperty("isCalibrated", false);
+    interfaceCalibration.gain = calibData.getProperty("gain", 1.0f);
+    interfaceCalibration.offset = calibData.getProperty("offset", 0.0f);
+    interfaceCalibration.interfaceName = calibData.getProperty("interfaceName", "").toString();
+
+    String dateStr = calibData.getProperty("calibrationDate", "").toString();
+    if (dateStr.isNotEmpty())
+        interfaceCalibration.calibrationDate = Time::fromISO8601(dateStr);
+
+    if (calibData.hasProperty("points"))
     {
-        volts = applyInterfaceCalibration(volts);
+        auto* pointsArray = calibData.getProperty("points", var()).getArray();
+        if (pointsArray != nullptr)
+        {
+            for (const auto& point : *pointsArray)
+            {
+                float ideal = point.getProperty("ideal", 0.0f);
+                float actual = point.getProperty("actual", 0.0f);
+                interfaceCalibration.calibrationPoints.push_back({ideal, actual});
+            }
+        }
     }
 
+    getChannel(channel).setInterfaceCalibration(interfaceCalibration);
+    return true;
+}
+
+//==============================================================================
+// Channel
+//==============================================================================
+
+CVOutputManager::Channel::Channel(CVOutputManager& o, int index)
+    : owner(o), outputIndex(index)
+{
+}
+
+CVOutputManager::Channel::~Channel()
+{
+}
+
+void CVOutputManager::Channel::outputVoltage(float volts)
+{
+    stopRamp();
+
+    // Clamp to interface range, the interface calibration is applied per
+    // sample when the voltage is rendered
+    volts = juce::jlimit(owner.interfaceMinVolts, owner.interfaceMaxVolts, volts);
+
     currentOutputVoltage.store(volts);
 }
 
-void CVOutputManager::outputPitch(int midiNote)
+void CVOutputManager::Channel::outputPitch(float midiPitch)
 {
-    float voltage = midiToVoltage(midiNote);
+    float voltage = midiToVoltage(midiPitch);
+
+    // Pre-distort by the measured VCO error so the oscillator lands on pitch
+    if (correctionTable != nullptr)
+        voltage += correctionTable->getCorrectionOffset(midiPitch);
+
     outputVoltage(voltage);
 }
 
-void CVOutputManager::outputPitch(float midiPitchFloat)
+void CVOutputManager::Channel::outputFrequency(float hz)
 {
-    float voltage = midiToVoltage(midiPitchFloat);
-    outputVoltage(voltage);
+    if (correctionTable != nullptr && hz > 0.0f)
+    {
+        outputPitch(69.0f + 12.0f * std::log2(hz / 440.0f));
+        return;
+    }
+
+    outputVoltage(frequencyToVoltage(hz));
 }
 
-void CVOutputManager::outputFrequency(float hz)
+void CVOutputManager::Channel::startRamp(float startVolts, float endVolts, double legDurationSeconds, bool returnToStart)
 {
-    float voltage = frequencyToVoltage(hz);
-    outputVoltage(voltage);
+    stopRamp();
+
+    ramp.startVolts = juce::jlimit(owner.interfaceMinVolts, owner.interfaceMaxVolts, startVolts);
+    ramp.endVolts = juce::jlimit(owner.interfaceMinVolts, owner.interfaceMaxVolts, endVolts);
+    ramp.legSamples = juce::jmax((int64) 1, (int64) (legDurationSeconds * owner.sampleRate));
+    ramp.returnsToStart = returnToStart;
+
+    {
+        // The audio thread may still render the previous ramp from its own copy
+        const SpinLock::ScopedLockType lock(correctionLock);
+        pendingRamp = ramp;
+        rampStartPosition.store(-1);
+        rampState.store(RampState::Pending);
+    }
 }
 
-void CVOutputManager::fillOutputBuffer(float* buffer, int numSamples)
+void CVOutputManager::Channel::stopRamp()
 {
-    if (!isActiveFlag.load())
+    rampState.store(RampState::Idle);
+}
+
+float CVOutputManager::Channel::RampParameters::getVoltageAt(double samplePosition, int64 startPosition) const
+{
+    if (startPosition < 0)
+        return startVolts;
+
+    double t = (samplePosition - (double) startPosition) / (double) legSamples;
+
+    if (returnsToStart && t > 1.0)
+        t = 2.0 - t;
+
+    t = juce::jlimit(0.0, 1.0, t);
+    return startVolts + (float) t * (endVolts - startVolts);
+}
+
+void CVOutputManager::Channel::render(float* buffer, int numSamples, int64 blockStart)
+{
+    // Only held while the message thread swaps in a new correction table
+    const SpinLock::ScopedLockType lock(correctionLock);
+
+    RampState state = rampState.load();
+    if (state == RampState::Pending)
+    {
+        renderedRamp = pendingRamp;
+        rampStartPosition.store(blockStart);
+        rampState.store(RampState::Running);
+        state = RampState::Running;
+    }
+
+    if (state == RampState::Running)
     {
-        // Clear buffer if not active
+        // Render the ramp sample by sample, calibration is applied per sample
+        const int64 start = rampStartPosition.load();
+        const int64 rampLength = renderedRamp.getLengthInSamples();
+
         for (int i = 0; i < numSamples; ++i)
-            buffer[i] = 0.0f;
+        {
+            slewedVoltage = renderedRamp.getVoltageAt((double) (blockStart + i), start);
+            buffer[i] = owner.voltageToSample(applyInterfaceCalibration(slewedVoltage));
+        }
+
+        if (blockStart + numSamples - start >= rampLength)
+            rampState.store(RampState::Finished);
         return;
     }
 
     float voltage = currentOutputVoltage.load();
-    float sample = voltageToSample(voltage);
+    if (state == RampState::Finished)
+    {
+        // Hold the last ramp value until a new voltage is set
+        const int64 start = rampStartPosition.load();
+        voltage = renderedRamp.getVoltageAt((double) (start + renderedRamp.getLengthInSamples()), start);
+    }
+
+    const float rate = slewRate.load();
+    if (rate > 0.0f && slewedVoltage != voltage)
+    {
+        // Slew limited: move towards the target by at most one step per sample
+        const float maxStep = rate / (float) owner.sampleRate;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            slewedVoltage += juce::jlimit(-maxStep, maxStep, voltage - slewedVoltage);
+            buffer[i] = owner.voltageToSample(applyInterfaceCalibration(slewedVoltage));
+        }
+        return;
+    }
+
+    slewedVoltage = voltage;
+    float sample = owner.voltageToSample(applyInterfaceCalibration(voltage));
 
     // Fill buffer with DC value
     for (int i = 0; i < numSamples; ++i)
@@ -106,12 +308,7 @@ void CVOutputManager::fillOutputBuffer(float* buffer, int numSamples)
     }
 }
 
-float CVOutputManager::midiToVoltage(int midiNote) const
-{
-    return midiToVoltage(static_cast<float>(midiNote));
-}
-
-float CVOutputManager::midiToVoltage(float midiPitch) const
+float CVOutputManager::Channel::midiToVoltage(float midiPitch) const
 {
     switch (currentStandard)
     {
@@ -123,14 +320,14 @@ float CVOutputManager::midiToVoltage(float midiPitch) const
         {
             // Convert MIDI to frequency, then to voltage
             float freq = 440.0f * std::pow(2.0f, (midiPitch - 69.0f) / 12.0f);
-            return freq / hzPerVoltScaling;
+            return freq / owner.hzPerVoltScaling;
         }
     }
 
     return 0.0f;
 }
 
-float CVOutputManager::frequencyToVoltage(float hz) const
+float CVOutputManager::Channel::frequencyToVoltage(float hz) const
 {
     switch (currentStandard)
     {
@@ -142,13 +339,13 @@ float CVOutputManager::frequencyToVoltage(float hz) const
         }
 
         case VoltageStandard::HzPerVolt:
-            return hz / hzPerVoltScaling;
+            return hz / owner.hzPerVoltScaling;
     }
 
     return 0.0f;
 }
 
-float CVOutputManager::voltageToMidi(float voltage) const
+float CVOutputManager::Channel::voltageToMidi(float voltage) const
 {
     switch (currentStandard)
     {
@@ -157,7 +354,7 @@ float CVOutputManager::voltageToMidi(float voltage) const
 
         case VoltageStandard::HzPerVolt:
         {
-            float freq = voltage * hzPerVoltScaling;
+            float freq = voltage * owner.hzPerVoltScaling;
             return 69.0f + 12.0f * std::log2(freq / 440.0f);
         }
     }
@@ -165,45 +362,56 @@ float CVOutputManager::voltageToMidi(float voltage) const
     return 60.0f;
 }
 
-float CVOutputManager::voltageToSample(float volts) const
+float CVOutputManager::Channel::applyInterfaceCalibration(float voltage) const
 {
-    // Map voltage range to -1.0 to +1.0 sample range
-    // For Expert Sleepers: -10V to +10V maps to -1.0 to +1.0
-    float range = interfaceMaxVolts - interfaceMinVolts;
-    float normalized = (volts - interfaceMinVolts) / range;  // 0 to 1
-    return normalized * 2.0f - 1.0f;  // -1 to +1
+    // Linear or piecewise correction, depending on how many points were measured
+    return correction != nullptr ? correction->process(voltage) : voltage;
 }
 
-float CVOutputManager::sampleToVoltage(float sample) const
+void CVOutputManager::Channel::setInterfaceCalibration(const InterfaceCalibration& cal)
 {
-    // Map -1.0 to +1.0 sample range to voltage range
-    float normalized = (sample + 1.0f) / 2.0f;  // 0 to 1
-    float range = interfaceMaxVolts - interfaceMinVolts;
-    return interfaceMinVolts + normalized * range;
+    interfaceCalibration = cal;
+    rebuildCorrection();
 }
 
-float CVOutputManager::applyInterfaceCalibration(float voltage) const
+void CVOutputManager::Channel::clearInterfaceCalibration()
 {
-    // Apply linear correction: corrected = gain * voltage + offset
-    return interfaceCalibration.gain * voltage + interfaceCalibration.offset;
+    interfaceCalibration = InterfaceCalibration();
+    rebuildCorrection();
 }
 
-void CVOutputManager::setInterfaceCalibration(const InterfaceCalibration& cal)
+void CVOutputManager::Channel::rebuildCorrection()
 {
-    interfaceCalibration = cal;
+    // Compile outside the lock, the audio thread only waits for the swap
+    std::unique_ptr<InterfaceCorrectionLUT> newCorrection;
+
+    if (interfaceCalibration.isCalibrated)
+        newCorrection = std::make_unique<InterfaceCorrectionLUT>(interfaceCalibration.calibrationPoints,
+                                                                 interfaceCalibration.gain,
+                                                                 interfaceCalibration.offset);
+
+    {
+        const SpinLock::ScopedLockType lock(correctionLock);
+        std::swap(correction, newCorrection);
+    }
 }
 
-void CVOutputManager::clearInterfaceCalibration()
+void CVOutputManager::Channel::setCorrectionTable(const CalibrationTable& table)
 {
-    interfaceCalibration = InterfaceCalibration();
+    correctionTable = std::make_unique<CalibrationTable>(table);
+}
+
+void CVOutputManager::Channel::clearCorrectionTable()
+{
+    correctionTable.reset();
 }
 
-void CVOutputManager::addCalibrationPoint(float idealVoltage, float actualVoltage)
+void CVOutputManager::Channel::addCalibrationPoint(float idealVoltage, float actualVoltage)
 {
     interfaceCalibration.calibrationPoints.push_back({idealVoltage, actualVoltage});
 }
 
-void CVOutputManager::computeCalibrationFromPoints()
+void CVOutputManager::Channel::computeCalibrationFromPoints()
 {
     auto& points = interfaceCalibration.calibrationPoints;
 
@@ -211,6 +419,7 @@ void CVOutputManager::computeCalibrationFromPoints()
     {
         // Not enough points for calibration
         interfaceCalibration.isCalibrated = false;
+        rebuildCorrection();
         return;
     }
 
@@ -240,9 +449,9 @@ void CVOutputManager::computeCalibrationFromPoints()
 
     if (std::abs(denominator) < 1e-10f)
     {
-        // Degenerate case
+        // Degenerate case, only an offset can be corrected
         interfaceCalibration.gain = 1.0f;
-        interfaceCalibration.offset = meanActual - meanIdeal;
+        interfaceCalibration.offset = meanIdeal - meanActual;
     }
     else
     {
@@ -262,65 +471,8 @@ void CVOutputManager::computeCalibrationFromPoints()
 
     interfaceCalibration.isCalibrated = true;
     interfaceCalibration.calibrationDate = Time::getCurrentTime();
-}
 
-void CVOutputManager::saveCalibration(const File& file) const
-{
-    var calibData;
-
-    calibData.getDynamicObject()->setProperty("isCalibrated", interfaceCalibration.isCalibrated);
-    calibData.getDynamicObject()->setProperty("gain", interfaceCalibration.gain);
-    calibData.getDynamicObject()->setProperty("offset", interfaceCalibration.offset);
-    calibData.getDynamicObject()->setProperty("interfaceName", interfaceCalibration.interfaceName);
-    calibData.getDynamicObject()->setProperty("calibrationDate",
-        interfaceCalibration.calibrationDate.toISO8601(true));
-
-    Array<var> pointsArray;
-    for (const auto& p : interfaceCalibration.calibrationPoints)
-    {
-        var point;
-        point.getDynamicObject()->setProperty("ideal", p.first);
-        point.getDynamicObject()->setProperty("actual", p.second);
-        pointsArray.add(point);
-    }
-    calibData.getDynamicObject()->setProperty("points", pointsArray);
-
-    file.replaceWithText(JSON::toString(calibData, true));
-}
-
-bool CVOutputManager::loadCalibration(const File& file)
-{
-    if (!file.existsAsFile())
-        return false;
-
-    var calibData = JSON::parse(file.loadFileAsString());
-
-    if (!calibData.isObject())
-        return false;
-
-    interfaceCalibration.isCalibrated = calibData.getProperty("isCalibrated", false);
-    interfaceCalibration.gain = calibData.getProperty("gain", 1.0f);
-    interfaceCalibration.offset = calibData.getProperty("offset", 0.0f);
-    interfaceCalibration.interfaceName = calibData.getProperty("interfaceName", "").toString();
-
-    String dateStr = calibData.getProperty("calibrationDate", "").toString();
-    if (dateStr.isNotEmpty())
-        interfaceCalibration.calibrationDate = Time::fromISO8601(dateStr);
-
-    interfaceCalibration.calibrationPoints.clear();
-    if (calibData.hasProperty("points"))
-    {
-        auto* pointsArray = calibData.getProperty("points", var()).getArray();
-        if (pointsArray != nullptr)
-        {
-            for (const auto& point : *pointsArray)
-            {
-                float ideal = point.getProperty("ideal", 0.0f);
-                float actual = point.getProperty("actual", 0.0f);
-                interfaceCalibration.calibrationPoints.push_back({ideal, actual});
-            }
-        }
-    }
-
-    return true;
+    // With three or more points the linear fit only covers the extremes, the
+    // remaining non-linearity goes into the lookup table
+    rebuildCorrection();
 }
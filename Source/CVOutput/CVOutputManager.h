@@ -11,8 +11,12 @@
 
 #include <JuceHeader.h>
 #include <atomic>
+#include <memory>
 #include <vector>
 
+class CalibrationTable;
+class InterfaceCorrectionLUT;
+
 class CVOutputManager
 {
 public:
@@ -52,69 +56,206 @@ public:
         String interfaceName;
     };
 
+    // One independent CV output. Each channel has its own voltage, voltage
+    // standard, slew, interface calibration and optional correction table and
+    // renders into one output of the audio device.
+    class Channel
+    {
+    public:
+        ~Channel();
+
+        // Configuration
+        void setActive(bool active) { isActiveFlag.store(active); }
+        bool isActive() const { return isActiveFlag.load(); }
+
+        void setOutputIndex(int index) { outputIndex.store(index); }
+        int getOutputIndex() const { return outputIndex.load(); }
+
+        void setVoltageStandard(VoltageStandard standard) { currentStandard = standard; }
+        VoltageStandard getVoltageStandard() const { return currentStandard; }
+
+        // Maximum rate of change in volts per second, 0 disables slew limiting
+        void setSlewRate(float voltsPerSecond) { slewRate.store(juce::jmax(0.0f, voltsPerSecond)); }
+        float getSlewRate() const { return slewRate.load(); }
+
+        // Voltage output
+        void outputVoltage(float volts);
+        void outputPitch(float midiPitch);
+        void outputFrequency(float hz);
+        float getCurrentVoltage() const { return currentOutputVoltage.load(); }  // before interface calibration
+
+        // Voltage ramps for continuous sweeps. The ramp starts at the next audio
+        // block; with returnToStart it runs back down over the same duration.
+        void startRamp(float startVolts, float endVolts, double legDurationSeconds, bool returnToStart);
+        void stopRamp();
+        bool isRampRunning() const { return rampState.load() != RampState::Idle; }
+        bool isRampFinished() const { return rampState.load() == RampState::Finished; }
+        int64 getRampStartPosition() const { return rampStartPosition.load(); }
+        int64 getRampLengthInSamples() const { return ramp.getLengthInSamples(); }
+        float getRampVoltageAt(double samplePosition) const { return ramp.getVoltageAt(samplePosition, rampStartPosition.load()); }
+
+        // Interface calibration. With three or more points the correction is
+        // non-linear and evaluated from a lookup table on every output sample.
+        void setInterfaceCalibration(const InterfaceCalibration& cal);
+        const InterfaceCalibration& getInterfaceCalibration() const { return interfaceCalibration; }
+        void clearInterfaceCalibration();
+        void addCalibrationPoint(float idealVoltage, float actualVoltage);
+        void computeCalibrationFromPoints();
+
+        // Optional VCO correction table, applied by outputPitch()
+        void setCorrectionTable(const CalibrationTable& table);
+        void clearCorrectionTable();
+        bool hasCorrectionTable() const { return correctionTable != nullptr; }
+
+        // Conversion utilities using this channel's voltage standard
+        float midiToVoltage(float midiPitch) const;
+        float frequencyToVoltage(float hz) const;
+        float voltageToMidi(float voltage) const;
+
+    private:
+        friend class CVOutputManager;
+
+        enum class RampState
+        {
+            Idle,
+            Pending,
+            Running,
+            Finished
+        };
+
+        struct RampParameters
+        {
+            float startVolts = 0.0f;
+            float endVolts = 0.0f;
+            int64 legSamples = 1;
+            bool returnsToStart = false;
+
+            int64 getLengthInSamples() const { return legSamples * (returnsToStart ? 2 : 1); }
+            float getVoltageAt(double samplePosition, int64 startPosition) const;
+        };
+
+        Channel(CVOutputManager& owner, int outputIndex);
+
+        // Audio thread
+        void render(float* buffer, int numSamples, int64 blockStart);
+        float applyInterfaceCalibration(float voltage) const;
+        void rebuildCorrection();
+
+        CVOutputManager& owner;
+
+        std::atomic<float> currentOutputVoltage{0.0f};
+        std::atomic<bool> isActiveFlag{false};
+        std::atomic<int> outputIndex{0};
+        std::atomic<float> slewRate{0.0f};
+
+        // Owned by the message thread, which copies it to pendingRamp under
+        // correctionLock. The audio thread takes pendingRamp over into
+        // renderedRamp when it starts the ramp and only renders from that.
+        RampParameters ramp;
+        RampParameters pendingRamp;
+        RampParameters renderedRamp;
+        std::atomic<RampState> rampState{RampState::Idle};
+        std::atomic<int64> rampStartPosition{-1};
+
+        // Only accessed from the audio thread
+        float slewedVoltage = 0.0f;
+
+        VoltageStandard currentStandard = VoltageStandard::OneVoltPerOctave;
+        InterfaceCalibration interfaceCalibration;
+        std::unique_ptr<CalibrationTable> correctionTable;
+
+        // Compiled from interfaceCalibration, read by the audio thread
+        std::unique_ptr<InterfaceCorrectionLUT> correction;
+        SpinLock correctionLock;    // also guards pendingRamp
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Channel)
+    };
+
+    static const int maxNumChannels = 8;
+
     CVOutputManager();
     ~CVOutputManager();
 
+    // Multi-channel access. The single-channel API below acts on channel 0.
+    int getNumChannels() const { return static_cast<int>(channels.size()); }
+    Channel& getChannel(int index) { return *channels[static_cast<size_t>(index)]; }
+    const Channel& getChannel(int index) const { return *channels[static_cast<size_t>(index)]; }
+
     // Configuration
-    void setVoltageStandard(VoltageStandard standard);
-    VoltageStandard getVoltageStandard() const { return currentStandard; }
+    void setVoltageStandard(VoltageStandard standard) { getChannel(0).setVoltageStandard(standard); }
+    VoltageStandard getVoltageStandard() const { return getChannel(0).getVoltageStandard(); }
 
     void setInterfaceType(InterfaceType type);
     void setCustomVoltageRange(float minVolts, float maxVolts);
-    void setOutputChannel(int channel) { outputChannel = channel; }
+    void setOutputChannel(int channel) { getChannel(0).setOutputIndex(channel); }
     void setHzPerVoltScale(float hzPerVolt) { hzPerVoltScaling = hzPerVolt; }
 
     // Activation
-    void setActive(bool active) { isActiveFlag = active; }
-    bool isActive() const { return isActiveFlag; }
+    void setActive(bool active) { getChannel(0).setActive(active); }
+    bool isActive() const { return getChannel(0).isActive(); }
 
     // Voltage output
-    void outputVoltage(float volts);
-    void outputPitch(int midiNote);
-    void outputPitch(float midiPitchFloat);  // For microtonal
-    void outputFrequency(float hz);
-    float getCurrentVoltage() const { return currentOutputVoltage.load(); }
+    void outputVoltage(float volts) { getChannel(0).outputVoltage(volts); }
+    void outputPitch(int midiNote) { getChannel(0).outputPitch(static_cast<float>(midiNote)); }
+    void outputPitch(float midiPitchFloat) { getChannel(0).outputPitch(midiPitchFloat); }  // For microtonal
+    void outputFrequency(float hz) { getChannel(0).outputFrequency(hz); }
+    float getCurrentVoltage() const { return getChannel(0).getCurrentVoltage(); }
+
+    // Voltage ramps on channel 0
+    void startRamp(float startVolts, float endVolts, double legDurationSeconds, bool returnToStart)
+    {
+        getChannel(0).startRamp(startVolts, endVolts, legDurationSeconds, returnToStart);
+    }
+    void stopRamp() { getChannel(0).stopRamp(); }
+    bool isRampRunning() const { return getChannel(0).isRampRunning(); }
+    bool isRampFinished() const { return getChannel(0).isRampFinished(); }
+    int64 getRampStartPosition() const { return getChannel(0).getRampStartPosition(); }
+    int64 getRampLengthInSamples() const { return getChannel(0).getRampLengthInSamples(); }
+    float getRampVoltageAt(double samplePosition) const { return getChannel(0).getRampVoltageAt(samplePosition); }
 
-    // Audio callback - called from audio thread
-    void fillOutputBuffer(float* buffer, int numSamples);
+    // Output sample clock, counts every sample rendered by fillOutputBuffers
+    int64 getOutputSamplePosition() const { return outputSamplePosition.load(); }
+    void setSampleRate(double newSampleRate) { sampleRate = newSampleRate; }
+    double getSampleRate() const { return sampleRate; }
 
-    // Interface calibration
-    void setInterfaceCalibration(const InterfaceCalibration& cal);
-    const InterfaceCalibration& getInterfaceCalibration() const { return interfaceCalibration; }
-    void clearInterfaceCalibration();
+    // Audio callback - called from audio thread. Renders every active channel
+    // into its device output in one pass and clears all other outputs.
+    void fillOutputBuffers(float* const* outputs, int numOutputs, int numSamples);
 
-    // Calibration helpers
-    void addCalibrationPoint(float idealVoltage, float actualVoltage);
-    void computeCalibrationFromPoints();
+    // Interface calibration (channel 0)
+    void setInterfaceCalibration(const InterfaceCalibration& cal) { getChannel(0).setInterfaceCalibration(cal); }
+    const InterfaceCalibration& getInterfaceCalibration() const { return getChannel(0).getInterfaceCalibration(); }
+    void clearInterfaceCalibration() { getChannel(0).clearInterfaceCalibration(); }
+
+    // Calibration helpers (channel 0)
+    void addCalibrationPoint(float idealVoltage, float actualVoltage) { getChannel(0).addCalibrationPoint(idealVoltage, actualVoltage); }
+    void computeCalibrationFromPoints() { getChannel(0).computeCalibrationFromPoints(); }
 
     // Persistence
-    void saveCalibration(const File& file) const;
-    bool loadCalibration(const File& file);
+    void saveCalibration(const File& file, int channel = 0) const;
+    bool loadCalibration(const File& file, int channel = 0);
 
-    // Conversion utilities (public for testing/display)
-    float midiToVoltage(int midiNote) const;
-    float midiToVoltage(float midiPitch) const;
-    float frequencyToVoltage(float hz) const;
-    float voltageToMidi(float voltage) const;
+    // Conversion utilities (public for testing/display), channel 0 standard
+    float midiToVoltage(int midiNote) const { return getChannel(0).midiToVoltage(static_cast<float>(midiNote)); }
+    float midiToVoltage(float midiPitch) const { return getChannel(0).midiToVoltage(midiPitch); }
+    float frequencyToVoltage(float hz) const { return getChannel(0).frequencyToVoltage(hz); }
+    float voltageToMidi(float voltage) const { return getChannel(0).voltageToMidi(voltage); }
 
-private:
+    // Maps between volts and normalised samples using the interface range
     float voltageToSample(float volts) const;
     float sampleToVoltage(float sample) const;
-    float applyInterfaceCalibration(float voltage) const;
 
-    std::atomic<float> currentOutputVoltage{0.0f};
-    std::atomic<bool> isActiveFlag{false};
+private:
+    std::vector<std::unique_ptr<Channel>> channels;
+
+    std::atomic<int64> outputSamplePosition{0};
+    double sampleRate = 48000.0;
 
-    VoltageStandard currentStandard = VoltageStandard::OneVoltPerOctave;
     InterfaceType interfaceType = InterfaceType::ExpertSleepers;
 
     float interfaceMinVolts = -10.0f;
     float interfaceMaxVolts = +10.0f;
     float hzPerVoltScaling = 1000.0f;  // Default: 1V = 1kHz for Hz/V mode
 
-    int outputChannel = 0;
-
-    InterfaceCalibration interfaceCalibration;
-
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CVOutputManager)
 };
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    InterfaceCorrectionLUT.cpp
+    Non-linear DAC correction compiled into a lookup table
+
+  ==============================================================================
+*/
+
+#include "InterfaceCorrectionLUT.h"
+#include <algorithm>
+#include <cmath>
+
+InterfaceCorrectionLUT::InterfaceCorrectionLUT(const std::vector<std::pair<float, float>>& points,
+                                               float g, float o, int tableSize)
+    : gain(g), offset(o)
+{
+    if (points.size() >= 3 && tableSize >= 2)
+        buildTable(points, tableSize);
+}
+
+InterfaceCorrectionLUT::~InterfaceCorrectionLUT()
+{
+}
+
+void InterfaceCorrectionLUT::buildTable(std::vector<std::pair<float, float>> points, int tableSize)
+{
+    // Invert the measurement: x = actual output, y = voltage that was requested
+    std::vector<double> x, y;
+    std::sort(points.begin(), points.end(),
+              [](const auto& a, const auto& b) { return a.second < b.second; });
+
+    for (const auto& p : points)
+    {
+        if (!x.empty() && p.second - x.back() < 1.0e-6)
+            continue;  // duplicate measurement of the same output voltage
+
+        x.push_back(p.second);
+        y.push_back(p.first);
+    }
+
+    const size_t n = x.size();
+    if (n < 3)
+        return;
+
+    // A DAC is monotonic - if the data says otherwise it's measurement noise
+    // and a spline through it would only make things worse
+    std::vector<double> slopes(n - 1);
+    for (size_t i = 0; i < n - 1; ++i)
+    {
+        slopes[i] = (y[i + 1] - y[i]) / (x[i + 1] - x[i]);
+        if (slopes[i] <= 0.0)
+            return;
+    }
+
+    // Fritsch-Carlson tangents
+    std::vector<double> tangents(n);
+    tangents[0] = slopes[0];
+    tangents[n - 1] = slopes[n - 2];
+    for (size_t i = 1; i < n - 1; ++i)
+        tangents[i] = (slopes[i - 1] + slopes[i]) * 0.5;
+
+    for (size_t i = 0; i < n - 1; ++i)
+    {
+        const double a = tangents[i] / slopes[i];
+        const double b = tangents[i + 1] / slopes[i];
+        const double h = a * a + b * b;
+
+        if (h > 9.0)
+        {
+            const double t = 3.0 / std::sqrt(h);
+            tangents[i] = t * a * slopes[i];
+            tangents[i + 1] = t * b * slopes[i];
+        }
+    }
+
+    tableStart = static_cast<float>(x.front());
+    tableEnd = static_cast<float>(x.back());
+    tableScale = static_cast<float>(tableSize - 1) / (tableEnd - tableStart);
+    table.resize(static_cast<size_t>(tableSize));
+
+    size_t segment = 0;
+    for (int i = 0; i < tableSize; ++i)
+    {
+        const double v = x.front() + (x.back() - x.front()) * i / (tableSize - 1);
+
+        while (segment < n - 2 && v > x[segment + 1])
+            ++segment;
+
+        // Cubic Hermite interpolation on the current segment
+        const double h = x[segment + 1] - x[segment];
+        const double t = (v - x[segment]) / h;
+        const double t2 = t * t;
+        const double t3 = t2 * t;
+
+        table[static_cast<size_t>(i)] = static_cast<float>(
+              (2.0 * t3 - 3.0 * t2 + 1.0) * y[segment]
+            + (t3 - 2.0 * t2 + t) * h * tangents[segment]
+            + (-2.0 * t3 + 3.0 * t2) * y[segment + 1]
+            + (t3 - t2) * h * tangents[segment + 1]);
+    }
+}
@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    InterfaceCorrectionLUT.h
+    Non-linear DAC correction compiled into a lookup table
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include <utility>
+
+// Corrects the transfer curve of a DC-coupled interface output. The measured
+// ideal -> actual pairs are inverted with a monotone cubic (Fritsch-Carlson)
+// spline and sampled into a uniform table, so the audio thread only needs one
+// linear interpolation per sample. Outside the measured span the correction
+// continues with the linear gain from the regression fit.
+class InterfaceCorrectionLUT
+{
+public:
+    static const int defaultTableSize = 2048;
+
+    // gain/offset are the linear inverse correction used outside the table
+    // (and everywhere if the points don't allow a table to be built)
+    InterfaceCorrectionLUT(const std::vector<std::pair<float, float>>& points,
+                           float gain, float offset,
+                           int tableSize = defaultTableSize);
+    ~InterfaceCorrectionLUT();
+
+    // True if enough monotonic points were available to build the table
+    bool hasTable() const { return !table.empty(); }
+
+    // Returns the voltage to request so that the interface outputs 'volts'
+    float process(float volts) const noexcept
+    {
+        if (table.empty())
+            return gain * volts + offset;
+
+        if (volts <= tableStart)
+            return table.front() + gain * (volts - tableStart);
+
+        if (volts >= tableEnd)
+            return table.back() + gain * (volts - tableEnd);
+
+        const float position = (volts - tableStart) * tableScale;
+        const int index = jmin(static_cast<int>(position), static_cast<int>(table.size()) - 2);
+        const float fraction = position - static_cast<float>(index);
+
+        return table[static_cast<size_t>(index)]
+             + fraction * (table[static_cast<size_t>(index) + 1] - table[static_cast<size_t>(index)]);
+    }
+
+private:
+    void buildTable(std::vector<std::pair<float, float>> points, int tableSize);
+
+    float gain = 1.0f;
+    float offset = 0.0f;
+
+    float tableStart = 0.0f;
+    float tableEnd = 0.0f;
+    float tableScale = 0.0f;
+    std::vector<float> table;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(InterfaceCorrectionLUT)
+};
@@ -0,0 +1,212 @@
+/*
+  ==============================================================================
+
+    LoopbackCalibrator.cpp
+    Automated interface calibration via output -> input loopback
+
+  ==============================================================================
+*/
+
+#include "LoopbackCalibrator.h"
+
+LoopbackCalibrator::LoopbackCalibrator(AudioDeviceManager& dm, CVOutputManager& cv)
+    : deviceManager(dm), cvOutput(cv)
+{
+}
+
+LoopbackCalibrator::~LoopbackCalibrator()
+{
+    cancel();
+}
+
+bool LoopbackCalibrator::start(const Settings& newSettings)
+{
+    if (running)
+        return false;
+
+    if (!isPositiveAndBelow(newSettings.cvChannel, cvOutput.getNumChannels())
+        || newSettings.numSteps < 2
+        || newSettings.maxVolts <= newSettings.minVolts)
+        return false;
+
+    settings = newSettings;
+    results.clear();
+    currentStep = 0;
+    running = true;
+
+    // Measure the raw interface - any existing correction would be fitted on top of itself
+    auto& channel = cvOutput.getChannel(settings.cvChannel);
+    previousCalibration = channel.getInterfaceCalibration();
+    previousActive = channel.isActive();
+    channel.clearInterfaceCalibration();
+    channel.setActive(true);
+
+    captureState.store(CaptureState::Idle);
+    deviceManager.addAudioCallback(this);
+
+    beginStep();
+    startTimer(20);
+    return true;
+}
+
+void LoopbackCalibrator::cancel()
+{
+    if (!running)
+        return;
+
+    stopTimer();
+    deviceManager.removeAudioCallback(this);
+    restoreChannel();
+    running = false;
+}
+
+void LoopbackCalibrator::restoreChannel()
+{
+    auto& channel = cvOutput.getChannel(settings.cvChannel);
+    channel.setInterfaceCalibration(previousCalibration);
+    channel.setActive(previousActive);
+}
+
+void LoopbackCalibrator::beginStep()
+{
+    const float fraction = static_cast<float>(currentStep) / static_cast<float>(settings.numSteps - 1);
+    const float voltage = settings.minVolts + fraction * (settings.maxVolts - settings.minVolts);
+
+    StepResult result;
+    result.idealVoltage = voltage;
+    results.push_back(result);
+
+    cvOutput.getChannel(settings.cvChannel).outputVoltage(voltage);
+
+    // Sample counts are resolved once the audio thread has reported its rate
+    const double rate = jmax(1.0, sampleRate.load());
+    settleSamples = static_cast<int64>(settings.settleTimeMs * 0.001 * rate);
+    captureSamples = jmax((int64) 1, static_cast<int64>(settings.measureTimeMs * 0.001 * rate));
+    stepStartTime = Time::getMillisecondCounter();
+
+    captureState.store(CaptureState::Settling);
+    listeners.call(&Listener::loopbackProgress, currentStep, settings.numSteps);
+}
+
+void LoopbackCalibrator::timerCallback()
+{
+    if (captureState.load() != CaptureState::Done)
+    {
+        // The audio device isn't running (or the input channel doesn't exist)
+        const uint32 timeout = static_cast<uint32>(settings.settleTimeMs + settings.measureTimeMs + 2000);
+        if (Time::getMillisecondCounter() - stepStartTime > timeout)
+            fail("Loopback failed - no audio input received");
+        return;
+    }
+
+    auto& result = results.back();
+    result.measuredVoltage = static_cast<float>(cvOutput.sampleToVoltage(static_cast<float>(statistics.getMean())));
+    result.stdDevVolts = static_cast<float>(statistics.getStandardDeviation()
+                                            * (cvOutput.sampleToVoltage(1.0f) - cvOutput.sampleToVoltage(0.0f)));
+    result.numSamples = statistics.getCount();
+
+    if (++currentStep < settings.numSteps)
+    {
+        beginStep();
+        return;
+    }
+
+    finish();
+}
+
+void LoopbackCalibrator::finish()
+{
+    stopTimer();
+    deviceManager.removeAudioCallback(this);
+
+    // A missing patch cable reads as a flat line around 0V
+    const float idealSpan = results.back().idealVoltage - results.front().idealVoltage;
+    const float measuredSpan = results.back().measuredVoltage - results.front().measuredVoltage;
+    if (measuredSpan < 0.5f * idealSpan || measuredSpan > 2.0f * idealSpan)
+    {
+        restoreChannel();
+        running = false;
+        listeners.call(&Listener::loopbackFailed,
+                       String("Loopback failed - input does not follow the output. Check the patch cable."));
+        return;
+    }
+
+    auto& channel = cvOutput.getChannel(settings.cvChannel);
+    channel.clearInterfaceCalibration();
+    for (const auto& result : results)
+        channel.addCalibrationPoint(result.idealVoltage, result.measuredVoltage);
+    channel.computeCalibrationFromPoints();
+
+    auto calibration = channel.getInterfaceCalibration();
+    if (auto* device = deviceManager.getCurrentAudioDevice())
+        calibration.interfaceName = device->getName();
+    channel.setInterfaceCalibration(calibration);
+    channel.setActive(previousActive);
+
+    running = false;
+    listeners.call(&Listener::loopbackFinished, calibration);
+}
+
+void LoopbackCalibrator::fail(const String& error)
+{
+    cancel();
+    listeners.call(&Listener::loopbackFailed, error);
+}
+
+void LoopbackCalibrator::audioDeviceIOCallback(const float** inputChannelData, int numInputChannels,
+                                               float** outputChannelData, int numOutputChannels,
+                                               int numSamples)
+{
+    // The CV itself is rendered by VCOTuner's callback, this one only listens
+    for (int ch = 0; ch < numOutputChannels; ++ch)
+    {
+        if (outputChannelData[ch] != nullptr)
+            std::fill(outputChannelData[ch], outputChannelData[ch] + numSamples, 0.0f);
+    }
+
+    CaptureState state = captureState.load();
+    if (state == CaptureState::Idle || state == CaptureState::Done)
+        return;
+
+    if (!isPositiveAndBelow(settings.inputChannel, numInputChannels)
+        || inputChannelData[settings.inputChannel] == nullptr)
+        return;
+
+    const float* input = inputChannelData[settings.inputChannel];
+    int i = 0;
+
+    if (state == CaptureState::Settling)
+    {
+        if (samplesSeen == 0)
+            statistics.reset();
+
+        const int64 remaining = settleSamples - samplesSeen;
+        if (remaining >= numSamples)
+        {
+            samplesSeen += numSamples;
+            return;
+        }
+
+        i = static_cast<int>(jmax((int64) 0, remaining));
+        samplesSeen = 0;
+        captureState.store(CaptureState::Capturing);
+    }
+
+    for (; i < numSamples && samplesSeen < captureSamples; ++i, ++samplesSeen)
+        statistics.add(input[i]);
+
+    if (samplesSeen >= captureSamples)
+    {
+        samplesSeen = 0;
+        captureState.store(CaptureState::Done);
+    }
+}
+
+void LoopbackCalibrator::audioDeviceAboutToStart(AudioIODevice* device)
+{
+    sampleRate.store(device->getCurrentSampleRate());
+}
+
+void LoopbackCalibrator::audioDeviceStopped()
+{
+}
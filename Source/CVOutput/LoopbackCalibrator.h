@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    LoopbackCalibrator.h
+    Automated interface calibration via output -> input loopback
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CVOutputManager.h"
+#include "../Measurement/RunningStatistics.h"
+#include <atomic>
+#include <vector>
+
+// Implements CVOutputManager::CalibrationMethod::Loopback. With a CV output
+// patched into a DC-coupled input, the calibrator steps the output across a
+// voltage range, averages the input reading at every step and fits the
+// channel's InterfaceCalibration from the result. The input is assumed to
+// share the nominal voltage range of the interface.
+class LoopbackCalibrator : public AudioIODeviceCallback,
+                           private Timer
+{
+public:
+    struct Settings
+    {
+        int cvChannel = 0;          // CVOutputManager channel to calibrate
+        int inputChannel = 0;       // Device input the output is patched into
+        float minVolts = -4.0f;
+        float maxVolts = 6.0f;
+        int numSteps = 21;
+        int settleTimeMs = 50;      // Wait after each step before averaging
+        int measureTimeMs = 100;    // Averaging time per step
+    };
+
+    struct StepResult
+    {
+        float idealVoltage = 0.0f;
+        float measuredVoltage = 0.0f;
+        float stdDevVolts = 0.0f;
+        int64 numSamples = 0;
+    };
+
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+        virtual void loopbackProgress(int step, int numSteps) = 0;
+        virtual void loopbackFinished(const CVOutputManager::InterfaceCalibration& calibration) = 0;
+        virtual void loopbackFailed(const String& error) = 0;
+    };
+
+    LoopbackCalibrator(AudioDeviceManager& deviceManager, CVOutputManager& cvOutput);
+    ~LoopbackCalibrator() override;
+
+    // Message thread
+    bool start(const Settings& settings);
+    void cancel();
+    bool isRunning() const { return running; }
+    const std::vector<StepResult>& getResults() const { return results; }
+
+    void addListener(Listener* l) { listeners.add(l); }
+    void removeListener(Listener* l) { listeners.remove(l); }
+
+    // AudioIODeviceCallback
+    void audioDeviceIOCallback(const float** inputChannelData, int numInputChannels,
+                               float** outputChannelData, int numOutputChannels,
+                               int numSamples) override;
+    void audioDeviceAboutToStart(AudioIODevice* device) override;
+    void audioDeviceStopped() override;
+
+private:
+    enum class CaptureState
+    {
+        Idle,
+        Settling,
+        Capturing,
+        Done
+    };
+
+    void timerCallback() override;
+    void beginStep();
+    void finish();
+    void fail(const String& error);
+    void restoreChannel();
+
+    AudioDeviceManager& deviceManager;
+    CVOutputManager& cvOutput;
+    ListenerList<Listener> listeners;
+
+    Settings settings;
+    std::vector<StepResult> results;
+    CVOutputManager::InterfaceCalibration previousCalibration;
+    bool previousActive = false;
+    bool running = false;
+    int currentStep = 0;
+    uint32 stepStartTime = 0;
+
+    // Written by the message thread before captureState is set to Settling,
+    // statistics are written by the audio thread before it is set to Done
+    int64 settleSamples = 0;
+    int64 captureSamples = 0;
+    std::atomic<CaptureState> captureState{CaptureState::Idle};
+    std::atomic<double> sampleRate{0.0};
+
+    // Audio thread
+    int64 samplesSeen = 0;
+    RunningStatistics statistics;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoopbackCalibrator)
+};
@@ -8,10 +8,14 @@
 */
 
 #include "CalibrationEngine.h"
+#include "CalibrationJournal.h"
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <set>
 
 CalibrationEngine::CalibrationEngine(VCOTuner* t, CVOutputManager* cv)
-    : tuner(t), cvOutput(cv)
+    : tuner(t), cvOutput(cv), journal(std::make_unique<CalibrationJournal>())
 {
     if (tuner != nullptr)
         tuner->addListener(this);
@@ -32,19 +36,120 @@ void CalibrationEngine::startCalibration(const CalibrationSettings& s)
         return;
     }
 
+    if (s.startNote > s.endNote)
+    {
+        setError("The start note is above the end note");
+        return;
+    }
+
     settings = s;
     calibrationData.clear();
-    frequencyAccumulator.clear();
-    currentNoteIndex = 0;
-    currentMeasurementCount = 0;
+    sweepPeriods.clear();
+    planInitialNotes();
+
+    if (shouldJournal())
+        journal->beginSession(settings);
+    openPointLog(CSVWriter::Mode::replace);
+
+    beginRun();
+}
+
+bool CalibrationEngine::hasResumableSession() const
+{
+    return journal->hasResumableSession();
+}
+
+bool CalibrationEngine::resumeFromJournal()
+{
+    if (tuner == nullptr || cvOutput == nullptr || isRunning())
+        return false;
+
+    CalibrationSettings journalSettings;
+    std::vector<CalibrationPoint> points;
+    if (!journal->load(journalSettings, points) || journalSettings.startNote > journalSettings.endNote)
+        return false;
+
+    settings = journalSettings;
+    calibrationData = points;
+    sweepPeriods.clear();
+
+    // Drop the notes that were already measured from the plan. Adaptive
+    // refinement picks up from the measured curve once the queue runs dry.
+    planInitialNotes();
+    pendingNotes.erase(std::remove_if(pendingNotes.begin(), pendingNotes.end(),
+                                      [this](int note)
+                                      {
+                                          return std::any_of(calibrationData.begin(), calibrationData.end(),
+                                                             [note](const CalibrationPoint& p) { return p.targetMidiNote == note; });
+                                      }),
+                       pendingNotes.end());
+
+    openPointLog(CSVWriter::Mode::append);
+    beginRun();
+    return true;
+}
 
+bool CalibrationEngine::shouldJournal() const
+{
+    return settings.mode == Mode::Stepped && !settings.useExternalCVSource;
+}
+
+void CalibrationEngine::openPointLog(CSVWriter::Mode mode)
+{
+    pointLog.close();
+    if (settings.pointLogFile == File() || !pointLog.open(settings.pointLogFile, mode))
+        return;
+
+    pointLog.writeComment("VCOTuner calibration points, run started " + Time::getCurrentTime().toISO8601(true));
+    if (!pointLog.isContinuingFile())
+        pointLog.writeHeader({ "MIDINote", "TargetVoltage", "MeasuredFrequency", "ErrorCents", "StdDevCents",
+                               "Repeats", "Rejected", "Retries", "Valid", "Time" });
+    pointLog.flush();
+}
+
+void CalibrationEngine::logPoint(const CalibrationPoint& point)
+{
+    if (!pointLog.isOpen())
+        return;
+
+    // flushed per point, so the log survives a crash like the journal does
+    pointLog.add(point.targetMidiNote)
+            .add(point.targetVoltage, 5)
+            .add(point.measuredFrequency, 4)
+            .add(point.errorCents, 3)
+            .add(point.stdDevCents, 3)
+            .add(static_cast<int>(point.repeats.size()))
+            .add(point.numRejected)
+            .add(point.numRetries)
+            .add(point.valid ? 1 : 0)
+            .add(Time::getCurrentTime().toISO8601(true))
+            .endRow();
+    pointLog.flush();
+}
+
+void CalibrationEngine::beginRun()
+{
     // Configure CV output
     cvOutput->setVoltageStandard(settings.standard);
     cvOutput->setActive(true);
 
+    // Let every point measure just long enough for the requested precision
+    previousResolution = tuner->getResolution();
+    previousEarlyStopTarget = tuner->getEarlyStopTarget();
+    previousEarlyStopMaxPeriods = tuner->getEarlyStopMaxPeriods();
+    tuner->setEarlyStop(settings.targetPrecisionCents, settings.maxPeriodsPerMeasurement);
+    tunerSettingsChanged = true;
+
     state = State::Starting;
     listeners.call(&Listener::calibrationStarted);
-    listeners.call(&Listener::calibrationProgress, 0.0f, "Starting calibration...");
+
+    // A resumed run starts with the points from the journal
+    for (const auto& point : calibrationData)
+        listeners.call(&Listener::calibrationPointCompleted, point);
+
+    listeners.call(&Listener::calibrationProgress, getProgressPercent(),
+                   calibrationData.empty() ? String("Starting calibration...")
+                                           : "Resuming calibration at " + String(calibrationData.size()) + " points...");
 
     // Start the state machine timer (10ms intervals like VCOTuner)
     startTimer(10);
@@ -75,7 +180,10 @@ void CalibrationEngine::cancelCalibration()
 {
     stopTimer();
     state = State::Idle;
+    stopSweep();
+    restoreTunerSettings();
     cvOutput->setActive(false);
+    pointLog.close();
     listeners.call(&Listener::calibrationCancelled);
 }
 
@@ -86,6 +194,7 @@ void CalibrationEngine::triggerManualMeasurement(float knownVoltage)
 
     // In external CV source mode, user provides the voltage they set
     currentPoint.targetVoltage = knownVoltage;
+    currentPoint.repeats.clear();
     currentPoint.targetMidiNote = static_cast<int>(std::round(cvOutput->voltageToMidi(knownVoltage)));
 
     state = State::WaitingForMeasurement;
@@ -96,6 +205,10 @@ int CalibrationEngine::getTotalPoints() const
 {
     if (settings.noteStep <= 0)
         return 0;
+
+    if (settings.adaptive && settings.mode == Mode::Stepped)
+        return static_cast<int>(calibrationData.size() + pendingNotes.size()) + (isRunning() ? 1 : 0);
+
     return ((settings.endNote - settings.startNote) / settings.noteStep) + 1;
 }
 
@@ -108,14 +221,23 @@ float CalibrationEngine::getProgressPercent() const
 }
 
 CalibrationTable CalibrationEngine::generateCalibrationTable() const
+{
+    return buildCalibrationTable(calibrationData, cvOutput->getChannel(0));
+}
+
+CalibrationTable CalibrationEngine::buildCalibrationTable(const std::vector<CalibrationPoint>& points,
+                                                          const CVOutputManager::Channel& channel)
 {
     CalibrationTable table;
 
-    for (const auto& point : calibrationData)
+    for (const auto& point : points)
     {
+        if (!point.valid)
+            continue;
+
         CalibrationTable::Entry entry;
         entry.midiNote = point.targetMidiNote;
-        entry.idealVoltage = cvOutput->midiToVoltage(point.targetMidiNote);
+        entry.idealVoltage = channel.midiToVoltage(static_cast<float>(point.targetMidiNote));
         entry.actualVoltage = entry.idealVoltage + point.voltageCorrection;
         entry.correctionOffset = point.voltageCorrection;
         entry.measuredFrequency = point.measuredFrequency;
@@ -136,11 +258,26 @@ void CalibrationEngine::timerCallback()
     switch (state)
     {
         case State::Starting:
+            // A resumed run may have measured every planned note already
+            if (settings.mode == Mode::Stepped && pendingNotes.empty() && !calibrationData.empty())
+            {
+                advanceToNextPoint();
+                break;
+            }
+
             // Initialize first point
-            currentNoteIndex = 0;
             currentPoint = CalibrationPoint();
             currentPoint.targetMidiNote = settings.startNote;
-            currentPoint.targetVoltage = cvOutput->midiToVoltage(settings.startNote);
+            if (!pendingNotes.empty())
+            {
+                currentPoint.targetMidiNote = pendingNotes.front();
+                pendingNotes.erase(pendingNotes.begin());
+            }
+            currentPoint.targetVoltage = cvOutput->midiToVoltage(currentPoint.targetMidiNote);
+
+            // A sweep starts a semitone early so the first fit window is covered
+            if (settings.mode == Mode::ContinuousSweep)
+                currentPoint.targetVoltage = cvOutput->midiToVoltage(settings.startNote - 1.0f);
 
             outputCurrentVoltage();
             state = State::SettlingVoltage;
@@ -150,10 +287,17 @@ void CalibrationEngine::timerCallback()
         case State::SettlingVoltage:
             settleCounter++;
             // Wait for settle time (counter * 10ms)
-            if (settleCounter * 10 >= settings.settleTimeMs)
+            if (settleCounter * 10 >= getSettleTimeMs())
             {
-                state = State::WaitingForMeasurement;
-                startMeasurement();
+                if (settings.mode == Mode::ContinuousSweep)
+                {
+                    beginSweep();
+                }
+                else
+                {
+                    state = State::WaitingForMeasurement;
+                    startMeasurement();
+                }
             }
             break;
 
@@ -162,20 +306,13 @@ void CalibrationEngine::timerCallback()
             break;
 
         case State::ProcessingResult:
-            // Measurement complete, check if we need more measurements for averaging
-            currentMeasurementCount++;
-
-            if (currentMeasurementCount >= settings.measurementsPerNote)
+            // Measurement complete, check if we need more measurements for averaging.
+            // A rejected repeat is replaced by another one instead of redoing the note.
+            if (currentPoint.getNumAccepted() >= settings.measurementsPerNote
+                || currentPoint.numRejected > settings.maxRejectedRepeats)
             {
                 // Done with this note
-                calibrationData.push_back(currentPoint);
-                listeners.call(&Listener::calibrationPointCompleted, currentPoint);
-
-                String status = "Note " + String(currentPoint.targetMidiNote) +
-                               ": " + String(currentPoint.errorCents, 1) + " cents error";
-                listeners.call(&Listener::calibrationProgress, getProgressPercent(), status);
-
-                state = State::MovingToNext;
+                completeCurrentPoint();
             }
             else
             {
@@ -189,6 +326,10 @@ void CalibrationEngine::timerCallback()
             advanceToNextPoint();
             break;
 
+        case State::Sweeping:
+            processSweep();
+            break;
+
         case State::Completed:
         case State::Error:
         case State::Paused:
@@ -200,28 +341,106 @@ void CalibrationEngine::timerCallback()
 
 void CalibrationEngine::advanceToNextPoint()
 {
-    currentNoteIndex++;
-    int currentNote = settings.startNote + (currentNoteIndex * settings.noteStep);
-
-    if (currentNote > settings.endNote)
+    // The queue runs dry after every adaptive round, see whether the
+    // measured curve asks for another one
+    if (pendingNotes.empty() && !(settings.adaptive && planRefinementNotes()))
     {
         // Done!
         finishCalibration();
         return;
     }
 
+    int currentNote = pendingNotes.front();
+    pendingNotes.erase(pendingNotes.begin());
+
     // Setup next point
     currentPoint = CalibrationPoint();
     currentPoint.targetMidiNote = currentNote;
     currentPoint.targetVoltage = cvOutput->midiToVoltage(currentNote);
-    currentMeasurementCount = 0;
-    frequencyAccumulator.clear();
 
     outputCurrentVoltage();
     state = State::SettlingVoltage;
     settleCounter = 0;
 }
 
+void CalibrationEngine::planInitialNotes()
+{
+    pendingNotes.clear();
+
+    const int step = jmax(1, settings.noteStep);
+    const int coarse = settings.adaptive ? jmax(step, (settings.coarseStep / step) * step) : step;
+
+    for (int note = settings.startNote; note <= settings.endNote; note += coarse)
+        pendingNotes.push_back(note);
+
+    // Adaptive mode always needs both ends of the range
+    if (settings.adaptive && !pendingNotes.empty() && pendingNotes.back() != settings.endNote)
+        pendingNotes.push_back(settings.endNote);
+}
+
+bool CalibrationEngine::planRefinementNotes()
+{
+    // Invalid points carry no error to fit a curve through, but a skipped
+    // note would fail again, so no note is ever queued twice
+    std::vector<CalibrationPoint> measured;
+    std::set<int> triedNotes;
+    for (const auto& point : calibrationData)
+    {
+        triedNotes.insert(point.targetMidiNote);
+        if (point.valid)
+            measured.push_back(point);
+    }
+
+    std::sort(measured.begin(), measured.end(),
+              [](const CalibrationPoint& a, const CalibrationPoint& b) { return a.targetMidiNote < b.targetMidiNote; });
+
+    const int step = jmax(1, settings.noteStep);
+    const int n = static_cast<int>(measured.size());
+
+    // Second divided difference of the error curve through three points
+    auto curvature = [&measured](int i) -> double
+    {
+        const double x0 = measured[i - 1].targetMidiNote, x1 = measured[i].targetMidiNote, x2 = measured[i + 1].targetMidiNote;
+        const double y0 = measured[i - 1].errorCents, y1 = measured[i].errorCents, y2 = measured[i + 1].errorCents;
+        const double d01 = (y1 - y0) / (x1 - x0);
+        const double d12 = (y2 - y1) / (x2 - x1);
+        return 2.0 * (d12 - d01) / (x2 - x0);
+    };
+
+    for (int i = 0; i + 1 < n; ++i)
+    {
+        const int low = measured[i].targetMidiNote;
+        const int high = measured[i + 1].targetMidiNote;
+        if (high - low <= step)
+            continue;
+
+        // Linear interpolation across an interval of width h misses a curve
+        // with second derivative c by up to c * h^2 / 8 in the middle. Without
+        // three points there is nothing to estimate c from, so always refine.
+        double expectedError = std::numeric_limits<double>::max();
+        if (n >= 3)
+        {
+            double c = 0.0;
+            if (i > 0)
+                c = jmax(c, std::abs(curvature(i)));
+            if (i + 2 < n)
+                c = jmax(c, std::abs(curvature(i + 1)));
+
+            const double h = high - low;
+            expectedError = c * h * h / 8.0;
+        }
+
+        if (expectedError > settings.adaptiveToleranceCents)
+        {
+            const int middle = low + jmax(1, (high - low) / (2 * step)) * step;
+            if (middle < high && triedNotes.count(middle) == 0)
+                pendingNotes.push_back(middle);
+        }
+    }
+
+    return !pendingNotes.empty();
+}
+
 void CalibrationEngine::outputCurrentVoltage()
 {
     if (!settings.useExternalCVSource && cvOutput != nullptr)
@@ -234,11 +453,20 @@ void CalibrationEngine::startMeasurement()
 {
     if (tuner != nullptr)
     {
+        // Retries measure over more periods
+        tuner->setEarlyStop(settings.targetPrecisionCents,
+                            settings.maxPeriodsPerMeasurement << jmin(currentPoint.numRetries, 4));
+
         // Use single measurement mode
         tuner->startSingleMeasurement(currentPoint.targetMidiNote);
     }
 }
 
+int CalibrationEngine::getSettleTimeMs() const
+{
+    return settings.settleTimeMs << jmin(currentPoint.numRetries, 4);
+}
+
 void CalibrationEngine::newMeasurementReady(const VCOTuner::measurement_t& m)
 {
     if (state != State::WaitingForMeasurement)
@@ -248,33 +476,164 @@ void CalibrationEngine::newMeasurementReady(const VCOTuner::measurement_t& m)
     state = State::ProcessingResult;
 }
 
+void CalibrationEngine::tunerFinished()
+{
+    // A single measurement ends in the finished state, its result is only
+    // available through the getters
+    if (state != State::WaitingForMeasurement || tuner->getSingleMeasurementResult() <= 0.0)
+        return;
+
+    VCOTuner::measurement_t m;
+    m.timestamp = Time::getCurrentTime();
+    m.frequency = tuner->getSingleMeasurementResult();
+    m.midiPitch = currentPoint.targetMidiNote;
+    m.pitch = 69.0 + 12.0 * std::log2(m.frequency / 440.0);
+    m.pitchOffset = m.pitch - m.midiPitch;
+    m.freqDeviation = tuner->getSingleMeasurementDeviation();
+    m.pitchDeviation = 12.0 * std::log2(1.0 + m.freqDeviation / m.frequency);
+    m.numMeasurements = tuner->getSingleMeasurementNumPeriods();
+    m.referenceDrift = 0.0;
+
+    newMeasurementReady(m);
+}
+
 void CalibrationEngine::tunerStopped()
 {
-    // Tuner stopped unexpectedly - might be an error
+    // The tuner stops on dropouts, jitter and timeouts
     if (state == State::WaitingForMeasurement)
     {
-        setError("Measurement failed - no signal detected");
+        StringArray errors = tuner->getLastErrors();
+        handleMeasurementFailure(errors.size() > 0 ? errors[0] : String("Measurement failed - no signal detected"));
     }
 }
 
+void CalibrationEngine::handleMeasurementFailure(const String& reason)
+{
+    currentPoint.failureReason = reason;
+
+    if (currentPoint.numRetries < settings.maxRetries)
+    {
+        // Output the voltage again and give the VCO longer to settle
+        currentPoint.numRetries++;
+        listeners.call(&Listener::calibrationProgress, getProgressPercent(),
+                       "Note " + String(currentPoint.targetMidiNote) + ": measurement failed, retry "
+                           + String(currentPoint.numRetries) + " of " + String(settings.maxRetries));
+
+        outputCurrentVoltage();
+        state = State::SettlingVoltage;
+        settleCounter = 0;
+        return;
+    }
+
+    // Repeats that did succeed still make a usable point
+    if (currentPoint.getNumAccepted() > 0)
+    {
+        completeCurrentPoint();
+        return;
+    }
+
+    if (!settings.skipFailedPoints)
+    {
+        setError("Note " + String(currentPoint.targetMidiNote) + ": " + reason);
+        return;
+    }
+
+    currentPoint.valid = false;
+    completeCurrentPoint();
+}
+
+void CalibrationEngine::completeCurrentPoint()
+{
+    calibrationData.push_back(currentPoint);
+    if (shouldJournal())
+        journal->appendPoint(currentPoint);
+    logPoint(currentPoint);
+    listeners.call(&Listener::calibrationPointCompleted, currentPoint);
+
+    String status = "Note " + String(currentPoint.targetMidiNote) + ": ";
+    if (currentPoint.valid)
+        status << String(currentPoint.errorCents, 1) << " cents error";
+    else
+        status << "skipped after " << String(currentPoint.numRetries) << " retries";
+    listeners.call(&Listener::calibrationProgress, getProgressPercent(), status);
+
+    state = State::MovingToNext;
+}
+
 void CalibrationEngine::processCurrentMeasurement(const VCOTuner::measurement_t& m)
 {
-    frequencyAccumulator.push_back(static_cast<float>(m.frequency));
+    if (m.frequency <= 0.0)
+        return;
+
+    Repeat repeat;
+    repeat.pitchCents = static_cast<float>(100.0 * (69.0 + 12.0 * std::log2(m.frequency / 440.0)));
+    repeat.stdDevCents = static_cast<float>(m.pitchDeviation) * 100.0f;
+    repeat.numPeriods = m.numMeasurements;
+    currentPoint.repeats.push_back(repeat);
+
+    updatePointStatistics(currentPoint);
+}
+
+void CalibrationEngine::updatePointStatistics(CalibrationPoint& point) const
+{
+    auto& repeats = point.repeats;
+
+    // Median/MAD outlier rejection needs at least three repeats to tell which
+    // one is the odd one out. The threshold never drops below one cent, so
+    // repeats that agree almost perfectly don't reject each other.
+    point.numRejected = 0;
+    if (repeats.size() >= 3)
+    {
+        std::vector<float> values;
+        values.reserve(repeats.size());
+        for (const auto& r : repeats)
+            values.push_back(r.pitchCents);
+
+        auto median = [](std::vector<float>& v)
+        {
+            std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+            return v[v.size() / 2];
+        };
+
+        const float med = median(values);
+        for (auto& v : values)
+            v = std::abs(v - med);
+        const float mad = median(values);
+        const float threshold = jmax(1.0f, 3.0f * 1.4826f * mad);
+
+        for (auto& r : repeats)
+        {
+            r.rejected = std::abs(r.pitchCents - med) > threshold;
+            if (r.rejected)
+                point.numRejected++;
+        }
+    }
+
+    // Pool the accepted repeats as if all of their periods had been one measurement
+    RunningStatistics pooled;
+    for (const auto& r : repeats)
+        if (!r.rejected)
+            pooled.merge(RunningStatistics::fromSummary(jmax(1, r.numPeriods), r.pitchCents, r.stdDevCents));
 
-    // Calculate average frequency
-    float avgFreq = 0.0f;
-    for (float f : frequencyAccumulator)
-        avgFreq += f;
-    avgFreq /= frequencyAccumulator.size();
+    if (pooled.getCount() == 0)
+        return;
+
+    const double pitch = pooled.getMean() / 100.0;
+    evaluatePoint(point, static_cast<float>(440.0 * std::pow(2.0, (pitch - 69.0) / 12.0)), settings.standard);
+    point.stdDevCents = static_cast<float>(pooled.getStandardDeviation());
+}
 
+void CalibrationEngine::evaluatePoint(CalibrationPoint& point, float frequency,
+                                      CVOutputManager::VoltageStandard standard)
+{
     // Calculate ideal frequency for this MIDI note
-    float idealFreq = 440.0f * std::pow(2.0f, (currentPoint.targetMidiNote - 69) / 12.0f);
+    float idealFreq = 440.0f * std::pow(2.0f, (point.targetMidiNote - 69) / 12.0f);
 
     // Calculate measured pitch (in MIDI note numbers)
-    float measuredPitch = 69.0f + 12.0f * std::log2(avgFreq / 440.0f);
+    float measuredPitch = 69.0f + 12.0f * std::log2(frequency / 440.0f);
 
     // Calculate pitch error in semitones
-    float pitchError = measuredPitch - currentPoint.targetMidiNote;
+    float pitchError = measuredPitch - point.targetMidiNote;
 
     // Convert to cents
     float errorCents = pitchError * 100.0f;
@@ -282,7 +641,7 @@ void CalibrationEngine::processCurrentMeasurement(const VCOTuner::measurement_t&
     // Calculate voltage correction needed
     // For 1V/Oct: if we're sharp, we need less voltage
     float voltageCorrection = 0.0f;
-    if (settings.standard == CVOutputManager::VoltageStandard::OneVoltPerOctave)
+    if (standard == CVOutputManager::VoltageStandard::OneVoltPerOctave)
     {
         voltageCorrection = -pitchError / 12.0f;  // Convert semitones to volts
     }
@@ -290,26 +649,259 @@ void CalibrationEngine::processCurrentMeasurement(const VCOTuner::measurement_t&
     {
         // Hz/V: more complex - would need to adjust based on frequency
         float targetVoltage = idealFreq / 1000.0f;  // Assuming 1V = 1kHz
-        float actualVoltage = avgFreq / 1000.0f;
+        float actualVoltage = frequency / 1000.0f;
         voltageCorrection = targetVoltage - actualVoltage;
     }
 
-    // Update current point
-    currentPoint.measuredFrequency = avgFreq;
-    currentPoint.measuredPitch = measuredPitch;
-    currentPoint.pitchError = pitchError;
-    currentPoint.errorCents = errorCents;
-    currentPoint.voltageCorrection = voltageCorrection;
-    currentPoint.stdDevCents = static_cast<float>(m.pitchDeviation) * 100.0f;
-    currentPoint.timestamp = Time::getCurrentTime();
+    // Update point
+    point.measuredFrequency = frequency;
+    point.measuredPitch = measuredPitch;
+    point.pitchError = pitchError;
+    point.errorCents = errorCents;
+    point.voltageCorrection = voltageCorrection;
+    point.timestamp = Time::getCurrentTime();
+}
+
+void CalibrationEngine::beginSweep()
+{
+    auto* tracker = tuner->getPeriodTracker(0);
+    if (tracker == nullptr)
+    {
+        setError("No input channel available for frequency tracking");
+        return;
+    }
+
+    // Ramp from a semitone below the first note to a semitone above the
+    // last one and back, so every fit window is crossed in both directions.
+    // Averaging both directions cancels the lag of the VCO and the interface.
+    float startVolts = cvOutput->midiToVoltage(settings.startNote - 1.0f);
+    float endVolts = cvOutput->midiToVoltage(settings.endNote + 1.0f);
+
+    sweepPeriods.clear();
+    sweepPeriods.reserve(static_cast<size_t>(settings.sweepTimeSeconds * 20000.0f));
+    sweepTailCounter = 0;
+    settleCounter = 0;
+
+    tracker->start();
+    cvOutput->startRamp(startVolts, endVolts, settings.sweepTimeSeconds * 0.5, true);
+
+    state = State::Sweeping;
+    listeners.call(&Listener::calibrationProgress, 0.0f, "Sweeping...");
+}
+
+void CalibrationEngine::processSweep()
+{
+    auto* tracker = tuner->getPeriodTracker(0);
+    tracker->readPeriods(sweepPeriods);
+
+    if (!cvOutput->isRampFinished())
+    {
+        const int64 rampStart = cvOutput->getRampStartPosition();
+        if (rampStart >= 0 && ++settleCounter % 25 == 0)
+        {
+            float elapsed = static_cast<float>(cvOutput->getOutputSamplePosition() - rampStart);
+            float percent = jlimit(0.0f, 100.0f, elapsed / cvOutput->getRampLengthInSamples() * 100.0f);
+            listeners.call(&Listener::calibrationProgress, percent,
+                           "Sweeping... " + String(sweepPeriods.size()) + " periods");
+        }
+        return;
+    }
+
+    // Keep listening for the settle time after the ramp ended, the last
+    // periods still have to travel through the interface and the VCO
+    sweepTailCounter++;
+    if (sweepTailCounter * 10 < settings.settleTimeMs)
+        return;
+
+    tracker->stop();
+    tracker->readPeriods(sweepPeriods);
+
+    if (sweepPeriods.empty())
+    {
+        setError("Sweep failed - no signal detected");
+        return;
+    }
+
+    listeners.call(&Listener::calibrationProgress, 100.0f, "Fitting sweep data...");
+    fitSweepData();
+    finishCalibration();
+}
+
+void CalibrationEngine::fitSweepData()
+{
+    const double sampleRate = tuner->getCurrentSampleRate();
+    const double rampStart = static_cast<double>(cvOutput->getRampStartPosition());
+    const double legSamples = cvOutput->getRampLengthInSamples() * 0.5;
+    const double latency = tuner->getDeviceLatencyInSamples();
+
+    std::vector<SweepSample> upLeg, downLeg;
+    upLeg.reserve(sweepPeriods.size());
+    downLeg.reserve(sweepPeriods.size());
+
+    for (const auto& period : sweepPeriods)
+    {
+        if (period.length <= 0.0)
+            continue;
+
+        // The frequency belongs to the centre of the period, and the input
+        // reflects the CV that was output one round trip earlier
+        double position = period.position - period.length * 0.5 - latency;
+        double t = position - rampStart;
+        if (t < 0.0 || t > 2.0 * legSamples)
+            continue;
+
+        float frequency = static_cast<float>(sampleRate / period.length);
+        SweepSample sample { cvOutput->getRampVoltageAt(position),
+                             69.0f + 12.0f * std::log2(frequency / 440.0f) };
+
+        if (t < legSamples)
+            upLeg.push_back(sample);
+        else
+            downLeg.push_back(sample);
+    }
+
+    auto byVoltage = [](const SweepSample& a, const SweepSample& b) { return a.voltage < b.voltage; };
+    std::sort(upLeg.begin(), upLeg.end(), byVoltage);
+    std::sort(downLeg.begin(), downLeg.end(), byVoltage);
+
+    for (int note = settings.startNote; note <= settings.endNote; note += jmax(1, settings.noteStep))
+    {
+        CalibrationPoint point;
+        point.targetMidiNote = note;
+        point.targetVoltage = cvOutput->midiToVoltage(note);
+
+        float lowVolts = cvOutput->midiToVoltage(note - 0.5f);
+        float highVolts = cvOutput->midiToVoltage(note + 0.5f);
+
+        float pitchSum = 0.0f;
+        float residual = 0.0f;
+        int numLegs = 0;
+
+        for (const auto* leg : { &upLeg, &downLeg })
+        {
+            float legPitch, legResidual;
+            if (fitPitchAtVoltage(*leg, lowVolts, highVolts, point.targetVoltage, legPitch, legResidual))
+            {
+                pitchSum += legPitch;
+                residual = jmax(residual, legResidual);
+                numLegs++;
+            }
+        }
+
+        // Not enough clean periods around this note, leave it to interpolation
+        if (numLegs == 0)
+            continue;
+
+        float pitch = pitchSum / numLegs;
+        evaluatePoint(point, 440.0f * std::pow(2.0f, (pitch - 69.0f) / 12.0f), settings.standard);
+        point.stdDevCents = residual;
+
+        calibrationData.push_back(point);
+        listeners.call(&Listener::calibrationPointCompleted, point);
+    }
+}
+
+bool CalibrationEngine::fitPitchAtVoltage(const std::vector<SweepSample>& leg, float lowVolts, float highVolts,
+                                          float targetVolts, float& pitch, float& residualCents) const
+{
+    const int minPeriods = 8;
+
+    auto first = std::lower_bound(leg.begin(), leg.end(), lowVolts,
+                                  [](const SweepSample& s, float v) { return s.voltage < v; });
+    auto last = std::upper_bound(first, leg.end(), highVolts,
+                                 [](float v, const SweepSample& s) { return v < s.voltage; });
+
+    if (std::distance(first, last) < minPeriods)
+        return false;
+
+    // Reject glitches (missed or double zero crossings) against the window median
+    std::vector<float> pitches;
+    pitches.reserve(static_cast<size_t>(std::distance(first, last)));
+    for (auto it = first; it != last; ++it)
+        pitches.push_back(it->pitch);
+    std::nth_element(pitches.begin(), pitches.begin() + pitches.size() / 2, pitches.end());
+    const float median = pitches[pitches.size() / 2];
+
+    // Least-squares line pitch = a + b * (v - target), a is the pitch at the target
+    double n = 0, sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+    for (auto it = first; it != last; ++it)
+    {
+        if (std::abs(it->pitch - median) > 0.5f)
+            continue;
+
+        double x = it->voltage - targetVolts;
+        double y = it->pitch - median;
+        n += 1;
+        sumX += x;
+        sumY += y;
+        sumXX += x * x;
+        sumXY += x * y;
+    }
+
+    if (n < minPeriods)
+        return false;
+
+    double denominator = n * sumXX - sumX * sumX;
+    double slope = (std::abs(denominator) > 1e-12) ? (n * sumXY - sumX * sumY) / denominator : 0.0;
+    double intercept = (sumY - slope * sumX) / n;
+
+    double sumSquares = 0;
+    for (auto it = first; it != last; ++it)
+    {
+        if (std::abs(it->pitch - median) > 0.5f)
+            continue;
+
+        double r = (it->pitch - median) - (intercept + slope * (it->voltage - targetVolts));
+        sumSquares += r * r;
+    }
+
+    pitch = median + static_cast<float>(intercept);
+    residualCents = static_cast<float>(std::sqrt(sumSquares / n) * 100.0);
+    return true;
+}
+
+void CalibrationEngine::stopSweep()
+{
+    if (tuner != nullptr)
+        if (auto* tracker = tuner->getPeriodTracker(0))
+            tracker->stop();
+
+    if (cvOutput != nullptr)
+        cvOutput->stopRamp();
+}
+
+void CalibrationEngine::restoreTunerSettings()
+{
+    if (!tunerSettingsChanged || tuner == nullptr)
+        return;
+
+    tuner->setResolution(previousResolution);
+    if (previousEarlyStopTarget > 0.0)
+        tuner->setEarlyStop(previousEarlyStopTarget, previousEarlyStopMaxPeriods);
+    tunerSettingsChanged = false;
 }
 
 void CalibrationEngine::finishCalibration()
 {
+    if (std::none_of(calibrationData.begin(), calibrationData.end(),
+                     [](const CalibrationPoint& p) { return p.valid; }))
+    {
+        setError("Calibration failed - no point could be measured");
+        return;
+    }
+
     stopTimer();
+    stopSweep();
+    restoreTunerSettings();
     cvOutput->setActive(false);
     state = State::Completed;
 
+    // Cancelled and failed runs keep their journal, a completed one has no use for it.
+    // Runs that don't journal leave the journal of an interrupted stepped run alone.
+    if (shouldJournal())
+        journal->discard();
+    pointLog.close();
+
     CalibrationTable table = generateCalibrationTable();
     listeners.call(&Listener::calibrationCompleted, table);
 }
@@ -317,7 +909,11 @@ void CalibrationEngine::finishCalibration()
 void CalibrationEngine::setError(const String& error)
 {
     stopTimer();
-    cvOutput->setActive(false);
+    stopSweep();
+    restoreTunerSettings();
+    if (cvOutput != nullptr)
+        cvOutput->setActive(false);
     state = State::Error;
+    pointLog.close();
     listeners.call(&Listener::calibrationError, error);
 }
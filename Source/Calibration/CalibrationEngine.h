@@ -13,20 +13,61 @@
 #include "CalibrationTable.h"
 #include "../CVOutput/CVOutputManager.h"
 #include "../VCOTuner.h"
+#include "../Measurement/RunningStatistics.h"
+#include "../Export/CSVWriter.h"
+
+class CalibrationJournal;
 
 class CalibrationEngine : public VCOTuner::Listener,
                           private Timer
 {
 public:
+    enum class Mode
+    {
+        Stepped,            // Settle and measure note by note
+        ContinuousSweep     // Slow CV ramp up and down, fit over per-period data
+    };
+
     struct CalibrationSettings
     {
+        Mode mode = Mode::Stepped;
         int startNote = 24;           // C1
         int endNote = 96;             // C7
         int noteStep = 1;             // Every semitone
         int settleTimeMs = 200;       // Time for VCO to stabilize after CV change
         int measurementsPerNote = 1;  // Number of measurements to average
+        int maxRejectedRepeats = 2;   // Extra repeats allowed to replace outliers
+        float targetPrecisionCents = 0.1f;  // Stepped mode: stop once the standard error is below this
+        int maxPeriodsPerMeasurement = 400; // ...or after this many periods
+
+        // A failed measurement (no signal, jitter, timeout) is retried with
+        // twice the settle time and period limit each time. After that the
+        // point is marked invalid and skipped, or the run stops with an error.
+        int maxRetries = 2;
+        bool skipFailedPoints = true;
         CVOutputManager::VoltageStandard standard = CVOutputManager::VoltageStandard::OneVoltPerOctave;
         bool useExternalCVSource = false;  // Use o_C or other external CV instead
+        float sweepTimeSeconds = 16.0f;    // Continuous mode: up and down ramp together
+
+        // Stepped mode: measure every coarseStep notes first, then bisect
+        // (down to noteStep) only where the error curve bends by more than
+        // the tolerance between two measured points
+        bool adaptive = false;
+        int coarseStep = 12;
+        float adaptiveToleranceCents = 0.5f;
+
+        // Every completed point is written here as a CSV row while the run
+        // goes on, a resumed run appends to it. Empty for no log.
+        File pointLogFile;
+    };
+
+    // One measurement of a point, a point keeps all of its repeats
+    struct Repeat
+    {
+        float pitchCents = 0.0f;        // Measured pitch, MIDI note number * 100
+        float stdDevCents = 0.0f;       // Period to period spread within the measurement
+        int numPeriods = 0;
+        bool rejected = false;          // Outlier against the other repeats (median/MAD)
     };
 
     struct CalibrationPoint
@@ -38,8 +79,15 @@ public:
         float pitchError = 0.0f;        // Deviation from ideal in semitones
         float errorCents = 0.0f;        // Error in cents
         float voltageCorrection = 0.0f;
-        float stdDevCents = 0.0f;
+        float stdDevCents = 0.0f;       // Pooled over all accepted repeats
+        std::vector<Repeat> repeats;
+        int numRejected = 0;
+        int numRetries = 0;             // Failed measurements of this point
+        bool valid = true;              // False if the point gave up after its retries
+        String failureReason;
         Time timestamp;
+
+        int getNumAccepted() const { return static_cast<int>(repeats.size()) - numRejected; }
     };
 
     // Listener interface
@@ -64,6 +112,11 @@ public:
     void resumeCalibration();
     void cancelCalibration();
 
+    // Stepped calibrations write every completed point to a journal, so a
+    // run that was cancelled, failed or crashed can continue where it stopped
+    bool hasResumableSession() const;
+    bool resumeFromJournal();
+
     // For external CV source mode - user triggers each measurement
     void triggerManualMeasurement(float knownVoltage);
 
@@ -71,7 +124,7 @@ public:
     bool isRunning() const { return state != State::Idle && state != State::Completed && state != State::Error; }
     bool isPaused() const { return state == State::Paused; }
 
-    // Progress
+    // Progress. In adaptive mode the total grows as points are inserted.
     int getTotalPoints() const;
     int getCompletedPoints() const { return static_cast<int>(calibrationData.size()); }
     float getProgressPercent() const;
@@ -81,6 +134,11 @@ public:
     const std::vector<CalibrationPoint>& getCalibrationData() const { return calibrationData; }
     CalibrationTable generateCalibrationTable() const;
 
+    // Shared with MultiCalibrationEngine
+    static void evaluatePoint(CalibrationPoint& point, float frequency, CVOutputManager::VoltageStandard standard);
+    static CalibrationTable buildCalibrationTable(const std::vector<CalibrationPoint>& points,
+                                                  const CVOutputManager::Channel& channel);
+
     // Listener management
     void addListener(Listener* l) { listeners.add(l); }
     void removeListener(Listener* l) { listeners.remove(l); }
@@ -89,7 +147,7 @@ public:
     void newMeasurementReady(const VCOTuner::measurement_t& m) override;
     void tunerStarted() override {}
     void tunerStopped() override;
-    void tunerFinished() override {}
+    void tunerFinished() override;
     void tunerStatusChanged(String statusString) override {}
 
 private:
@@ -100,6 +158,7 @@ private:
         SettlingVoltage,
         WaitingForMeasurement,
         ProcessingResult,
+        Sweeping,
         MovingToNext,
         Paused,
         Completed,
@@ -108,11 +167,36 @@ private:
 
     void timerCallback() override;
     void advanceToNextPoint();
+    void planInitialNotes();
+    bool planRefinementNotes();
     void processCurrentMeasurement(const VCOTuner::measurement_t& m);
+    void updatePointStatistics(CalibrationPoint& point) const;
     void outputCurrentVoltage();
     void startMeasurement();
     void finishCalibration();
+    void handleMeasurementFailure(const String& reason);
+    void completeCurrentPoint();
+    int getSettleTimeMs() const;
+    void beginRun();
+    bool shouldJournal() const;
+    void openPointLog(CSVWriter::Mode mode);
+    void logPoint(const CalibrationPoint& point);
+
+    // Continuous sweep
+    struct SweepSample
+    {
+        float voltage;
+        float pitch;
+    };
+
+    void beginSweep();
+    void processSweep();
+    void stopSweep();
+    void fitSweepData();
+    bool fitPitchAtVoltage(const std::vector<SweepSample>& leg, float lowVolts, float highVolts,
+                           float targetVolts, float& pitch, float& residualCents) const;
     void setError(const String& error);
+    void restoreTunerSettings();
 
     VCOTuner* tuner;
     CVOutputManager* cvOutput;
@@ -121,16 +205,24 @@ private:
     State state = State::Idle;
     CalibrationSettings settings;
 
-    int currentNoteIndex = 0;
-    int currentMeasurementCount = 0;
+    std::vector<int> pendingNotes;      // Stepped mode queue, measured front to back
     CalibrationPoint currentPoint;
     std::vector<CalibrationPoint> calibrationData;
+    std::unique_ptr<CalibrationJournal> journal;
+    CSVWriter pointLog;
 
-    // For averaging multiple measurements
-    std::vector<float> frequencyAccumulator;
+    // Continuous sweep data, positions on the CV output clock
+    std::vector<PeriodTracker::Period> sweepPeriods;
+    int sweepTailCounter = 0;
 
     // Timing
     int settleCounter = 0;
 
+    // Tuner measurement settings in place before the calibration started
+    int previousResolution = 0;
+    double previousEarlyStopTarget = 0.0;
+    int previousEarlyStopMaxPeriods = 0;
+    bool tunerSettingsChanged = false;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CalibrationEngine)
 };
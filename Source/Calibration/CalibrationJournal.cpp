@@ -0,0 +1,267 @@
+/*
+  ==============================================================================
+
+    CalibrationJournal.cpp
+    Append-only checkpoint file for resuming interrupted calibrations
+
+  ==============================================================================
+*/
+
+#include "CalibrationJournal.h"
+
+namespace
+{
+    const int journalVersion = 1;
+}
+
+CalibrationJournal::CalibrationJournal(const File& journalFile)
+    : file(journalFile)
+{
+}
+
+CalibrationJournal::~CalibrationJournal()
+{
+}
+
+File CalibrationJournal::getDefaultFile()
+{
+    return File::getSpecialLocation(File::userApplicationDataDirectory)
+        .getChildFile("VCOTuner")
+        .getChildFile("calibration-journal.jsonl");
+}
+
+bool CalibrationJournal::beginSession(const CalibrationEngine::CalibrationSettings& settings)
+{
+    stream.reset();
+    file.getParentDirectory().createDirectory();
+    file.deleteFile();
+
+    var header(new DynamicObject());
+    header.getDynamicObject()->setProperty("type", "session");
+    header.getDynamicObject()->setProperty("version", journalVersion);
+    header.getDynamicObject()->setProperty("started", Time::getCurrentTime().toISO8601(true));
+    header.getDynamicObject()->setProperty("settings", settingsToVar(settings));
+
+    return writeLine(header);
+}
+
+bool CalibrationJournal::appendPoint(const CalibrationEngine::CalibrationPoint& point)
+{
+    var line = pointToVar(point);
+    line.getDynamicObject()->setProperty("type", "point");
+    return writeLine(line);
+}
+
+void CalibrationJournal::discard()
+{
+    stream.reset();
+    file.deleteFile();
+}
+
+bool CalibrationJournal::writeLine(const var& object)
+{
+    if (stream == nullptr)
+    {
+        // FileOutputStream appends to an existing file
+        stream = std::make_unique<FileOutputStream>(file);
+        if (stream->failedToOpen())
+        {
+            stream.reset();
+            return false;
+        }
+
+        // A crash may have left a partial line, which would swallow the next point
+        MemoryBlock contents;
+        if (stream->getPosition() > 0 && file.loadFileAsData(contents))
+        {
+            const auto* data = static_cast<const char*>(contents.getData());
+            int64 end = static_cast<int64>(contents.getSize());
+            while (end > 0 && data[end - 1] != '\n')
+                --end;
+
+            if (end < static_cast<int64>(contents.getSize())
+                && !(stream->setPosition(end) && stream->truncate().wasOk()))
+            {
+                stream.reset();
+                return false;
+            }
+        }
+    }
+
+    *stream << JSON::toString(object, true) << "\n";
+    stream->flush();
+    return stream->getStatus().wasOk();
+}
+
+bool CalibrationJournal::load(CalibrationEngine::CalibrationSettings& settings,
+                              std::vector<CalibrationEngine::CalibrationPoint>& points) const
+{
+    if (!file.existsAsFile())
+        return false;
+
+    StringArray lines = StringArray::fromLines(file.loadFileAsString());
+    bool haveHeader = false;
+    points.clear();
+
+    for (const auto& line : lines)
+    {
+        if (line.trim().isEmpty())
+            continue;
+
+        // A line cut short by a crash doesn't parse, the lines around it are fine
+        var object = JSON::parse(line);
+        if (!object.isObject())
+            continue;
+
+        const String type = object.getProperty("type", "").toString();
+
+        if (type == "session")
+        {
+            if (static_cast<int>(object.getProperty("version", 0)) != journalVersion)
+                return false;
+
+            settings = settingsFromVar(object.getProperty("settings", var()));
+            haveHeader = true;
+        }
+        else if (type == "point" && haveHeader)
+        {
+            points.push_back(pointFromVar(object));
+        }
+    }
+
+    return haveHeader && !points.empty();
+}
+
+bool CalibrationJournal::hasResumableSession() const
+{
+    CalibrationEngine::CalibrationSettings settings;
+    std::vector<CalibrationEngine::CalibrationPoint> points;
+    return load(settings, points);
+}
+
+var CalibrationJournal::settingsToVar(const CalibrationEngine::CalibrationSettings& s)
+{
+    var v(new DynamicObject());
+    auto* o = v.getDynamicObject();
+
+    o->setProperty("mode", s.mode == CalibrationEngine::Mode::ContinuousSweep ? "sweep" : "stepped");
+    o->setProperty("startNote", s.startNote);
+    o->setProperty("endNote", s.endNote);
+    o->setProperty("noteStep", s.noteStep);
+    o->setProperty("settleTimeMs", s.settleTimeMs);
+    o->setProperty("measurementsPerNote", s.measurementsPerNote);
+    o->setProperty("maxRejectedRepeats", s.maxRejectedRepeats);
+    o->setProperty("targetPrecisionCents", s.targetPrecisionCents);
+    o->setProperty("maxPeriodsPerMeasurement", s.maxPeriodsPerMeasurement);
+    o->setProperty("standard", s.standard == CVOutputManager::VoltageStandard::HzPerVolt ? "Hz/V" : "1V/Oct");
+    o->setProperty("useExternalCVSource", s.useExternalCVSource);
+    o->setProperty("sweepTimeSeconds", s.sweepTimeSeconds);
+    o->setProperty("adaptive", s.adaptive);
+    o->setProperty("coarseStep", s.coarseStep);
+    o->setProperty("adaptiveToleranceCents", s.adaptiveToleranceCents);
+    o->setProperty("maxRetries", s.maxRetries);
+    o->setProperty("skipFailedPoints", s.skipFailedPoints);
+    o->setProperty("pointLogFile", s.pointLogFile.getFullPathName());
+
+    return v;
+}
+
+CalibrationEngine::CalibrationSettings CalibrationJournal::settingsFromVar(const var& v)
+{
+    CalibrationEngine::CalibrationSettings s;
+
+    s.mode = v.getProperty("mode", "").toString() == "sweep" ? CalibrationEngine::Mode::ContinuousSweep
+                                                              : CalibrationEngine::Mode::Stepped;
+    s.startNote = v.getProperty("startNote", s.startNote);
+    s.endNote = v.getProperty("endNote", s.endNote);
+    s.noteStep = v.getProperty("noteStep", s.noteStep);
+    s.settleTimeMs = v.getProperty("settleTimeMs", s.settleTimeMs);
+    s.measurementsPerNote = v.getProperty("measurementsPerNote", s.measurementsPerNote);
+    s.maxRejectedRepeats = v.getProperty("maxRejectedRepeats", s.maxRejectedRepeats);
+    s.targetPrecisionCents = v.getProperty("targetPrecisionCents", s.targetPrecisionCents);
+    s.maxPeriodsPerMeasurement = v.getProperty("maxPeriodsPerMeasurement", s.maxPeriodsPerMeasurement);
+    s.standard = v.getProperty("standard", "").toString() == "Hz/V" ? CVOutputManager::VoltageStandard::HzPerVolt
+                                                                    : CVOutputManager::VoltageStandard::OneVoltPerOctave;
+    s.useExternalCVSource = v.getProperty("useExternalCVSource", s.useExternalCVSource);
+    s.sweepTimeSeconds = v.getProperty("sweepTimeSeconds", s.sweepTimeSeconds);
+    s.adaptive = v.getProperty("adaptive", s.adaptive);
+    s.coarseStep = v.getProperty("coarseStep", s.coarseStep);
+    s.adaptiveToleranceCents = v.getProperty("adaptiveToleranceCents", s.adaptiveToleranceCents);
+    s.maxRetries = v.getProperty("maxRetries", s.maxRetries);
+    s.skipFailedPoints = v.getProperty("skipFailedPoints", s.skipFailedPoints);
+
+    const String pointLogPath = v.getProperty("pointLogFile", "").toString();
+    if (pointLogPath.isNotEmpty())
+        s.pointLogFile = File(pointLogPath);
+
+    return s;
+}
+
+var CalibrationJournal::pointToVar(const CalibrationEngine::CalibrationPoint& point)
+{
+    var v(new DynamicObject());
+    auto* o = v.getDynamicObject();
+
+    o->setProperty("midiNote", point.targetMidiNote);
+    o->setProperty("targetVoltage", point.targetVoltage);
+    o->setProperty("measuredFrequency", point.measuredFrequency);
+    o->setProperty("measuredPitch", point.measuredPitch);
+    o->setProperty("pitchError", point.pitchError);
+    o->setProperty("errorCents", point.errorCents);
+    o->setProperty("voltageCorrection", point.voltageCorrection);
+    o->setProperty("stdDevCents", point.stdDevCents);
+    o->setProperty("valid", point.valid);
+    o->setProperty("numRetries", point.numRetries);
+    if (point.failureReason.isNotEmpty())
+        o->setProperty("failureReason", point.failureReason);
+    o->setProperty("timestamp", point.timestamp.toISO8601(true));
+
+    Array<var> repeats;
+    for (const auto& r : point.repeats)
+    {
+        var rv(new DynamicObject());
+        rv.getDynamicObject()->setProperty("pitchCents", r.pitchCents);
+        rv.getDynamicObject()->setProperty("stdDevCents", r.stdDevCents);
+        rv.getDynamicObject()->setProperty("numPeriods", r.numPeriods);
+        rv.getDynamicObject()->setProperty("rejected", r.rejected);
+        repeats.add(rv);
+    }
+    o->setProperty("repeats", repeats);
+
+    return v;
+}
+
+CalibrationEngine::CalibrationPoint CalibrationJournal::pointFromVar(const var& v)
+{
+    CalibrationEngine::CalibrationPoint point;
+
+    point.targetMidiNote = v.getProperty("midiNote", 0);
+    point.targetVoltage = v.getProperty("targetVoltage", 0.0f);
+    point.measuredFrequency = v.getProperty("measuredFrequency", 0.0f);
+    point.measuredPitch = v.getProperty("measuredPitch", 0.0f);
+    point.pitchError = v.getProperty("pitchError", 0.0f);
+    point.errorCents = v.getProperty("errorCents", 0.0f);
+    point.voltageCorrection = v.getProperty("voltageCorrection", 0.0f);
+    point.stdDevCents = v.getProperty("stdDevCents", 0.0f);
+    point.valid = v.getProperty("valid", true);
+    point.numRetries = v.getProperty("numRetries", 0);
+    point.failureReason = v.getProperty("failureReason", "").toString();
+    point.timestamp = Time::fromISO8601(v.getProperty("timestamp", "").toString());
+
+    if (auto* repeats = v.getProperty("repeats", var()).getArray())
+    {
+        for (const auto& rv : *repeats)
+        {
+            CalibrationEngine::Repeat r;
+            r.pitchCents = rv.getProperty("pitchCents", 0.0f);
+            r.stdDevCents = rv.getProperty("stdDevCents", 0.0f);
+            r.numPeriods = rv.getProperty("numPeriods", 0);
+            r.rejected = rv.getProperty("rejected", false);
+            if (r.rejected)
+                point.numRejected++;
+            point.repeats.push_back(r);
+        }
+    }
+
+    return point;
+}
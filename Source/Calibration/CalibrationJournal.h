@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    CalibrationJournal.h
+    Append-only checkpoint file for resuming interrupted calibrations
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CalibrationEngine.h"
+
+// Writes one JSON object per line: a session header with the calibration
+// settings, followed by every completed point. Each line is flushed as soon
+// as it is written, so after a crash or an error at most the point being
+// measured is lost. A line cut short by a crash is skipped when reading
+// back, and writing continues after the last complete line.
+class CalibrationJournal
+{
+public:
+    explicit CalibrationJournal(const File& journalFile = getDefaultFile());
+    ~CalibrationJournal();
+
+    static File getDefaultFile();
+    const File& getFile() const { return file; }
+
+    // Writing - starts a new journal, replacing any previous one. Points
+    // are appended to whatever the file holds, so after a load further
+    // points simply continue the same session.
+    bool beginSession(const CalibrationEngine::CalibrationSettings& settings);
+    bool appendPoint(const CalibrationEngine::CalibrationPoint& point);
+
+    // Called once the session has completed, the journal is no longer needed
+    void discard();
+
+    // Reading - true if the file holds a session with at least one point
+    bool load(CalibrationEngine::CalibrationSettings& settings,
+              std::vector<CalibrationEngine::CalibrationPoint>& points) const;
+    bool hasResumableSession() const;
+
+private:
+    bool writeLine(const var& object);
+
+    static var settingsToVar(const CalibrationEngine::CalibrationSettings& settings);
+    static CalibrationEngine::CalibrationSettings settingsFromVar(const var& v);
+    static var pointToVar(const CalibrationEngine::CalibrationPoint& point);
+    static CalibrationEngine::CalibrationPoint pointFromVar(const var& v);
+
+    File file;
+    std::unique_ptr<FileOutputStream> stream;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CalibrationJournal)
+};
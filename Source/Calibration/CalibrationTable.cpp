@@ -8,6 +8,8 @@
 */
 
 #include "CalibrationTable.h"
+#include "../Export/JSONReader.h"
+#include "../Export/JSONWriter.h"
 #include <algorithm>
 #include <cmath>
 
@@ -73,6 +75,55 @@ float CalibrationTable::getCorrectionOffset(float targetMidiPitch) const
     return linearInterpolate(targetMidiPitch);
 }
 
+void CalibrationTable::getCorrectedVoltages(const float* targetMidiPitches, float* destination, int numPitches) const
+{
+    if (entries.size() < 2)
+    {
+        for (int i = 0; i < numPitches; ++i)
+            destination[i] = getCorrectedVoltage(targetMidiPitches[i]);
+        return;
+    }
+
+    std::vector<const Entry*> sorted;
+    sorted.reserve(entries.size());
+    for (const auto& entry : entries)
+        sorted.push_back(&entry);
+    std::stable_sort(sorted.begin(), sorted.end(),
+        [](const Entry* a, const Entry* b) { return a->midiNote < b->midiNote; });
+
+    for (int i = 0; i < numPitches; ++i)
+    {
+        const float pitch = targetMidiPitches[i];
+
+        // First entry above the pitch, the one before it is the lower neighbour
+        auto upper = std::upper_bound(sorted.begin(), sorted.end(), pitch,
+            [](float p, const Entry* e) { return p < e->midiNote; });
+
+        float correction;
+        if (upper == sorted.begin())
+            correction = sorted.front()->correctionOffset;
+        else
+        {
+            // Of repeated notes the first one counts, as in linearInterpolate()
+            auto lowerIt = upper - 1;
+            while (lowerIt != sorted.begin() && (*(lowerIt - 1))->midiNote == (*lowerIt)->midiNote)
+                --lowerIt;
+
+            const Entry* lower = *lowerIt;
+            if (upper == sorted.end() || lower->midiNote == pitch)
+                correction = lower->correctionOffset;
+            else
+            {
+                float t = (pitch - lower->midiNote) / ((*upper)->midiNote - lower->midiNote);
+                correction = lower->correctionOffset + t * ((*upper)->correctionOffset - lower->correctionOffset);
+            }
+        }
+
+        // For 1V/Oct: ideal voltage = (pitch - 60) / 12
+        destination[i] = (pitch - 60.0f) / 12.0f + correction;
+    }
+}
+
 float CalibrationTable::linearInterpolate(float pitch) const
 {
     if (entries.empty())
@@ -265,84 +316,144 @@ float CalibrationTable::evaluatePolynomial(const std::vector<double>& coefficien
 
 void CalibrationTable::saveToFile(const File& file) const
 {
-    var data(new DynamicObject());
-
-    data.getDynamicObject()->setProperty("version", "1.0");
-    data.getDynamicObject()->setProperty("deviceName", deviceName);
-    data.getDynamicObject()->setProperty("deviceBrand", deviceBrand);
-    data.getDynamicObject()->setProperty("interfaceName", interfaceName);
-    data.getDynamicObject()->setProperty("notes", notes);
-    data.getDynamicObject()->setProperty("calibrationDate", calibrationDate.toISO8601(true));
-    data.getDynamicObject()->setProperty("voltageStandard", voltageStandard);
-
-    Array<var> entriesArray;
-    for (const auto& entry : entries)
+    TemporaryFile tempFile(file);
     {
-        var e(new DynamicObject());
-        e.getDynamicObject()->setProperty("midiNote", entry.midiNote);
-        e.getDynamicObject()->setProperty("idealVoltage", entry.idealVoltage);
-        e.getDynamicObject()->setProperty("actualVoltage", entry.actualVoltage);
-        e.getDynamicObject()->setProperty("correctionOffset", entry.correctionOffset);
-        e.getDynamicObject()->setProperty("measuredFrequency", entry.measuredFrequency);
-        e.getDynamicObject()->setProperty("errorCents", entry.errorCents);
-        e.getDynamicObject()->setProperty("stdDevCents", entry.stdDevCents);
-        entriesArray.add(e);
+        FileOutputStream stream(tempFile.getFile());
+        if (stream.failedToOpen())
+            return;
+
+        JSONWriter json(stream);
+        json.beginObject();
+        json.property("version", "1.0");
+        json.property("deviceName", deviceName);
+        json.property("deviceBrand", deviceBrand);
+        json.property("interfaceName", interfaceName);
+        json.property("notes", notes);
+        json.property("calibrationDate", calibrationDate.toISO8601(true));
+        json.property("voltageStandard", voltageStandard);
+
+        json.key("entries");
+        json.beginArray();
+        for (const auto& entry : entries)
+        {
+            json.beginObject();
+            json.property("midiNote", entry.midiNote);
+            json.property("idealVoltage", entry.idealVoltage);
+            json.property("actualVoltage", entry.actualVoltage);
+            json.property("correctionOffset", entry.correctionOffset);
+            json.property("measuredFrequency", entry.measuredFrequency);
+            json.property("errorCents", entry.errorCents);
+            json.property("stdDevCents", entry.stdDevCents);
+            json.endObject();
+        }
+        json.endArray();
+
+        // Statistics
+        json.key("statistics");
+        json.beginObject();
+        json.property("maxErrorCents", getMaxErrorCents());
+        json.property("minErrorCents", getMinErrorCents());
+        json.property("avgErrorCents", getAverageErrorCents());
+        json.property("rmsErrorCents", getRMSErrorCents());
+        auto worst = getWorstNote();
+        json.property("worstNote", worst.first);
+        json.property("worstError", worst.second);
+        json.endObject();
+
+        json.endObject();
+        stream.flush();
+        if (stream.getStatus().failed())
+            return;
     }
-    data.getDynamicObject()->setProperty("entries", entriesArray);
-
-    // Statistics
-    var stats(new DynamicObject());
-    stats.getDynamicObject()->setProperty("maxErrorCents", getMaxErrorCents());
-    stats.getDynamicObject()->setProperty("minErrorCents", getMinErrorCents());
-    stats.getDynamicObject()->setProperty("avgErrorCents", getAverageErrorCents());
-    stats.getDynamicObject()->setProperty("rmsErrorCents", getRMSErrorCents());
-    auto worst = getWorstNote();
-    stats.getDynamicObject()->setProperty("worstNote", worst.first);
-    stats.getDynamicObject()->setProperty("worstError", worst.second);
-    data.getDynamicObject()->setProperty("statistics", stats);
-
-    file.replaceWithText(JSON::toString(data, true));
+    tempFile.overwriteTargetFileWithTemporary();
 }
 
 bool CalibrationTable::loadFromFile(const File& file)
 {
-    if (!file.existsAsFile())
+    FileInputStream stream(file);
+    if (!stream.openedOk())
         return false;
 
-    var data = JSON::parse(file.loadFileAsString());
-    if (!data.isObject())
+    JSONReader json(stream);
+    if (json.next() != JSONReader::beginObject)
         return false;
 
-    deviceName = data.getProperty("deviceName", "").toString();
-    deviceBrand = data.getProperty("deviceBrand", "").toString();
-    interfaceName = data.getProperty("interfaceName", "").toString();
-    notes = data.getProperty("notes", "").toString();
-    voltageStandard = data.getProperty("voltageStandard", "1V/Oct").toString();
+    // parsed into locals so a broken file leaves the table untouched
+    String newDeviceName, newDeviceBrand, newInterfaceName, newNotes;
+    String newVoltageStandard = "1V/Oct";
+    Time newCalibrationDate = calibrationDate;
+    std::vector<Entry> newEntries;
 
-    String dateStr = data.getProperty("calibrationDate", "").toString();
-    if (dateStr.isNotEmpty())
-        calibrationDate = Time::fromISO8601(dateStr);
-
-    entries.clear();
-    if (data.hasProperty("entries"))
+    while (json.next() == JSONReader::key)
     {
-        auto* arr = data.getProperty("entries", var()).getArray();
-        if (arr != nullptr)
+        const std::string& name = json.getText();
+        if (name == "deviceName")
+            newDeviceName = json.readString();
+        else if (name == "deviceBrand")
+            newDeviceBrand = json.readString();
+        else if (name == "interfaceName")
+            newInterfaceName = json.readString();
+        else if (name == "notes")
+            newNotes = json.readString();
+        else if (name == "voltageStandard")
+            newVoltageStandard = json.readString("1V/Oct");
+        else if (name == "calibrationDate")
         {
-            for (const auto& e : *arr)
+            String dateStr = json.readString();
+            if (dateStr.isNotEmpty())
+                newCalibrationDate = Time::fromISO8601(dateStr);
+        }
+        else if (name == "entries")
+        {
+            if (json.next() != JSONReader::beginArray)
+            {
+                json.skipCurrent();
+                continue;
+            }
+
+            while (json.next() == JSONReader::beginObject)
             {
                 Entry entry;
-                entry.midiNote = e.getProperty("midiNote", 0);
-                entry.idealVoltage = e.getProperty("idealVoltage", 0.0f);
-                entry.actualVoltage = e.getProperty("actualVoltage", 0.0f);
-                entry.correctionOffset = e.getProperty("correctionOffset", 0.0f);
-                entry.measuredFrequency = e.getProperty("measuredFrequency", 0.0f);
-                entry.errorCents = e.getProperty("errorCents", 0.0f);
-                entry.stdDevCents = e.getProperty("stdDevCents", 0.0f);
-                entries.push_back(entry);
+                while (json.next() == JSONReader::key)
+                {
+                    const std::string& field = json.getText();
+                    if (field == "midiNote")
+                        entry.midiNote = static_cast<int>(json.readNumber());
+                    else if (field == "idealVoltage")
+                        entry.idealVoltage = static_cast<float>(json.readNumber());
+                    else if (field == "actualVoltage")
+                        entry.actualVoltage = static_cast<float>(json.readNumber());
+                    else if (field == "correctionOffset")
+                        entry.correctionOffset = static_cast<float>(json.readNumber());
+                    else if (field == "measuredFrequency")
+                        entry.measuredFrequency = static_cast<float>(json.readNumber());
+                    else if (field == "errorCents")
+                        entry.errorCents = static_cast<float>(json.readNumber());
+                    else if (field == "stdDevCents")
+                        entry.stdDevCents = static_cast<float>(json.readNumber());
+                    else
+                        json.skipValue();
+                }
+                if (json.getToken() != JSONReader::endObject)
+                    return false;
+                newEntries.push_back(entry);
             }
+            if (json.getToken() != JSONReader::endArray)
+                return false;
         }
+        else
+            json.skipValue();
     }
+    if (json.getToken() != JSONReader::endObject)
+        return false;
+
+    deviceName = newDeviceName;
+    deviceBrand = newDeviceBrand;
+    interfaceName = newInterfaceName;
+    notes = newNotes;
+    voltageStandard = newVoltageStandard;
+    calibrationDate = newCalibrationDate;
+    entries = std::move(newEntries);
 
     return true;
 }
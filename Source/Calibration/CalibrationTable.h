@@ -47,6 +47,10 @@ public:
     float getCorrectedVoltage(float targetMidiPitch) const;
     float getCorrectionOffset(float targetMidiPitch) const;
 
+    // Same as getCorrectedVoltage() for many pitches at once, the table is
+    // sorted once and searched per pitch instead of scanned for every pitch
+    void getCorrectedVoltages(const float* targetMidiPitches, float* destination, int numPitches) const;
+
     // Statistics
     float getMaxErrorCents() const;
     float getMinErrorCents() const;
@@ -0,0 +1,278 @@
+/*
+  ==============================================================================
+
+    MultiCalibrationEngine.cpp
+    Calibrates several VCOs at once over independent CV/input channel pairs
+
+  ==============================================================================
+*/
+
+#include "MultiCalibrationEngine.h"
+#include <algorithm>
+#include <cmath>
+
+MultiCalibrationEngine::MultiCalibrationEngine(VCOTuner* t, CVOutputManager* cv)
+    : tuner(t), cvOutput(cv)
+{
+}
+
+MultiCalibrationEngine::~MultiCalibrationEngine()
+{
+    stopTimer();
+    if (isRunning())
+        stopAll();
+}
+
+bool MultiCalibrationEngine::startCalibration(const std::vector<Session>& newSessions, const Settings& s)
+{
+    if (tuner == nullptr || cvOutput == nullptr || isRunning() || newSessions.empty()
+        || s.noteStep <= 0 || s.startNote > s.endNote)
+        return false;
+
+    // Every session needs its own CV channel and its own input
+    for (size_t i = 0; i < newSessions.size(); ++i)
+    {
+        const auto& session = newSessions[i];
+        if (!isPositiveAndBelow(session.cvChannel, cvOutput->getNumChannels())
+            || tuner->getPeriodTracker(session.inputChannel) == nullptr)
+            return false;
+
+        for (size_t j = 0; j < i; ++j)
+            if (newSessions[j].cvChannel == session.cvChannel || newSessions[j].inputChannel == session.inputChannel)
+                return false;
+    }
+
+    settings = s;
+    sessions.clear();
+    for (const auto& session : newSessions)
+    {
+        SessionState sessionState;
+        sessionState.session = session;
+        sessionState.points.reserve(static_cast<size_t>(getTotalPoints()));
+        sessions.push_back(std::move(sessionState));
+
+        auto& channel = cvOutput->getChannel(session.cvChannel);
+        channel.setVoltageStandard(settings.standard);
+        channel.setActive(true);
+    }
+
+    currentNote = settings.startNote;
+    completedNotes = 0;
+    listeners.call(&Listener::multiCalibrationStarted, getNumSessions());
+
+    outputCurrentNote();
+    startTimer(10);
+    return true;
+}
+
+void MultiCalibrationEngine::cancelCalibration()
+{
+    if (!isRunning())
+        return;
+
+    stopTimer();
+    stopAll();
+    listeners.call(&Listener::multiCalibrationCancelled);
+}
+
+int MultiCalibrationEngine::getTotalPoints() const
+{
+    if (settings.noteStep <= 0)
+        return 0;
+    return ((settings.endNote - settings.startNote) / settings.noteStep) + 1;
+}
+
+float MultiCalibrationEngine::getProgressPercent() const
+{
+    int total = getTotalPoints();
+    if (total <= 0)
+        return 0.0f;
+    return (static_cast<float>(completedNotes) / total) * 100.0f;
+}
+
+CalibrationTable MultiCalibrationEngine::generateCalibrationTable(int session) const
+{
+    const auto& sessionState = sessions[static_cast<size_t>(session)];
+    CalibrationTable table = CalibrationEngine::buildCalibrationTable(sessionState.points,
+                                                                      cvOutput->getChannel(sessionState.session.cvChannel));
+    table.setDeviceName(sessionState.session.name);
+    return table;
+}
+
+void MultiCalibrationEngine::timerCallback()
+{
+    tickCounter++;
+
+    switch (state)
+    {
+        case State::Settling:
+            if (tickCounter * 10 >= settings.settleTimeMs)
+                startMeasuring();
+            break;
+
+        case State::Measuring:
+            // Drain the FIFOs regularly so they never overflow
+            for (auto& session : sessions)
+                if (!session.failed)
+                    tuner->getPeriodTracker(session.session.inputChannel)->readPeriods(session.periods);
+
+            if (tickCounter * 10 >= settings.measureTimeMs)
+                finishMeasuring();
+            break;
+
+        case State::Idle:
+            stopTimer();
+            break;
+    }
+}
+
+void MultiCalibrationEngine::outputCurrentNote()
+{
+    for (auto& session : sessions)
+    {
+        if (session.failed)
+            continue;
+
+        auto& channel = cvOutput->getChannel(session.session.cvChannel);
+        channel.outputVoltage(channel.midiToVoltage(static_cast<float>(currentNote)));
+    }
+
+    state = State::Settling;
+    tickCounter = 0;
+}
+
+void MultiCalibrationEngine::startMeasuring()
+{
+    for (auto& session : sessions)
+    {
+        if (session.failed)
+            continue;
+
+        session.periods.clear();
+        tuner->getPeriodTracker(session.session.inputChannel)->start();
+    }
+
+    state = State::Measuring;
+    tickCounter = 0;
+}
+
+void MultiCalibrationEngine::finishMeasuring()
+{
+    for (int i = 0; i < getNumSessions(); ++i)
+    {
+        auto& session = sessions[static_cast<size_t>(i)];
+        if (session.failed)
+            continue;
+
+        auto* tracker = tuner->getPeriodTracker(session.session.inputChannel);
+        tracker->stop();
+        tracker->readPeriods(session.periods);
+
+        CalibrationEngine::CalibrationPoint point;
+        point.targetMidiNote = currentNote;
+        point.targetVoltage = cvOutput->getChannel(session.session.cvChannel).midiToVoltage(static_cast<float>(currentNote));
+
+        if (!measureSession(session, point))
+        {
+            failSession(i, "No signal detected at note " + String(currentNote));
+            continue;
+        }
+
+        session.points.push_back(point);
+        listeners.call(&Listener::sessionPointCompleted, i, point);
+    }
+
+    completedNotes++;
+    currentNote += settings.noteStep;
+
+    for (int i = 0; i < getNumSessions(); ++i)
+    {
+        if (sessions[static_cast<size_t>(i)].failed)
+            continue;
+
+        const auto& point = sessions[static_cast<size_t>(i)].points.back();
+        listeners.call(&Listener::sessionProgress, i, getProgressPercent(),
+                       "Note " + String(point.targetMidiNote) + ": " + String(point.errorCents, 1) + " cents error");
+    }
+
+    bool anyActive = std::any_of(sessions.begin(), sessions.end(), [](const SessionState& s) { return !s.failed; });
+
+    if (currentNote > settings.endNote || !anyActive)
+    {
+        finish();
+        return;
+    }
+
+    outputCurrentNote();
+}
+
+bool MultiCalibrationEngine::measureSession(SessionState& session, CalibrationEngine::CalibrationPoint& point) const
+{
+    auto& periods = session.periods;
+    if (static_cast<int>(periods.size()) < settings.minPeriods)
+        return false;
+
+    // Median period as the reference, then reject missed or doubled zero
+    // crossings that land more than a quarter tone away
+    std::vector<double> lengths;
+    lengths.reserve(periods.size());
+    for (const auto& period : periods)
+        lengths.push_back(period.length);
+    std::nth_element(lengths.begin(), lengths.begin() + lengths.size() / 2, lengths.end());
+    const double median = lengths[lengths.size() / 2];
+
+    if (median <= 0.0)
+        return false;
+
+    RunningStatistics cents;
+    for (const auto& period : periods)
+    {
+        if (period.length <= 0.0)
+            continue;
+
+        const double deviation = 1200.0 * std::log2(median / period.length);
+        if (std::abs(deviation) <= 50.0)
+            cents.add(deviation);
+    }
+
+    if (cents.getCount() < settings.minPeriods)
+        return false;
+
+    const double frequency = tuner->getCurrentSampleRate() / median * std::pow(2.0, cents.getMean() / 1200.0);
+    CalibrationEngine::evaluatePoint(point, static_cast<float>(frequency), settings.standard);
+    point.stdDevCents = static_cast<float>(cents.getStandardDeviation());
+    return true;
+}
+
+void MultiCalibrationEngine::failSession(int index, const String& error)
+{
+    auto& session = sessions[static_cast<size_t>(index)];
+    session.failed = true;
+    tuner->getPeriodTracker(session.session.inputChannel)->stop();
+    cvOutput->getChannel(session.session.cvChannel).setActive(false);
+    listeners.call(&Listener::sessionError, index, error);
+}
+
+void MultiCalibrationEngine::finish()
+{
+    stopTimer();
+    stopAll();
+
+    for (int i = 0; i < getNumSessions(); ++i)
+        if (!sessions[static_cast<size_t>(i)].failed)
+            listeners.call(&Listener::sessionCompleted, i, generateCalibrationTable(i));
+
+    listeners.call(&Listener::multiCalibrationFinished);
+}
+
+void MultiCalibrationEngine::stopAll()
+{
+    for (auto& session : sessions)
+    {
+        if (auto* tracker = tuner->getPeriodTracker(session.session.inputChannel))
+            tracker->stop();
+        cvOutput->getChannel(session.session.cvChannel).setActive(false);
+    }
+
+    state = State::Idle;
+}
@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+
+    MultiCalibrationEngine.h
+    Calibrates several VCOs at once over independent CV/input channel pairs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CalibrationEngine.h"
+#include "../Measurement/RunningStatistics.h"
+
+// Runs one calibration session per CV output / audio input pair. All sessions
+// step through the same note grid in lockstep: every CV channel is set, the
+// engine waits for the settle time once, and then each session collects
+// periods from the PeriodTracker on its own input. Sessions share VCOTuner's
+// audio callback, so K oscillators take as long as one.
+class MultiCalibrationEngine : private Timer
+{
+public:
+    struct Session
+    {
+        int cvChannel = 0;          // CVOutputManager channel driving the VCO
+        int inputChannel = 0;       // Device input the VCO is connected to
+        String name;
+    };
+
+    struct Settings
+    {
+        int startNote = 24;
+        int endNote = 96;
+        int noteStep = 1;
+        int settleTimeMs = 200;
+        int measureTimeMs = 250;    // Period collection time per note
+        int minPeriods = 16;        // Below this a session reports no signal
+        CVOutputManager::VoltageStandard standard = CVOutputManager::VoltageStandard::OneVoltPerOctave;
+    };
+
+    // All callbacks happen on the message thread, session is the index into
+    // the session list passed to startCalibration()
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+        virtual void multiCalibrationStarted(int numSessions) {}
+        virtual void sessionPointCompleted(int session, const CalibrationEngine::CalibrationPoint& point) {}
+        virtual void sessionProgress(int session, float percent, const String& status) {}
+        virtual void sessionCompleted(int session, const CalibrationTable& table) {}
+        virtual void sessionError(int session, const String& error) {}
+        virtual void multiCalibrationFinished() {}
+        virtual void multiCalibrationCancelled() {}
+    };
+
+    MultiCalibrationEngine(VCOTuner* tuner, CVOutputManager* cvOutput);
+    ~MultiCalibrationEngine() override;
+
+    // Control
+    bool startCalibration(const std::vector<Session>& sessions, const Settings& settings);
+    void cancelCalibration();
+    bool isRunning() const { return state != State::Idle; }
+
+    // Progress and results
+    int getNumSessions() const { return static_cast<int>(sessions.size()); }
+    int getTotalPoints() const;
+    float getProgressPercent() const;
+    bool hasSessionFailed(int session) const { return sessions[static_cast<size_t>(session)].failed; }
+    const std::vector<CalibrationEngine::CalibrationPoint>& getCalibrationData(int session) const
+    {
+        return sessions[static_cast<size_t>(session)].points;
+    }
+    CalibrationTable generateCalibrationTable(int session) const;
+
+    // Listener management
+    void addListener(Listener* l) { listeners.add(l); }
+    void removeListener(Listener* l) { listeners.remove(l); }
+
+private:
+    enum class State
+    {
+        Idle,
+        Settling,
+        Measuring
+    };
+
+    struct SessionState
+    {
+        Session session;
+        std::vector<CalibrationEngine::CalibrationPoint> points;
+        std::vector<PeriodTracker::Period> periods;
+        bool failed = false;
+    };
+
+    void timerCallback() override;
+    void outputCurrentNote();
+    void startMeasuring();
+    void finishMeasuring();
+    bool measureSession(SessionState& session, CalibrationEngine::CalibrationPoint& point) const;
+    void failSession(int index, const String& error);
+    void finish();
+    void stopAll();
+
+    VCOTuner* tuner;
+    CVOutputManager* cvOutput;
+    ListenerList<Listener> listeners;
+
+    State state = State::Idle;
+    Settings settings;
+    std::vector<SessionState> sessions;
+
+    int currentNote = 0;
+    int completedNotes = 0;
+    int tickCounter = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MultiCalibrationEngine)
+};
@@ -0,0 +1,493 @@
+/*
+  ==============================================================================
+
+    ChartPainter.cpp
+    Draws the pitch offset chart of a set of measurements
+
+  ==============================================================================
+*/
+
+#include "ChartPainter.h"
+#include "ModernLookAndFeel.h"
+
+Range<double> ChartPainter::getAutoRange()
+{
+    if (autoRangeVersion == measurements.getVersion())
+        return autoRange;
+
+    double max = 0;
+    double min = 0;
+    for (int i = 0; i < measurements.size(); i++)
+    {
+        double value = measurements.getAt(i).pitchOffset;
+        double deviation = measurements.getAt(i).pitchDeviation;
+        if (value - deviation < min)
+            min = value - deviation;
+        if (value + deviation > max)
+            max = value + deviation;
+    }
+    double expandAmount = (max - min) * 0.2;
+    min -= expandAmount;
+    max += expandAmount;
+
+    autoRange = Range<double>(min, max);
+    autoRangeVersion = measurements.getVersion();
+    return autoRange;
+}
+
+void ChartPainter::paintWithFixedScaling(Graphics& g, int width, int height, double min, double max)
+{
+    // Dark background
+    g.fillAll(ModernLookAndFeel::Colors::background);
+
+    if (measurements.isEmpty())
+    {
+        g.setColour(ModernLookAndFeel::Colors::textDim);
+        g.setFont(Font(18.0f));
+        g.drawText("No Data", 0, 0, width, height, juce::Justification::centred);
+        return;
+    }
+
+    // Draw top info panel
+    drawTopInfoPanel(g, width, topInfoHeight);
+
+    ChartLayout layout;
+    if (!computeLayout(layout, width, height, min, max, Range<int>(0, measurements.size())))
+        return;
+
+    drawChartBackground(g, layout);
+    drawColumns(g, layout, Range<int>(0, measurements.size()));
+    drawNoteLabels(g, layout);
+}
+
+bool ChartPainter::computeLayout(ChartLayout& layout, int width, int height, double min, double max, Range<int> columns)
+{
+    // Full width chart layout (tuner is now in separate tab)
+    layout.width = width;
+    layout.height = height;
+    layout.imageHeight = height - bottomBarHeight - topInfoHeight;
+    layout.firstColumn = columns.getStart();
+    layout.numColumns = columns.getLength();
+
+    // prepare coordinate transformation (flipping the y axis)
+    layout.heightForFlipping = (float)layout.imageHeight + topInfoHeight;
+
+    layout.chartTop = (float)topInfoHeight;
+    layout.columnWidth = (double)(width - sidebarWidth) / (double)layout.numColumns;
+
+    // combine neighbouring columns until each one is at least a pixel wide
+    updatePyramid();
+    layout.level = pyramid.getLevelFor(1.0 / layout.columnWidth);
+
+    if (min > -allowedPitchOffset)
+        min = -allowedPitchOffset;
+    if (max < allowedPitchOffset)
+        max = allowedPitchOffset;
+    if (max < min)
+        return false;
+
+    layout.min = min;
+    layout.max = max;
+    layout.vertScaling = (double)layout.imageHeight / (max - min);
+    return true;
+}
+
+void ChartPainter::drawChartBackground(Graphics& g, const ChartLayout& layout)
+{
+    heightForFlipping = layout.heightForFlipping;
+    const int width = layout.width;
+    const int height = layout.height;
+    const int imageHeight = layout.imageHeight;
+    const float chartTop = layout.chartTop;
+    const double min = layout.min;
+    const double max = layout.max;
+    const double vertScaling = layout.vertScaling;
+
+    // Draw graph area background
+    Rectangle<float> graphArea(sidebarWidth, chartTop, (float)(width - sidebarWidth), (float)imageHeight);
+    g.setColour(ModernLookAndFeel::Colors::panel.withAlpha(0.3f));
+    g.fillRect(graphArea);
+
+    // Draw "in-tune" zone (green band around center)
+    double tuneZoneTop = (allowedPitchOffset - min) * vertScaling;
+    double tuneZoneBottom = (-allowedPitchOffset - min) * vertScaling;
+    g.setColour(ModernLookAndFeel::Colors::meter.withAlpha(0.08f));
+    g.fillRect(Rectangle<float>(sidebarWidth, yFlip((float)tuneZoneTop),
+                                 (float)(width - sidebarWidth), (float)(tuneZoneTop - tuneZoneBottom)));
+
+    // Draw maximum "in-tune" pitch offset and center line
+    g.setColour(ModernLookAndFeel::Colors::meter.withAlpha(0.4f));
+    const float dashLengths[] = {6, 4};
+    double position = (allowedPitchOffset - min) * vertScaling;
+    g.drawDashedLine(Line<float>(sidebarWidth, yFlip((float)position), (float)width, yFlip((float)position)), dashLengths, 2);
+    position = (-allowedPitchOffset - min) * vertScaling;
+    g.drawDashedLine(Line<float>(sidebarWidth, yFlip((float)position), (float)width, yFlip((float)position)), dashLengths, 2);
+
+    // Center line (0 offset)
+    position = (-min) * vertScaling;
+    g.setColour(ModernLookAndFeel::Colors::textSecondary);
+    g.drawLine(sidebarWidth, yFlip((float)position), (float)width, yFlip((float)position), 2.0f);
+
+    // Draw Y-axis grid and labels
+    g.setColour(ModernLookAndFeel::Colors::textDim);
+    const int numIntervals = 13;
+    const double allowedIntervals[numIntervals] = {0.005, 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1, 2, 5, 10, 20, 50};
+    double lineInterval = allowedIntervals[0];
+    int currentIntervalIndex = 0;
+
+    int numLinesAllowed = imageHeight / 40;
+    while (((max - min) / lineInterval) > numLinesAllowed)
+    {
+        lineInterval = allowedIntervals[++currentIntervalIndex];
+        if (currentIntervalIndex >= numIntervals)
+            break;
+    }
+    bool useSemitoneTexts = lineInterval >= 1.0;
+
+    int numPosLines = (int)trunc(max / lineInterval);
+    int numNegLines = (int)trunc(-min / lineInterval);
+    for (double y = numPosLines; y > -numNegLines; y--)
+    {
+        double linePos = (y * lineInterval - min) * vertScaling;
+        double number = y * lineInterval * ((useSemitoneTexts) ? 1.0 : 100.0);
+        String numberString = (std::abs(number - round(number)) > 0.1) ? String(number, 1) : String((int)round(number));
+        String lineText = numberString;
+        if (!useSemitoneTexts)
+            lineText += "c";
+
+        g.setColour(ModernLookAndFeel::Colors::textSecondary);
+        g.setFont(Font(11.0f));
+        g.drawText(lineText, juce::Rectangle<float>(0, yFlip(float(linePos) + 7), sidebarWidth - 6, 14), Justification::centredRight);
+
+        // don't overwrite maximum "in-tune" lines
+        if (y * lineInterval == allowedPitchOffset || y * lineInterval == -allowedPitchOffset)
+            continue;
+
+        g.setColour(ModernLookAndFeel::Colors::panelLight.withAlpha(0.3f));
+        const float lineDashLengths[] = {2, 8};
+        g.drawDashedLine(Line<float>(sidebarWidth, yFlip((float)linePos), (float)width, yFlip((float)linePos)), lineDashLengths, 2);
+    }
+
+    // Draw the X-Axis label
+    g.setColour(ModernLookAndFeel::Colors::textSecondary);
+    g.setFont(Font(12.0f));
+    g.drawText("MIDI Note", 0, height - bottomBarHeight, (int)sidebarWidth - 10, bottomBarHeight, Justification::centredRight);
+}
+
+void ChartPainter::drawColumn(Graphics& g, const ChartLayout& layout, int i)
+{
+    heightForFlipping = layout.heightForFlipping;
+    const double columnWidth = layout.columnWidth;
+    const double min = layout.min;
+    const double vertScaling = layout.vertScaling;
+    const auto& m = measurements.getAt(i);
+
+    // Draw pitch measurement bars with modern styling
+    float left = sidebarWidth + (i - layout.firstColumn) * (float)columnWidth;
+    float barCenter = left + (float)columnWidth / 2.0f;
+    float barWidth = jmax(2.0f, (float)columnWidth * 0.7f);
+
+    // draw deviation range
+    float maxPosition = (float)((m.pitchOffset + m.pitchDeviation - min) * vertScaling) ;
+    float minPosition = (float)((m.pitchOffset - m.pitchDeviation - min) * vertScaling) ;
+
+    // Determine color based on pitch offset
+    float pitchCents = (float)(m.pitchOffset * 100.0);
+    Colour barColor;
+    if (std::abs(pitchCents) < 5.0f)
+        barColor = ModernLookAndFeel::Colors::meter;
+    else if (std::abs(pitchCents) < 15.0f)
+        barColor = ModernLookAndFeel::Colors::meterWarn;
+    else
+        barColor = ModernLookAndFeel::Colors::meterBad;
+
+    // Draw deviation band
+    g.setColour(barColor.withAlpha(0.25f));
+    g.fillRoundedRectangle(barCenter - barWidth / 2, yFlip(maxPosition), barWidth, maxPosition - minPosition, 2.0f);
+
+    // Draw average value bar
+    float pointPosition = (float)((m.pitchOffset - min) * vertScaling) ;
+    float centerLineY = (float)((-min) * vertScaling) ;
+
+    // Bar from center to value
+    float barTop = jmin(pointPosition, centerLineY);
+    float barHeight = std::abs(pointPosition - centerLineY);
+
+    g.setColour(barColor);
+    g.fillRoundedRectangle(barCenter - barWidth / 2, yFlip(barTop + barHeight), barWidth, barHeight, 2.0f);
+
+    // Draw glow effect for the bar
+    g.setColour(barColor.withAlpha(0.3f));
+    g.fillRoundedRectangle(barCenter - barWidth / 2 - 2, yFlip(barTop + barHeight) - 2,
+                           barWidth + 4, barHeight + 4, 3.0f);
+}
+
+void ChartPainter::drawBucket(Graphics& g, const ChartLayout& layout, int bucketIndex)
+{
+    heightForFlipping = layout.heightForFlipping;
+    const double min = layout.min;
+    const double vertScaling = layout.vertScaling;
+    const auto& b = pyramid.getBucket(layout.level, bucketIndex);
+    if (b.count == 0)
+        return;
+
+    // a plain envelope and mean bar, the details wouldn't be visible at this size
+    Range<int> columns = DecimationPyramid::getValueRange(layout.level, bucketIndex);
+    float left = sidebarWidth + (columns.getStart() - layout.firstColumn) * (float)layout.columnWidth;
+    float right = sidebarWidth + (columns.getEnd() - layout.firstColumn) * (float)layout.columnWidth;
+
+    float maxPosition = (float)((b.maximum - min) * vertScaling);
+    float minPosition = (float)((b.minimum - min) * vertScaling);
+    float pointPosition = (float)((b.mean - min) * vertScaling);
+    float centerLineY = (float)((-min) * vertScaling);
+
+    float pitchCents = (float)(b.mean * 100.0);
+    Colour barColor;
+    if (std::abs(pitchCents) < 5.0f)
+        barColor = ModernLookAndFeel::Colors::meter;
+    else if (std::abs(pitchCents) < 15.0f)
+        barColor = ModernLookAndFeel::Colors::meterWarn;
+    else
+        barColor = ModernLookAndFeel::Colors::meterBad;
+
+    g.setColour(barColor.withAlpha(0.25f));
+    g.fillRect(left, yFlip(maxPosition), right - left, maxPosition - minPosition);
+
+    g.setColour(barColor);
+    g.fillRect(left, yFlip(jmax(pointPosition, centerLineY)), right - left, std::abs(pointPosition - centerLineY));
+}
+
+void ChartPainter::drawColumns(Graphics& g, const ChartLayout& layout, Range<int> columns)
+{
+    columns = columns.getIntersectionWith(Range<int>(layout.firstColumn, layout.firstColumn + layout.numColumns));
+    if (columns.isEmpty())
+        return;
+
+    if (layout.level == 0)
+    {
+        for (int i = columns.getStart(); i < columns.getEnd(); i++)
+            drawColumn(g, layout, i);
+        return;
+    }
+
+    g.saveState();
+    g.reduceClipRegion(Rectangle<float>(sidebarWidth, layout.chartTop, (float)layout.width - sidebarWidth, (float)layout.imageHeight)
+                           .getSmallestIntegerContainer());
+    for (int b = columns.getStart() >> layout.level; b <= (columns.getEnd() - 1) >> layout.level; b++)
+        drawBucket(g, layout, b);
+    g.restoreState();
+}
+
+void ChartPainter::drawNoteLabels(Graphics& g, const ChartLayout& layout)
+{
+    const int height = layout.height;
+    const int imageHeight = layout.imageHeight;
+    const float chartTop = layout.chartTop;
+    const double columnWidth = layout.columnWidth;
+
+    // Draw note labels on X axis
+    g.setFont(Font(12.0f));
+    const int numPitchTextIntervals = 5;
+    const int pitchTextIntervals[numPitchTextIntervals] = {1, 2, 5, 10, 20};
+    int currentPitchTextIntervalIndex = 0;
+    while (g.getCurrentFont().getStringWidth("123.") > pitchTextIntervals[currentPitchTextIntervalIndex] * columnWidth)
+    {
+        if (currentPitchTextIntervalIndex + 1 >= numPitchTextIntervals)
+            break;
+        currentPitchTextIntervalIndex++;
+    }
+    int pitchTextInterval = pitchTextIntervals[currentPitchTextIntervalIndex];
+    int startLine = layout.firstColumn;
+    int endLine = layout.firstColumn + layout.numColumns - 1;
+    while (measurements.getPitchAt(startLine) % pitchTextInterval != 0)
+    {
+        startLine++;
+        if (startLine > endLine)
+            return;
+    }
+    while (measurements.getPitchAt(endLine) % pitchTextInterval != 0)
+    {
+        endLine--;
+        if (endLine < 0 || endLine < startLine)
+            return;
+    }
+
+    for (int i = startLine; i <= endLine; i += pitchTextInterval)
+    {
+        g.setColour(ModernLookAndFeel::Colors::textSecondary);
+        g.setFont(Font(11.0f));
+        float textWidth = g.getCurrentFont().getStringWidth(String(measurements.getPitchAt(i)));
+        float xLeft = sidebarWidth + (i - layout.firstColumn) * float(columnWidth);
+        float x = xLeft + float(columnWidth) / 2.0f - textWidth / 2.0f;
+        float yPos = height - bottomBarHeight + 8;
+        g.drawText(String(measurements.getPitchAt(i)), juce::Rectangle<float>(x, yPos, textWidth, bottomBarHeight - 10), Justification::centred);
+
+        // the line for the reference pitch will be drawn later
+        if (measurements.getPitchAt(i) == referencePitch)
+            continue;
+
+        // also draw dim vertical lines for the larger divisions
+        if (pitchTextInterval >= 2)
+        {
+            g.setColour(ModernLookAndFeel::Colors::accentAlt.withAlpha(0.05f));
+            g.fillRect(Rectangle<float>(xLeft, chartTop, float(columnWidth), (float)imageHeight));
+        }
+    }
+
+    // Draw a highlight for the reference pitch (if included in the measurements)
+    if (measurements.getPitchAt(0) < referencePitch &&
+        measurements.getPitchAt(measurements.size() - 1) > referencePitch)
+    {
+        int i = measurements.indexOf(referencePitch);
+        if (i >= layout.firstColumn && i < layout.firstColumn + layout.numColumns)
+        {
+            float xLeft = sidebarWidth + (i - layout.firstColumn) * float(columnWidth);
+            g.setColour(ModernLookAndFeel::Colors::accentAlt.withAlpha(0.15f));
+            g.fillRect(Rectangle<float>(xLeft, chartTop, float(columnWidth), (float)imageHeight));
+
+            // Draw reference label
+            g.setColour(ModernLookAndFeel::Colors::accentAlt);
+            g.setFont(Font(10.0f, Font::bold));
+            g.drawText("REF", xLeft, height - bottomBarHeight + 22, float(columnWidth), 12, Justification::centred);
+        }
+    }
+}
+
+Rectangle<int> ChartPainter::getColumnArea(const ChartLayout& layout, Range<int> columns) const
+{
+    // a combined column covers all columns of its bucket
+    if (layout.level > 0)
+        columns = Range<int>((columns.getStart() >> layout.level) << layout.level,
+                             (((columns.getEnd() - 1) >> layout.level) + 1) << layout.level);
+
+    // the glow of a bar reaches 2 pixels into its neighbours
+    float left = sidebarWidth + (columns.getStart() - layout.firstColumn) * (float)layout.columnWidth - 3.0f;
+    float right = sidebarWidth + (columns.getEnd() - layout.firstColumn) * (float)layout.columnWidth + 3.0f;
+    return Rectangle<float>(left, 0.0f, right - left, (float)layout.height).getSmallestIntegerContainer()
+               .withTop(topInfoHeight);
+}
+
+void ChartPainter::drawTopInfoPanel(Graphics& g, int width, int panelHeight)
+{
+    // Panel background
+    Rectangle<float> panelBounds(10, 5, width - 20, panelHeight - 10);
+    ModernLookAndFeel::drawPanel(g, panelBounds, 10.0f);
+
+    if (measurements.isEmpty())
+        return;
+
+    // Find current/latest measurement
+    const auto& current = measurements.getLatest();
+
+    // Calculate statistics
+    float maxOffset = 0, minOffset = 0, avgOffset = 0;
+    for (int i = 0; i < measurements.size(); i++)
+    {
+        float offset = (float)measurements.getAt(i).pitchOffset;
+        if (offset > maxOffset) maxOffset = offset;
+        if (offset < minOffset) minOffset = offset;
+        avgOffset += offset;
+    }
+    avgOffset /= measurements.size();
+
+    // Layout: divide into sections
+    float sectionWidth = (panelBounds.getWidth() - 40) / 4.0f;
+    float startX = panelBounds.getX() + 20;
+    float topY = panelBounds.getY() + 8;
+
+    // Section 1: Current Note & Frequency
+    g.setColour(ModernLookAndFeel::Colors::textDim);
+    g.setFont(Font(10.0f));
+    g.drawText("CURRENT NOTE", startX, topY, sectionWidth, 12, Justification::left);
+
+    g.setColour(ModernLookAndFeel::Colors::textPrimary);
+    g.setFont(Font(24.0f, Font::bold));
+    String noteName = MidiMessage::getMidiNoteName(current.midiPitch, true, true, 4);
+    g.drawText(noteName, startX, topY + 14, sectionWidth, 28, Justification::left);
+
+    g.setColour(ModernLookAndFeel::Colors::textSecondary);
+    g.setFont(Font(12.0f));
+    g.drawText(String(current.frequency, 2) + " Hz", startX, topY + 42, sectionWidth, 16, Justification::left);
+
+    // Section 2: Current Error (cents)
+    startX += sectionWidth;
+    g.setColour(ModernLookAndFeel::Colors::textDim);
+    g.setFont(Font(10.0f));
+    g.drawText("PITCH ERROR", startX, topY, sectionWidth, 12, Justification::left);
+
+    float currentCents = (float)(current.pitchOffset * 100.0);
+    Colour errorColor;
+    if (std::abs(currentCents) < 5.0f)
+        errorColor = ModernLookAndFeel::Colors::meter;
+    else if (std::abs(currentCents) < 15.0f)
+        errorColor = ModernLookAndFeel::Colors::meterWarn;
+    else
+        errorColor = ModernLookAndFeel::Colors::meterBad;
+
+    g.setColour(errorColor);
+    g.setFont(Font(24.0f, Font::bold));
+    String errorStr = (currentCents >= 0 ? "+" : "") + String(currentCents, 1) + "c";
+    g.drawText(errorStr, startX, topY + 14, sectionWidth, 28, Justification::left);
+
+    // Mini tuning meter
+    Rectangle<float> meterBounds(startX, topY + 46, sectionWidth - 20, 12);
+    ModernLookAndFeel::drawMeter(g, meterBounds, currentCents, -50.0f, 50.0f);
+
+    // Section 3: Statistics
+    startX += sectionWidth;
+    g.setColour(ModernLookAndFeel::Colors::textDim);
+    g.setFont(Font(10.0f));
+    g.drawText("STATISTICS", startX, topY, sectionWidth, 12, Justification::left);
+
+    g.setColour(ModernLookAndFeel::Colors::textSecondary);
+    g.setFont(Font(11.0f));
+    g.drawText("Max: " + String(maxOffset * 100, 1) + "c", startX, topY + 16, sectionWidth, 14, Justification::left);
+    g.drawText("Min: " + String(minOffset * 100, 1) + "c", startX, topY + 30, sectionWidth, 14, Justification::left);
+    g.drawText("Avg: " + String(avgOffset * 100, 1) + "c", startX, topY + 44, sectionWidth, 14, Justification::left);
+
+    // Section 4: Progress
+    startX += sectionWidth;
+    g.setColour(ModernLookAndFeel::Colors::textDim);
+    g.setFont(Font(10.0f));
+    g.drawText("PROGRESS", startX, topY, sectionWidth, 12, Justification::left);
+
+    g.setColour(ModernLookAndFeel::Colors::textPrimary);
+    g.setFont(Font(18.0f, Font::bold));
+    g.drawText(String(measurements.size()) + " pts", startX, topY + 14, sectionWidth, 24, Justification::left);
+
+    g.setColour(ModernLookAndFeel::Colors::textSecondary);
+    g.setFont(Font(11.0f));
+    g.drawText("Range: " + String(measurements.getAt(0).midiPitch) + "-" + String(measurements.getPitchAt(measurements.size() - 1)),
+               startX, topY + 42, sectionWidth, 14, Justification::left);
+}
+
+void ChartPainter::measurementChanged(int column)
+{
+    if (pyramid.size() == measurements.size() && pyramidVersion == measurements.getVersion() - 1)
+    {
+        setPyramidValue(column);
+        pyramidVersion = measurements.getVersion();
+    }
+}
+
+void ChartPainter::updatePyramid()
+{
+    if (pyramidVersion == measurements.getVersion())
+        return;
+
+    pyramid.reset(measurements.size());
+    for (int i = 0; i < measurements.size(); i++)
+        setPyramidValue(i);
+    pyramidVersion = measurements.getVersion();
+}
+
+void ChartPainter::setPyramidValue(int column)
+{
+    const auto& m = measurements.getAt(column);
+    pyramid.set(column, m.pitchOffset, m.pitchOffset - m.pitchDeviation, m.pitchOffset + m.pitchDeviation);
+}
+
+float ChartPainter::yFlip(float y)
+{
+    return heightForFlipping - y;
+}
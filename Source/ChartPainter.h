@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    ChartPainter.h
+    Draws the pitch offset chart of a set of measurements
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Measurement/MeasurementStore.h"
+#include "Measurement/DecimationPyramid.h"
+
+// The drawing code of the chart, separate from the Visualizer component so
+// a report can draw a snapshot of the measurements on a background thread.
+// It only reads the store it was given; whoever owns the painter makes sure
+// the store doesn't change while drawing.
+class ChartPainter
+{
+public:
+    static constexpr int bottomBarHeight = 35;
+    static constexpr int topInfoHeight = 70;
+    static constexpr float sidebarWidth = 60.0f;  // Y-axis labels width
+    static constexpr double allowedPitchOffset = 0.02; // 2 cents allowed (tight)
+
+    // Positions and scaling of the chart for one size and display range
+    struct ChartLayout
+    {
+        int width = 0;
+        int height = 0;
+        int imageHeight = 0;
+        int firstColumn = 0; // the visible range of measurements
+        int numColumns = 0;
+        int level = 0; // of the decimation pyramid, 0 draws every measurement
+        float chartTop = 0.0f;
+        float heightForFlipping = 0.0f;
+        double columnWidth = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+        double vertScaling = 0.0;
+    };
+
+    explicit ChartPainter(const MeasurementStore& store) : measurements(store) {}
+
+    // The column of this note is highlighted
+    void setReferencePitch(int pitch) { referencePitch = pitch; }
+
+    // Info panel and the complete chart of all measurements
+    void paintWithFixedScaling(Graphics& g, int width, int height, double min, double max);
+
+    // Display range that fits all measurements, recomputed only when they change
+    Range<double> getAutoRange();
+
+    bool computeLayout(ChartLayout& layout, int width, int height, double min, double max, Range<int> columns);
+    // Background, in-tune zone, grid and axis labels
+    void drawChartBackground(Graphics& g, const ChartLayout& layout);
+    // The bars of the given measurements, as far as they are visible
+    void drawColumns(Graphics& g, const ChartLayout& layout, Range<int> columns);
+    // Note names, division and reference pitch highlights, drawn on top of the bars
+    void drawNoteLabels(Graphics& g, const ChartLayout& layout);
+    void drawTopInfoPanel(Graphics& g, int width, int panelHeight);
+    Rectangle<int> getColumnArea(const ChartLayout& layout, Range<int> columns) const;
+
+    // Updates the levels of detail after a single measurement was replaced
+    void measurementChanged(int column);
+
+private:
+    // The bar of the measurement at the given index
+    void drawColumn(Graphics& g, const ChartLayout& layout, int index);
+    // A bucket of combined measurements when they are narrower than a pixel
+    void drawBucket(Graphics& g, const ChartLayout& layout, int bucketIndex);
+
+    // Min/max/mean of the measurements at all levels of detail
+    void updatePyramid();
+    void setPyramidValue(int column);
+
+    float yFlip(float y);
+
+    const MeasurementStore& measurements;
+    int referencePitch = -1;
+
+    Range<double> autoRange;
+    int64 autoRangeVersion = -1;
+
+    DecimationPyramid pyramid;
+    int64 pyramidVersion = -1;
+
+    float heightForFlipping = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChartPainter)
+};
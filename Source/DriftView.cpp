@@ -0,0 +1,194 @@
+/*
+  ==============================================================================
+
+    DriftView.cpp
+    Plot of a drift log over its whole duration
+
+  ==============================================================================
+*/
+
+#include "DriftView.h"
+#include <cmath>
+
+namespace
+{
+    double toCents(double frequency, double reference)
+    {
+        return 1200.0 * std::log2(frequency / reference);
+    }
+
+    String formatDuration(double seconds)
+    {
+        if (seconds < 120.0)
+            return String(seconds, 0) + " s";
+        if (seconds < 7200.0)
+            return String(seconds / 60.0, 1) + " min";
+        return String(seconds / 3600.0, 1) + " h";
+    }
+}
+
+DriftView::DriftView(const VCOTuner& t) : tuner(t)
+{
+    startTimerHz(4);
+}
+
+DriftView::~DriftView()
+{
+    stopTimer();
+}
+
+void DriftView::timerCallback()
+{
+    const int64 numEntries = tuner.getDriftLogger().getTotalNumEntries();
+    if (numEntries != numEntriesShown && isShowing())
+    {
+        numEntriesShown = numEntries;
+        updateSeries();
+        updateScheduler.requestRepaint();
+    }
+}
+
+void DriftView::updateSeries()
+{
+    // Raw entries while they cover the whole log, the finest complete tier after that
+    const DriftLogger& logger = tuner.getDriftLogger();
+    tierShown = logger.getFinestCompleteTier();
+    std::vector<DriftLogger::Bucket> series;
+    if (tierShown < 0)
+    {
+        for (const auto& entry : logger.getRecentEntries())
+        {
+            DriftLogger::Bucket bucket;
+            bucket.startSeconds = bucket.endSeconds = entry.seconds;
+            bucket.minimum = bucket.maximum = bucket.mean = entry.frequency;
+            bucket.count = 1;
+            series.push_back(bucket);
+        }
+    }
+    else
+        series = logger.getTier(tierShown);
+
+    const int numValues = static_cast<int>(series.size());
+    pyramid.reset(numValues);
+    startSeconds.resize(series.size());
+    endSeconds.resize(series.size());
+    if (numValues == 0)
+        return;
+
+    const double reference = series.front().mean;
+    for (int i = 0; i < numValues; ++i)
+    {
+        const auto& bucket = series[static_cast<size_t>(i)];
+        pyramid.set(i, toCents(bucket.mean, reference), toCents(bucket.minimum, reference), toCents(bucket.maximum, reference));
+        startSeconds[static_cast<size_t>(i)] = bucket.startSeconds;
+        endSeconds[static_cast<size_t>(i)] = bucket.endSeconds;
+    }
+}
+
+void DriftView::paint(Graphics& g)
+{
+    g.fillAll(ModernLookAndFeel::Colors::background);
+
+    auto panelBounds = getLocalBounds().toFloat().reduced(15);
+    ModernLookAndFeel::drawPanel(g, panelBounds, 12.0f);
+    auto contentBounds = panelBounds.reduced(20);
+
+    auto headerArea = contentBounds.removeFromTop(30);
+    g.setColour(ModernLookAndFeel::Colors::textSecondary);
+    g.setFont(Font(12.0f));
+    g.drawText(tuner.getDriftLogger().isLogging() ? "LOGGING" : "DRIFT LOG", headerArea, Justification::centredLeft);
+
+    const int numValues = pyramid.size();
+    if (numValues < 2)
+    {
+        g.setColour(ModernLookAndFeel::Colors::textDim);
+        g.setFont(Font(14.0f));
+        g.drawText("Start a drift log to see the frequency over time.", contentBounds, Justification::centred);
+        return;
+    }
+
+    const double firstSeconds = startSeconds.front();
+    const double duration = jmax(1.0e-3, endSeconds.back() - firstSeconds);
+
+    // The top of the pyramid spans the whole series
+    const auto& all = pyramid.getBucket(pyramid.getNumLevels() - 1, 0);
+    double minCents = jmin(0.0, all.minimum);
+    double maxCents = jmax(0.0, all.maximum);
+    const double margin = jmax(0.5, (maxCents - minCents) * 0.1);
+    minCents -= margin;
+    maxCents += margin;
+
+    g.drawText(formatDuration(duration) + ", " + String(maxCents - minCents - 2.0 * margin, 2) + " cents peak to peak",
+               headerArea, Justification::centredRight);
+
+    auto plotArea = contentBounds.withTrimmedLeft(50.0f).withTrimmedBottom(20.0f);
+    drawGrid(g, plotArea, duration, minCents, maxCents);
+
+    auto xFor = [&] (double seconds)
+    {
+        return plotArea.getX() + static_cast<float>((seconds - firstSeconds) / duration) * plotArea.getWidth();
+    };
+    auto yFor = [&] (double cents)
+    {
+        return plotArea.getBottom() - static_cast<float>((cents - minCents) / (maxCents - minCents)) * plotArea.getHeight();
+    };
+
+    // At most one bucket per pixel, placed at the middle of the time it covers
+    const int level = pyramid.getLevelFor(numValues / jmax(1.0, static_cast<double>(plotArea.getWidth())));
+    const int numBuckets = pyramid.getNumBuckets(level);
+    auto xForBucket = [&] (int index)
+    {
+        const auto range = DecimationPyramid::getValueRange(level, index);
+        const int last = jmin(range.getEnd(), numValues) - 1;
+        return xFor(0.5 * (startSeconds[static_cast<size_t>(range.getStart())] + endSeconds[static_cast<size_t>(last)]));
+    };
+
+    // min/max band, along the maxima and back along the minima
+    Path band;
+    Path meanLine;
+    for (int i = 0; i < numBuckets; ++i)
+    {
+        const auto& bucket = pyramid.getBucket(level, i);
+        const float x = xForBucket(i);
+        if (i == 0)
+        {
+            band.startNewSubPath(x, yFor(bucket.maximum));
+            meanLine.startNewSubPath(x, yFor(bucket.mean));
+        }
+        else
+        {
+            band.lineTo(x, yFor(bucket.maximum));
+            meanLine.lineTo(x, yFor(bucket.mean));
+        }
+    }
+    for (int i = numBuckets; i-- > 0;)
+        band.lineTo(xForBucket(i), yFor(pyramid.getBucket(level, i).minimum));
+    band.closeSubPath();
+
+    // Raw entries only have a band once several of them share a bucket
+    if (tierShown >= 0 || level > 0)
+    {
+        g.setColour(ModernLookAndFeel::Colors::accent.withAlpha(0.25f));
+        g.fillPath(band);
+    }
+    g.setColour(ModernLookAndFeel::Colors::accent);
+    g.strokePath(meanLine, PathStrokeType(1.5f));
+}
+
+void DriftView::drawGrid(Graphics& g, Rectangle<float> area, double seconds, double minCents, double maxCents)
+{
+    g.setFont(Font(11.0f));
+    const int numLines = 4;
+    for (int i = 0; i <= numLines; ++i)
+    {
+        const float y = area.getBottom() - area.getHeight() * i / numLines;
+        const double cents = minCents + (maxCents - minCents) * i / numLines;
+        g.setColour(ModernLookAndFeel::Colors::panelLight);
+        g.drawHorizontalLine(roundToInt(y), area.getX(), area.getRight());
+        g.setColour(ModernLookAndFeel::Colors::textDim);
+        g.drawText(String(cents, 1) + " c", roundToInt(area.getX() - 50.0f), roundToInt(y - 8.0f), 45, 16, Justification::centredRight);
+
+        const float x = area.getX() + area.getWidth() * i / numLines;
+        g.drawText(formatDuration(seconds * i / numLines), roundToInt(x - 40.0f), roundToInt(area.getBottom() + 2.0f), 80, 16, Justification::centred);
+    }
+}
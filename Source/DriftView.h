@@ -0,0 +1,51 @@
+/*
+  ==============================================================================
+
+    DriftView.h
+    Plot of a drift log over its whole duration
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "VCOTuner.h"
+#include "Measurement/DecimationPyramid.h"
+#include "ModernLookAndFeel.h"
+#include "UpdateScheduler.h"
+
+// Shows the frequency of the running or last drift log in cents against
+// time. Short logs are drawn from the raw entries; once those no longer
+// reach back to the start, the finest complete min/max/mean tier of the
+// DriftLogger is drawn as a band with its mean line. Either series goes
+// into a DecimationPyramid, so a repaint draws at most one bucket per pixel
+// no matter how many thousand entries the log holds.
+class DriftView : public Component,
+                  private Timer
+{
+public:
+    explicit DriftView(const VCOTuner& tuner);
+    ~DriftView() override;
+
+    void paint(Graphics& g) override;
+
+private:
+    void timerCallback() override;
+    void updateSeries();
+    void drawGrid(Graphics& g, Rectangle<float> area, double seconds, double minCents, double maxCents);
+
+    const VCOTuner& tuner;
+    int64 numEntriesShown = -1;
+
+    // Cents relative to the first value of the series, rebuilt when the log grows
+    DecimationPyramid pyramid;
+    std::vector<double> startSeconds;   // of every value in the pyramid
+    std::vector<double> endSeconds;
+    int tierShown = -1;                 // -1 for the raw entries
+
+    // The logger has no listener, new entries arrive a few times per second at most
+    UpdateScheduler updateScheduler { *this };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DriftView)
+};
@@ -0,0 +1,244 @@
+/*
+  ==============================================================================
+
+    BatchExporter.cpp
+    Parallel export of many stored calibration tables
+
+  ==============================================================================
+*/
+
+#include "BatchExporter.h"
+#include "CSVExporter.h"
+#include "FirmwareExporter.h"
+#include "JSONExporter.h"
+#include "OrnamentCrimeExporter.h"
+#include "../ReportRenderer.h"
+#include <atomic>
+
+namespace
+{
+    const BatchExporter::Format everyFormat[] = { BatchExporter::csv, BatchExporter::json,
+                                                  BatchExporter::ocHeader, BatchExporter::ocReadable,
+                                                  BatchExporter::firmware, BatchExporter::reportPNG,
+                                                  BatchExporter::reportEPS };
+
+    int countFormats(int formats)
+    {
+        int count = 0;
+        for (auto format : everyFormat)
+            if ((formats & format) != 0)
+                count++;
+        return count;
+    }
+
+    bool writeFormat(const CalibrationTable& table, BatchExporter::Format format, const File& file,
+                     const FirmwareProfile& profile)
+    {
+        switch (format)
+        {
+            case BatchExporter::csv:        return CSVExporter::exportCalibration(table, file);
+            case BatchExporter::json:       return JSONExporter::exportCalibration(table, file);
+            case BatchExporter::ocHeader:   return OrnamentCrimeExporter::exportAsCHeader(table, file);
+            case BatchExporter::ocReadable: return OrnamentCrimeExporter::exportAsReadable(table, file);
+            case BatchExporter::firmware:   return FirmwareExporter::exportCalibration(table, profile, file);
+            case BatchExporter::reportPNG:
+            case BatchExporter::reportEPS:
+                // the file extension picks image or vector output
+                return ReportRenderer::writeToFile(ReportRenderer::createFromCalibration(table), file,
+                                                   ReportRenderer::exportScale).isEmpty();
+        }
+        return false;
+    }
+}
+
+//==============================================================================
+// Loads one table and writes all requested formats of it
+class BatchExporter::ExportJob : public ThreadPoolJob
+{
+public:
+    ExportJob(const BatchExporter& e, const File& file)
+        : ThreadPoolJob("Export " + file.getFileName()), exporter(e), calibrationFile(file)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        CalibrationTable table;
+        if (!table.loadFromFile(calibrationFile))
+        {
+            errors.add(calibrationFile.getFileName() + ": not a calibration table");
+            numDone = countFormats(exporter.formats);
+        }
+        else
+        {
+            for (auto format : everyFormat)
+            {
+                if ((exporter.formats & format) == 0)
+                    continue;
+                if (shouldExit())
+                    break;
+
+                const File outputFile = exporter.getOutputFile(calibrationFile, format);
+                if (writeFormat(table, format, outputFile, exporter.firmwareProfile))
+                    numWritten++;
+                else
+                    errors.add(outputFile.getFileName() + ": could not be written");
+                numDone++;
+            }
+        }
+
+        finished = true;
+        return jobHasFinished;
+    }
+
+    int getNumDone() const { return numDone.load(); }
+    bool isFinished() const { return finished.load(); }
+
+    // Only valid once isFinished() returns true
+    int getNumWritten() const { return numWritten; }
+    const StringArray& getErrors() const { return errors; }
+
+private:
+    const BatchExporter& exporter;
+    const File calibrationFile;
+
+    std::atomic<int> numDone { 0 };
+    std::atomic<bool> finished { false };
+    int numWritten = 0;
+    StringArray errors;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ExportJob)
+};
+
+//==============================================================================
+BatchExporter::BatchExporter(const Array<File>& files, const File& directory, int f, const FirmwareProfile& profile)
+    : calibrationFiles(files), outputDirectory(directory), formats(f & (allFormats | firmware | reportPNG | reportEPS)), firmwareProfile(profile)
+{
+    // firmware tables need a usable profile
+    jassert((formats & firmware) == 0 || firmwareProfile.validate().isEmpty());
+}
+
+BatchExporter::Result BatchExporter::run(ThreadPool& pool, std::function<bool(double)> progressCallback) const
+{
+    Result result;
+    result.numExpected = calibrationFiles.size() * countFormats(formats);
+
+    if (!outputDirectory.isDirectory() && !outputDirectory.createDirectory())
+    {
+        result.errors.add("Can't create " + outputDirectory.getFullPathName());
+        return result;
+    }
+
+    OwnedArray<ExportJob> jobs;
+    for (const auto& file : calibrationFiles)
+        pool.addJob(jobs.add(new ExportJob(*this, file)), false);
+
+    for (;;)
+    {
+        int numDone = 0;
+        bool allFinished = true;
+        for (auto* job : jobs)
+        {
+            numDone += job->getNumDone();
+            allFinished = allFinished && job->isFinished();
+        }
+
+        if (allFinished)
+            break;
+
+        const double progress = result.numExpected > 0 ? numDone / static_cast<double>(result.numExpected) : 1.0;
+        if (progressCallback != nullptr && !progressCallback(progress))
+        {
+            result.cancelled = true;
+            break;
+        }
+
+        Thread::sleep(50);
+    }
+
+    // Jobs that haven't started are dropped, running ones finish their current file.
+    // Only these jobs are removed, the pool may be shared.
+    for (auto* job : jobs)
+        pool.removeJob(job, true, -1);
+
+    for (auto* job : jobs)
+    {
+        if (!job->isFinished())
+            continue;
+
+        result.numWritten += job->getNumWritten();
+        result.errors.addArray(job->getErrors());
+    }
+
+    return result;
+}
+
+File BatchExporter::getOutputFile(const File& calibrationFile, Format format) const
+{
+    const String name = calibrationFile.getFileNameWithoutExtension();
+    switch (format)
+    {
+        case csv:        return outputDirectory.getChildFile(name + ".csv");
+        case json:       return outputDirectory.getChildFile(name + "-export.json");   // the tables are .json files themselves
+        case ocHeader:   return outputDirectory.getChildFile(name + ".h");
+        case ocReadable: return outputDirectory.getChildFile(name + "-oc.txt");
+        case firmware:   return outputDirectory.getChildFile(name + "-" + File::createLegalFileName(firmwareProfile.name).replaceCharacter(' ', '-')
+                                                             + "." + firmwareProfile.fileExtension);
+        case reportPNG:  return outputDirectory.getChildFile(name + ".png");
+        case reportEPS:  return outputDirectory.getChildFile(name + ".eps");
+    }
+    return File();
+}
+
+String BatchExporter::getFormatName(Format format)
+{
+    switch (format)
+    {
+        case csv:        return "CSV tables";
+        case json:       return "JSON files";
+        case ocHeader:   return "o_C firmware headers";
+        case ocReadable: return "o_C readable values";
+        case firmware:   return "Firmware tables";
+        case reportPNG:  return "Reports as PNG images";
+        case reportEPS:  return "Reports as EPS vector files";
+    }
+    return String();
+}
+
+//==============================================================================
+BatchExport::BatchExport(const Array<File>& files, const File& directory, int formats, const FirmwareProfile& profile)
+    : ThreadWithProgressWindow("Exporting calibrations...", true, true),
+      exporter(files, directory, formats, profile), outputDirectory(directory)
+{
+}
+
+void BatchExport::run()
+{
+    ThreadPool pool(jmax(1, SystemStats::getNumCpus()));
+    result = exporter.run(pool, [this] (double progress)
+    {
+        setProgress(progress);
+        return !threadShouldExit();
+    });
+}
+
+void BatchExport::threadComplete(bool userPressedCancel)
+{
+    String message = String(result.numWritten) + " of " + String(result.numExpected)
+                   + " files written to " + outputDirectory.getFullPathName();
+    if (userPressedCancel || result.cancelled)
+        message = "Cancelled. " + message;
+
+    // don't let hundreds of failures overflow the message box
+    const int maxNumErrorsShown = 20;
+    if (result.errors.size() > 0)
+    {
+        message += "\n\n" + result.errors.joinIntoString("\n", 0, maxNumErrorsShown);
+        if (result.errors.size() > maxNumErrorsShown)
+            message += "\n(" + String(result.errors.size() - maxNumErrorsShown) + " more)";
+    }
+
+    NativeMessageBox::showMessageBoxAsync(result.errors.isEmpty() ? AlertWindow::InfoIcon : AlertWindow::WarningIcon,
+                                          "Batch Export", message);
+    delete this;
+}
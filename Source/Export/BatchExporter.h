@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    BatchExporter.h
+    Parallel export of many stored calibration tables
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FirmwareProfile.h"
+#include <functional>
+
+// Converts a set of stored calibration tables (CalibrationTable::saveToFile)
+// into any combination of export formats, including rendered reports. Every table is loaded and written
+// by its own ThreadPool job; the caller gets progress and, at the end, the
+// number of files written and one error message per failed output.
+class BatchExporter
+{
+public:
+    // Combine as flags
+    enum Format
+    {
+        csv         = 1 << 0,
+        json        = 1 << 1,
+        ocHeader    = 1 << 2,
+        ocReadable  = 1 << 3,
+        firmware    = 1 << 4,   // table of the FirmwareProfile given to the constructor
+        reportPNG   = 1 << 5,   // ReportRenderer output
+        reportEPS   = 1 << 6
+    };
+
+    // All data formats, the reports are chosen separately
+    static const int allFormats = csv | json | ocHeader | ocReadable;
+
+    struct Result
+    {
+        int numWritten = 0;
+        int numExpected = 0;
+        bool cancelled = false;
+        StringArray errors;
+    };
+
+    BatchExporter(const Array<File>& calibrationFiles, const File& outputDirectory, int formats,
+                  const FirmwareProfile& firmwareProfile = FirmwareProfile());
+
+    // Runs all conversions on the pool and returns once they have finished.
+    // progressCallback is called on the calling thread about every 50 ms with
+    // the fraction done; returning false cancels the jobs that haven't started.
+    Result run(ThreadPool& pool, std::function<bool(double)> progressCallback = nullptr) const;
+
+    // Where the output of one format for a table goes. The name is derived
+    // from the table's file name and never is the table file itself.
+    File getOutputFile(const File& calibrationFile, Format format) const;
+
+    static String getFormatName(Format format);
+
+private:
+    class ExportJob;
+
+    const Array<File> calibrationFiles;
+    const File outputDirectory;
+    const int formats;
+    const FirmwareProfile firmwareProfile;
+};
+
+// Runs a BatchExporter while a progress window is shown and reports the
+// result. Launch it with launchThread(); it deletes itself when finished.
+class BatchExport : public ThreadWithProgressWindow
+{
+public:
+    BatchExport(const Array<File>& calibrationFiles, const File& outputDirectory, int formats,
+                const FirmwareProfile& firmwareProfile = FirmwareProfile());
+
+    void run() override;
+    void threadComplete(bool userPressedCancel) override;
+
+private:
+    const BatchExporter exporter;
+    const File outputDirectory;
+    BatchExporter::Result result;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BatchExport)
+};
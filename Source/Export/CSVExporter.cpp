@@ -8,59 +8,77 @@
 */
 
 #include "CSVExporter.h"
+#include "CSVWriter.h"
 
 bool CSVExporter::exportCalibration(const CalibrationTable& table,
                                     const File& outputFile,
                                     bool includeHeader)
 {
-    String csv = generateCSVString(table, includeHeader);
-    return outputFile.replaceWithText(csv);
+    // written next to the target and moved over it, like File::replaceWithText()
+    TemporaryFile tempFile(outputFile);
+    {
+        FileOutputStream stream(tempFile.getFile());
+        if (stream.failedToOpen())
+            return false;
+
+        writeCSV(table, stream, includeHeader);
+        stream.flush();
+        if (stream.getStatus().failed())
+            return false;
+    }
+    return tempFile.overwriteTargetFileWithTemporary();
 }
 
 String CSVExporter::generateCSVString(const CalibrationTable& table, bool includeHeader)
 {
-    String csv;
+    MemoryOutputStream stream;
+    writeCSV(table, stream, includeHeader);
+    return stream.toUTF8();
+}
+
+void CSVExporter::writeCSV(const CalibrationTable& table, OutputStream& stream, bool includeHeader)
+{
+    CSVWriter csv(stream);
 
     // Metadata comments
-    csv += "# VCOTuner Calibration Export\n";
-    csv += "# Device: " + table.getDeviceName() + " (" + table.getDeviceBrand() + ")\n";
-    csv += "# Interface: " + table.getInterfaceName() + "\n";
-    csv += "# Standard: " + table.getVoltageStandard() + "\n";
-    csv += "# Date: " + table.getCalibrationDate().toString(true, true) + "\n";
+    csv.writeComment("VCOTuner Calibration Export");
+    csv.writeComment("Device: " + table.getDeviceName() + " (" + table.getDeviceBrand() + ")");
+    csv.writeComment("Interface: " + table.getInterfaceName());
+    csv.writeComment("Standard: " + table.getVoltageStandard());
+    csv.writeComment("Date: " + table.getCalibrationDate().toString(true, true));
 
     if (table.getNotes().isNotEmpty())
-        csv += "# Notes: " + table.getNotes() + "\n";
+        csv.writeComment("Notes: " + table.getNotes());
 
-    csv += "#\n";
+    csv.writeComment("");
 
     // Statistics
-    csv += "# Statistics:\n";
-    csv += "#   Max Error: " + String(table.getMaxErrorCents(), 2) + " cents\n";
-    csv += "#   Min Error: " + String(table.getMinErrorCents(), 2) + " cents\n";
-    csv += "#   Avg Error: " + String(table.getAverageErrorCents(), 2) + " cents\n";
-    csv += "#   RMS Error: " + String(table.getRMSErrorCents(), 2) + " cents\n";
+    csv.writeComment("Statistics:");
+    csv.writeComment("  Max Error: " + String(table.getMaxErrorCents(), 2) + " cents");
+    csv.writeComment("  Min Error: " + String(table.getMinErrorCents(), 2) + " cents");
+    csv.writeComment("  Avg Error: " + String(table.getAverageErrorCents(), 2) + " cents");
+    csv.writeComment("  RMS Error: " + String(table.getRMSErrorCents(), 2) + " cents");
     auto worst = table.getWorstNote();
-    csv += "#   Worst Note: MIDI " + String(worst.first) + " (" + String(worst.second, 2) + " cents)\n";
-    csv += "#\n";
+    csv.writeComment("  Worst Note: MIDI " + String(worst.first) + " (" + String(worst.second, 2) + " cents)");
+    csv.writeComment("");
 
     // Header
     if (includeHeader)
     {
-        csv += "MIDINote,IdealVoltage,ActualVoltage,CorrectionOffset,MeasuredFrequency,ErrorCents,StdDevCents\n";
+        csv.writeHeader({ "MIDINote", "IdealVoltage", "ActualVoltage", "CorrectionOffset",
+                          "MeasuredFrequency", "ErrorCents", "StdDevCents" });
     }
 
     // Data
-    for (int i = 0; i < table.getEntryCount(); ++i)
+    for (const auto& entry : table.getAllEntries())
     {
-        const auto& entry = table.getEntry(i);
-        csv += String(entry.midiNote) + ",";
-        csv += String(entry.idealVoltage, 4) + ",";
-        csv += String(entry.actualVoltage, 4) + ",";
-        csv += String(entry.correctionOffset, 4) + ",";
-        csv += String(entry.measuredFrequency, 2) + ",";
-        csv += String(entry.errorCents, 2) + ",";
-        csv += String(entry.stdDevCents, 2) + "\n";
+        csv.add(entry.midiNote)
+           .add(entry.idealVoltage, 4)
+           .add(entry.actualVoltage, 4)
+           .add(entry.correctionOffset, 4)
+           .add(entry.measuredFrequency, 2)
+           .add(entry.errorCents, 2)
+           .add(entry.stdDevCents, 2)
+           .endRow();
     }
-
-    return csv;
 }
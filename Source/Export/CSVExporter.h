@@ -21,4 +21,8 @@ public:
 
     static String generateCSVString(const CalibrationTable& table,
                                     bool includeHeader = true);
+
+    // Streams the rows without building the document in memory first
+    static void writeCSV(const CalibrationTable& table, OutputStream& stream,
+                         bool includeHeader = true);
 };
@@ -0,0 +1,198 @@
+/*
+  ==============================================================================
+
+    CSVWriter.cpp
+    Row by row CSV output to a file or stream
+
+  ==============================================================================
+*/
+
+#include "CSVWriter.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+CSVWriter::CSVWriter()
+{
+    row.reserve(256);
+}
+
+CSVWriter::CSVWriter(OutputStream& stream)
+    : output(&stream)
+{
+    row.reserve(256);
+}
+
+CSVWriter::~CSVWriter()
+{
+    close();
+}
+
+bool CSVWriter::open(const File& file, Mode mode)
+{
+    close();
+
+    if (mode == Mode::replace && file.existsAsFile() && !file.deleteFile())
+        return false;
+
+    // FileOutputStream appends to an existing file
+    fileStream = std::make_unique<FileOutputStream>(file);
+    if (fileStream->failedToOpen())
+    {
+        fileStream.reset();
+        return false;
+    }
+
+    output = fileStream.get();
+    continuing = fileStream->getPosition() > 0;
+    writeFailed = false;
+    return true;
+}
+
+void CSVWriter::close()
+{
+    if (numFieldsInRow > 0)
+        endRow();
+
+    flush();
+    fileStream.reset();
+    output = nullptr;
+    continuing = false;
+}
+
+void CSVWriter::writeComment(StringRef text)
+{
+    jassert(numFieldsInRow == 0);
+
+    row.push_back('#');
+    if (text.isNotEmpty())
+    {
+        row.push_back(' ');
+        appendText(text.text.getAddress(), std::strlen(text.text.getAddress()));
+    }
+    writeRow();
+}
+
+void CSVWriter::writeHeader(std::initializer_list<const char*> columnNames)
+{
+    for (const char* name : columnNames)
+        add(StringRef(name));
+    endRow();
+}
+
+CSVWriter& CSVWriter::add(int value)
+{
+    return add(static_cast<int64>(value));
+}
+
+CSVWriter& CSVWriter::add(int64 value)
+{
+    beginField();
+    char digits[24];
+    const int length = std::snprintf(digits, sizeof(digits), "%lld", static_cast<long long>(value));
+    appendText(digits, static_cast<size_t>(length));
+    return *this;
+}
+
+CSVWriter& CSVWriter::add(double value, int numDecimals)
+{
+    beginField();
+    appendFixed(value, numDecimals);
+    return *this;
+}
+
+CSVWriter& CSVWriter::add(StringRef text)
+{
+    beginField();
+
+    const char* chars = text.text.getAddress();
+    const size_t length = std::strlen(chars);
+    if (std::strpbrk(chars, ",\"\r\n") == nullptr)
+    {
+        appendText(chars, length);
+        return *this;
+    }
+
+    row.push_back('"');
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (chars[i] == '"')
+            row.push_back('"');
+        row.push_back(chars[i]);
+    }
+    row.push_back('"');
+    return *this;
+}
+
+void CSVWriter::endRow()
+{
+    writeRow();
+}
+
+void CSVWriter::flush()
+{
+    if (output != nullptr)
+        output->flush();
+
+    if (fileStream != nullptr && fileStream->getStatus().failed())
+        writeFailed = true;
+}
+
+void CSVWriter::beginField()
+{
+    if (numFieldsInRow++ > 0)
+        row.push_back(',');
+}
+
+void CSVWriter::appendText(const char* text, size_t length)
+{
+    row.insert(row.end(), text, text + length);
+}
+
+void CSVWriter::appendFixed(double value, int numDecimals)
+{
+    static const double powersOfTen[] = { 1.0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+    numDecimals = jlimit(0, 9, numDecimals);
+
+    // integer arithmetic covers everything a measurement produces, the rest goes the slow way
+    const double scaled = std::abs(value) * powersOfTen[numDecimals];
+    if (!(scaled < 9.0e15))
+    {
+        char text[352];
+        const int length = std::snprintf(text, sizeof(text), "%.*f", numDecimals, value);
+        appendText(text, static_cast<size_t>(jlimit(0, static_cast<int>(sizeof(text)) - 1, length)));
+        return;
+    }
+
+    auto units = static_cast<uint64>(scaled + 0.5);
+    if (value < 0.0 && units != 0)
+        row.push_back('-');
+
+    // least significant digit first, with at least one digit before the point
+    char digits[24];
+    int numDigits = 0;
+    do
+    {
+        digits[numDigits++] = static_cast<char>('0' + units % 10);
+        units /= 10;
+    }
+    while (units != 0 || numDigits <= numDecimals);
+
+    for (int i = numDigits - 1; i >= 0; --i)
+    {
+        row.push_back(digits[i]);
+        if (i == numDecimals && numDecimals > 0)
+            row.push_back('.');
+    }
+}
+
+void CSVWriter::writeRow()
+{
+    row.push_back('\n');
+
+    if (output != nullptr && !output->write(row.data(), row.size()))
+        writeFailed = true;
+
+    row.clear();
+    numFieldsInRow = 0;
+}
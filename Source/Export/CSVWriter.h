@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    CSVWriter.h
+    Row by row CSV output to a file or stream
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <initializer_list>
+#include <vector>
+
+// Streams CSV rows to a file or any OutputStream. Every row is formatted
+// into one buffer that is reused for all rows and written with a single
+// call, and numbers are formatted without going through String, so logs of
+// millions of rows neither allocate per value nor build up in memory.
+// Lines starting with '#' are comments.
+class CSVWriter
+{
+public:
+    enum class Mode
+    {
+        replace,    // start a new file
+        append      // add rows to the end of an existing file
+    };
+
+    CSVWriter();
+    explicit CSVWriter(OutputStream& stream);   // the stream is not owned
+    ~CSVWriter();
+
+    bool open(const File& file, Mode mode);
+    void close();
+    bool isOpen() const { return output != nullptr; }
+
+    // True if the file already held rows when it was opened for appending,
+    // i.e. its header has been written before
+    bool isContinuingFile() const { return continuing; }
+
+    void writeComment(StringRef text);
+    void writeHeader(std::initializer_list<const char*> columnNames);
+
+    // Fields of the current row, written out by endRow()
+    CSVWriter& add(int value);
+    CSVWriter& add(int64 value);
+    CSVWriter& add(double value, int numDecimals);
+    CSVWriter& add(StringRef text);     // quoted if it contains a separator, quote or line break
+    void endRow();
+
+    void flush();
+
+    // True if any write failed since the writer was opened
+    bool failed() const { return writeFailed; }
+
+private:
+    void beginField();
+    void appendText(const char* text, size_t length);
+    void appendFixed(double value, int numDecimals);
+    void writeRow();
+
+    std::unique_ptr<FileOutputStream> fileStream;
+    OutputStream* output = nullptr;
+    bool continuing = false;
+    bool writeFailed = false;
+
+    std::vector<char> row;
+    int numFieldsInRow = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CSVWriter)
+};
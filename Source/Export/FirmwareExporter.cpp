@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    FirmwareExporter.cpp
+    Export calibration data as fixed-point tables for a firmware profile
+
+  ==============================================================================
+*/
+
+#include "FirmwareExporter.h"
+#include <cmath>
+
+namespace
+{
+    String formatVoltage(float voltage)
+    {
+        // whole volts like the o_C header, fractions only where needed
+        const String number = voltage == std::round(voltage) ? String(static_cast<int>(voltage))
+                                                             : String(voltage, 3);
+        return (voltage >= 0.0f ? "+" : "") + number + "V";
+    }
+
+    String formatValues(const FirmwareExporter::Conversion& conversion, const FirmwareProfile& profile)
+    {
+        const int numDigits = (profile.dacBits + 3) / 4;
+        const int numValues = static_cast<int>(conversion.codes.size());
+
+        String values;
+        for (int i = 0; i < numValues; ++i)
+        {
+            if (i % profile.valuesPerLine == 0)
+                values += (i > 0 ? "\n    " : "    ");
+            else
+                values += " ";
+
+            const uint32_t code = conversion.codes[static_cast<size_t>(i)];
+            values += profile.hexValues ? "0x" + String::toHexString(static_cast<int64>(code)).paddedLeft('0', numDigits).toUpperCase()
+                                        : String(static_cast<int64>(code));
+            if (i < numValues - 1)
+                values += ",";
+        }
+        return values;
+    }
+}
+
+bool FirmwareExporter::exportCalibration(const CalibrationTable& table,
+                                         const FirmwareProfile& profile,
+                                         const File& outputFile,
+                                         const String& arrayName)
+{
+    String text = generateString(table, profile, arrayName);
+    return outputFile.replaceWithText(text);
+}
+
+String FirmwareExporter::generateString(const CalibrationTable& table,
+                                        const FirmwareProfile& profile,
+                                        const String& arrayName)
+{
+    const Conversion conversion = convert(table, profile);
+
+    StringArray pointVoltages;
+    for (float voltage : conversion.pointVoltages)
+        pointVoltages.add(formatVoltage(voltage));
+
+    StringPairArray fields;
+    fields.set("values", formatValues(conversion, profile));
+    fields.set("pointVoltages", pointVoltages.joinIntoString(", "));
+    fields.set("arrayName", arrayName);
+    fields.set("valueType", profile.getValueType());
+    fields.set("numPoints", String(profile.numPoints));
+    fields.set("dacBits", String(profile.dacBits));
+    fields.set("profile", profile.name);
+    fields.set("device", table.getDeviceName());
+    fields.set("brand", table.getDeviceBrand());
+    fields.set("interface", table.getInterfaceName());
+    fields.set("date", Time::getCurrentTime().toString(true, true));
+    fields.set("maxErrorCents", String(table.getMaxErrorCents(), 2));
+    fields.set("avgErrorCents", String(table.getAverageErrorCents(), 2));
+    fields.set("rmsErrorCents", String(table.getRMSErrorCents(), 2));
+    fields.set("roundingMaxCents", String(conversion.maxRoundingCents, 3));
+    fields.set("roundingRmsCents", String(conversion.rmsRoundingCents, 3));
+    fields.set("numClipped", String(conversion.numClipped));
+
+    // One pass over the template, so text inserted for a placeholder is never expanded again
+    const String& source = profile.outputTemplate;
+    String text;
+    int position = 0;
+    for (;;)
+    {
+        const int start = source.indexOf(position, "${");
+        const int end = start >= 0 ? source.indexOfChar(start, '}') : -1;
+        if (end < 0)
+            break;
+
+        const String name = source.substring(start + 2, end);
+        text += source.substring(position, start);
+        if (fields.containsKey(name))
+            text += fields[name];
+        else
+            text += source.substring(start, end + 1);   // unknown, left for the user to see
+        position = end + 1;
+    }
+    text += source.substring(position);
+
+    return text;
+}
+
+FirmwareExporter::Conversion FirmwareExporter::convert(const CalibrationTable& table, const FirmwareProfile& profile)
+{
+    Conversion conversion;
+    const size_t numPoints = static_cast<size_t>(jmax(0, profile.numPoints));
+
+    conversion.pointVoltages.resize(numPoints);
+    conversion.correctedVoltages.resize(numPoints);
+    conversion.codes.resize(numPoints);
+    conversion.roundingErrorCents.resize(numPoints);
+
+    // Convert voltage to MIDI pitch (1V/Oct, 0V = C4 = MIDI 60)
+    std::vector<float> midiPitches(numPoints);
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+        conversion.pointVoltages[i] = profile.getPointVoltage(static_cast<int>(i));
+        midiPitches[i] = 60.0f + conversion.pointVoltages[i] * 12.0f;
+    }
+
+    table.getCorrectedVoltages(midiPitches.data(), conversion.correctedVoltages.data(), profile.numPoints);
+
+    float sumSquares = 0.0f;
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+        const float corrected = conversion.correctedVoltages[i];
+        if (corrected < profile.minVoltage || corrected > profile.maxVoltage)
+            conversion.numClipped++;
+
+        conversion.codes[i] = profile.voltageToCode(corrected);
+
+        // 1V/Oct: one volt is 1200 cents
+        const float cents = (profile.codeToVoltage(conversion.codes[i]) - corrected) * 1200.0f;
+        conversion.roundingErrorCents[i] = cents;
+        conversion.maxRoundingCents = jmax(conversion.maxRoundingCents, std::abs(cents));
+        sumSquares += cents * cents;
+    }
+
+    if (numPoints > 0)
+        conversion.rmsRoundingCents = std::sqrt(sumSquares / numPoints);
+
+    return conversion;
+}
@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    FirmwareExporter.h
+    Export calibration data as fixed-point tables for a firmware profile
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../Calibration/CalibrationTable.h"
+#include "FirmwareProfile.h"
+#include <vector>
+
+// Turns a CalibrationTable into the DAC codes a FirmwareProfile asks for and
+// fills them into the profile's template. Placeholders of the template:
+//
+//     ${values}           the codes, valuesPerLine per line, indented
+//     ${pointVoltages}    the voltages of the points, e.g. -3V, -2V, ...
+//     ${arrayName} ${valueType} ${numPoints} ${dacBits}
+//     ${profile} ${device} ${brand} ${interface} ${date}
+//     ${maxErrorCents} ${avgErrorCents} ${rmsErrorCents}
+//     ${roundingMaxCents} ${roundingRmsCents} ${numClipped}
+class FirmwareExporter
+{
+public:
+    struct Conversion
+    {
+        std::vector<float> pointVoltages;       // where the firmware wants the points
+        std::vector<float> correctedVoltages;   // what the VCO needs there
+        std::vector<uint32_t> codes;            // DAC codes for the corrected voltages
+        std::vector<float> roundingErrorCents;  // DAC output minus corrected voltage
+        float maxRoundingCents = 0.0f;          // largest magnitude
+        float rmsRoundingCents = 0.0f;
+        int numClipped = 0;                     // corrected voltages outside the DAC range
+    };
+
+    static bool exportCalibration(const CalibrationTable& table,
+                                  const FirmwareProfile& profile,
+                                  const File& outputFile,
+                                  const String& arrayName = "calibration");
+
+    static String generateString(const CalibrationTable& table,
+                                 const FirmwareProfile& profile,
+                                 const String& arrayName = "calibration");
+
+    static Conversion convert(const CalibrationTable& table, const FirmwareProfile& profile);
+};
@@ -0,0 +1,245 @@
+/*
+  ==============================================================================
+
+    FirmwareProfile.cpp
+    DAC description of a firmware calibration target
+
+  ==============================================================================
+*/
+
+#include "FirmwareProfile.h"
+#include "JSONReader.h"
+#include "OrnamentCrimeExporter.h"
+
+namespace
+{
+    // Same array layout as OrnamentCrimeExporter::generateCHeaderString()
+    const char* const ornamentCrimeTemplate =
+        "/*\n"
+        " * VCOTuner Calibration for ${profile}\n"
+        " * Generated: ${date}\n"
+        " * Device: ${device} (${brand})\n"
+        " * Interface: ${interface}\n"
+        " *\n"
+        " * Statistics:\n"
+        " *   Max Error: ${maxErrorCents} cents\n"
+        " *   Avg Error: ${avgErrorCents} cents\n"
+        " *   DAC rounding: max ${roundingMaxCents} cents, RMS ${roundingRmsCents} cents, ${numClipped} point(s) clipped\n"
+        " */\n"
+        "\n"
+        "#ifndef OC_CUSTOM_CALIBRATION_H\n"
+        "#define OC_CUSTOM_CALIBRATION_H\n"
+        "\n"
+        "// Octave voltages: ${pointVoltages}\n"
+        "const ${valueType} ${arrayName}[${numPoints}] = {\n"
+        "${values}\n"
+        "};\n"
+        "\n"
+        "#endif // OC_CUSTOM_CALIBRATION_H\n";
+
+    bool parseRounding(const String& text, DACCode::Rounding& rounding)
+    {
+        if (text == "truncate")
+            rounding = DACCode::Rounding::truncate;
+        else if (text == "nearest")
+            rounding = DACCode::Rounding::nearest;
+        else
+            return false;
+        return true;
+    }
+
+    // limited first, a huge number doesn't fit into an int
+    int readInt(JSONReader& json, int defaultValue)
+    {
+        return static_cast<int>(jlimit(-1.0e9, 1.0e9, json.readNumber(defaultValue)));
+    }
+}
+
+float FirmwareProfile::getPointVoltage(int index) const
+{
+    return jmin(maxVoltage, firstPointVoltage + index * pointSpacing);
+}
+
+uint32_t FirmwareProfile::voltageToCode(float voltage) const
+{
+    // in double, a float can't hold every code of a 32-bit DAC
+    return DACCode::fromVoltage<double>(voltage, minVoltage, maxVoltage, dacBits, rounding);
+}
+
+float FirmwareProfile::codeToVoltage(uint32_t code) const
+{
+    return static_cast<float>(DACCode::toVoltage<double>(code, minVoltage, maxVoltage, dacBits));
+}
+
+String FirmwareProfile::getValueType() const
+{
+    if (dacBits <= 8)
+        return "uint8_t";
+    if (dacBits <= 16)
+        return "uint16_t";
+    return "uint32_t";
+}
+
+String FirmwareProfile::validate() const
+{
+    if (name.isEmpty())
+        return "no name";
+    if (dacBits < 1 || dacBits > 32)
+        return "dacBits must be between 1 and 32";
+    if (!(maxVoltage > minVoltage))
+        return "maxVoltage must be above minVoltage";
+    if (numPoints < 1 || numPoints > 4096)
+        return "numPoints must be between 1 and 4096";
+    if (numPoints > 1 && !(pointSpacing > 0.0f))
+        return "pointSpacing must be positive";
+    if (valuesPerLine < 1)
+        return "valuesPerLine must be at least 1";
+    if (fileExtension.isEmpty())
+        return "no fileExtension";
+    if (!outputTemplate.contains("${values}"))
+        return "the template has no ${values}";
+    return String();
+}
+
+bool FirmwareProfile::loadFromFile(const File& file, String& error)
+{
+    FileInputStream stream(file);
+    if (!stream.openedOk())
+    {
+        error = "can't be read";
+        return false;
+    }
+
+    JSONReader json(stream);
+    if (json.next() != JSONReader::beginObject)
+    {
+        error = "not a JSON object";
+        return false;
+    }
+
+    // parsed into a copy so a broken file leaves this profile untouched
+    FirmwareProfile profile;
+    profile.name = file.getFileNameWithoutExtension();
+
+    while (json.next() == JSONReader::key)
+    {
+        const std::string& key = json.getText();
+        if (key == "name")
+            profile.name = json.readString(profile.name);
+        else if (key == "description")
+            profile.description = json.readString();
+        else if (key == "dacBits")
+            profile.dacBits = readInt(json, profile.dacBits);
+        else if (key == "minVoltage")
+            profile.minVoltage = static_cast<float>(json.readNumber(profile.minVoltage));
+        else if (key == "maxVoltage")
+            profile.maxVoltage = static_cast<float>(json.readNumber(profile.maxVoltage));
+        else if (key == "firstPointVoltage")
+            profile.firstPointVoltage = static_cast<float>(json.readNumber(profile.firstPointVoltage));
+        else if (key == "pointSpacing")
+            profile.pointSpacing = static_cast<float>(json.readNumber(profile.pointSpacing));
+        else if (key == "numPoints")
+            profile.numPoints = readInt(json, profile.numPoints);
+        else if (key == "rounding")
+        {
+            const String rounding = json.readString();
+            if (!parseRounding(rounding, profile.rounding))
+            {
+                error = "unknown rounding \"" + rounding + "\", use truncate or nearest";
+                return false;
+            }
+        }
+        else if (key == "hexValues")
+            profile.hexValues = json.readBool(profile.hexValues);
+        else if (key == "valuesPerLine")
+            profile.valuesPerLine = readInt(json, profile.valuesPerLine);
+        else if (key == "fileExtension")
+            profile.fileExtension = json.readString(profile.fileExtension).trimCharactersAtStart(".");
+        else if (key == "template")
+        {
+            // either one string or an array of lines, which is easier to edit
+            StringArray lines;
+            if (json.next() == JSONReader::string)
+                lines.add(json.getString());
+            else if (json.getToken() == JSONReader::beginArray)
+            {
+                while (json.next() == JSONReader::string)
+                    lines.add(json.getString());
+            }
+
+            if (json.getToken() != JSONReader::string && json.getToken() != JSONReader::endArray)
+            {
+                error = "the template must be a string or an array of strings";
+                return false;
+            }
+            profile.outputTemplate = lines.joinIntoString("\n");
+            if (!profile.outputTemplate.endsWithChar('\n'))
+                profile.outputTemplate += "\n";
+        }
+        else
+            json.skipValue();
+    }
+
+    if (json.getToken() != JSONReader::endObject)
+    {
+        error = "malformed JSON";
+        return false;
+    }
+
+    error = profile.validate();
+    if (error.isNotEmpty())
+        return false;
+
+    *this = profile;
+    return true;
+}
+
+Array<FirmwareProfile> FirmwareProfile::getBuiltInProfiles()
+{
+    FirmwareProfile ornamentCrime;
+    ornamentCrime.name = "Ornament & Crime";
+    ornamentCrime.description = "One DAC channel of the o_C, for a custom calibration header";
+    ornamentCrime.dacBits = OrnamentCrimeExporter::OC_DAC_BITS;
+    ornamentCrime.minVoltage = OrnamentCrimeExporter::OC_MIN_VOLTAGE;
+    ornamentCrime.maxVoltage = OrnamentCrimeExporter::OC_MAX_VOLTAGE;
+    ornamentCrime.firstPointVoltage = OrnamentCrimeExporter::OC_MIN_VOLTAGE;
+    ornamentCrime.pointSpacing = 1.0f;
+    ornamentCrime.numPoints = OrnamentCrimeExporter::OC_OCTAVE_COUNT + 1;
+    ornamentCrime.rounding = DACCode::Rounding::truncate;
+    ornamentCrime.fileExtension = "h";
+    ornamentCrime.outputTemplate = ornamentCrimeTemplate;
+
+    Array<FirmwareProfile> profiles;
+    profiles.add(ornamentCrime);
+    return profiles;
+}
+
+Array<FirmwareProfile> FirmwareProfile::loadAll(const File& directory, StringArray& errors)
+{
+    Array<FirmwareProfile> profiles = getBuiltInProfiles();
+
+    Array<File> files = directory.findChildFiles(File::findFiles, false, "*.json");
+    std::sort(files.begin(), files.end(), [] (const File& a, const File& b)
+    {
+        return a.getFileName().compareNatural(b.getFileName()) < 0;
+    });
+
+    for (const auto& file : files)
+    {
+        FirmwareProfile profile;
+        String error;
+        if (profile.loadFromFile(file, error))
+            profiles.add(profile);
+        else
+            errors.add(file.getFileName() + ": " + error);
+    }
+
+    return profiles;
+}
+
+File FirmwareProfile::getDefaultDirectory()
+{
+    return File::getSpecialLocation(File::userApplicationDataDirectory)
+        .getChildFile("VCOTuner")
+        .getChildFile("Firmware Profiles");
+}
@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    FirmwareProfile.h
+    DAC description of a firmware calibration target
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstdint>
+#include <type_traits>
+
+// Fixed-point conversion between voltages and DAC codes, shared by all
+// firmware exporters. Everything is constexpr, so specs compiled into an
+// exporter can be checked with static_assert.
+namespace DACCode
+{
+    enum class Rounding
+    {
+        truncate,   // what most firmware calibration menus do
+        nearest
+    };
+
+    // Smallest unsigned type that holds a code of the given width
+    template <int bits>
+    using CodeType = std::conditional_t<bits <= 8, uint8_t,
+                     std::conditional_t<bits <= 16, uint16_t, uint32_t>>;
+
+    constexpr uint32_t getMaxCode(int bits)
+    {
+        return bits >= 32 ? 0xffffffffu : (uint32_t(1) << bits) - 1;
+    }
+
+    // Code 0 is minVoltage, the max code is maxVoltage. Voltages outside are clipped.
+    template <typename FloatType>
+    constexpr uint32_t fromVoltage(FloatType voltage, FloatType minVoltage, FloatType maxVoltage,
+                                   int bits, Rounding rounding = Rounding::truncate)
+    {
+        FloatType normalized = (voltage - minVoltage) / (maxVoltage - minVoltage);
+        normalized = normalized < FloatType(0) ? FloatType(0) : (normalized > FloatType(1) ? FloatType(1) : normalized);
+        const FloatType scaled = normalized * static_cast<FloatType>(getMaxCode(bits));
+        return static_cast<uint32_t>(rounding == Rounding::nearest ? scaled + FloatType(0.5) : scaled);
+    }
+
+    template <typename FloatType>
+    constexpr FloatType toVoltage(uint32_t code, FloatType minVoltage, FloatType maxVoltage, int bits)
+    {
+        const FloatType normalized = static_cast<FloatType>(code) / static_cast<FloatType>(getMaxCode(bits));
+        return minVoltage + normalized * (maxVoltage - minVoltage);
+    }
+}
+
+// Describes the calibration table of one firmware: the DAC it drives, the
+// voltages it wants calibration points for, and the text of the generated
+// file. Profiles are JSON files, so a new module only needs a new file:
+//
+//     {
+//         "name": "My MIDI-CV",
+//         "dacBits": 12,
+//         "minVoltage": 0, "maxVoltage": 10,
+//         "firstPointVoltage": 0, "pointSpacing": 1, "numPoints": 11,
+//         "rounding": "nearest",
+//         "fileExtension": "h",
+//         "valuesPerLine": 4,
+//         "template": [ "const ${valueType} ${arrayName}[${numPoints}] = {", "${values}", "};" ]
+//     }
+//
+// See FirmwareExporter for the placeholders of the template.
+struct FirmwareProfile
+{
+    String name;
+    String description;
+
+    int dacBits = 16;
+    float minVoltage = 0.0f;            // output at code 0
+    float maxVoltage = 10.0f;           // output at the max code
+
+    // Calibration points, evenly spaced. Points beyond maxVoltage are clamped to it.
+    float firstPointVoltage = 0.0f;
+    float pointSpacing = 1.0f;
+    int numPoints = 11;
+
+    DACCode::Rounding rounding = DACCode::Rounding::truncate;
+    bool hexValues = false;
+    int valuesPerLine = 1;
+    String fileExtension = "h";
+    String outputTemplate;
+
+    float getPointVoltage(int index) const;
+    uint32_t voltageToCode(float voltage) const;
+    float codeToVoltage(uint32_t code) const;
+
+    // C type that holds the codes, e.g. uint16_t
+    String getValueType() const;
+
+    // Empty if the profile can be used, otherwise what is wrong with it
+    String validate() const;
+
+    // Returns false, with the reason in error, if the file isn't a valid profile
+    bool loadFromFile(const File& file, String& error);
+
+    // The profiles that come with the application, currently Ornament & Crime
+    static Array<FirmwareProfile> getBuiltInProfiles();
+
+    // Built-in profiles followed by the valid ones in directory. Files that
+    // aren't valid profiles are reported in errors.
+    static Array<FirmwareProfile> loadAll(const File& directory, StringArray& errors);
+
+    // Where users put their own profiles
+    static File getDefaultDirectory();
+};
@@ -8,83 +8,108 @@
 */
 
 #include "JSONExporter.h"
+#include "JSONWriter.h"
 
 bool JSONExporter::exportCalibration(const CalibrationTable& table,
                                      const File& outputFile)
 {
-    String json = generateJSONString(table);
-    return outputFile.replaceWithText(json);
+    // written next to the target and moved over it, like File::replaceWithText()
+    TemporaryFile tempFile(outputFile);
+    {
+        FileOutputStream stream(tempFile.getFile());
+        if (stream.failedToOpen())
+            return false;
+
+        writeJSON(table, stream);
+        stream.flush();
+        if (stream.getStatus().failed())
+            return false;
+    }
+    return tempFile.overwriteTargetFileWithTemporary();
 }
 
 String JSONExporter::generateJSONString(const CalibrationTable& table)
 {
-    var data(new DynamicObject());
+    MemoryOutputStream stream;
+    writeJSON(table, stream);
+    return stream.toUTF8();
+}
+
+void JSONExporter::writeJSON(const CalibrationTable& table, OutputStream& stream)
+{
+    JSONWriter json(stream);
 
-    data.getDynamicObject()->setProperty("format_version", "1.0");
-    data.getDynamicObject()->setProperty("generator", "VCOTuner");
-    data.getDynamicObject()->setProperty("generated_at",
-        table.getCalibrationDate().toISO8601(true));
+    json.beginObject();
+    json.property("format_version", "1.0");
+    json.property("generator", "VCOTuner");
+    json.property("generated_at", table.getCalibrationDate().toISO8601(true));
 
     // Device info
-    var device(new DynamicObject());
-    device.getDynamicObject()->setProperty("brand", table.getDeviceBrand());
-    device.getDynamicObject()->setProperty("model", table.getDeviceName());
-    device.getDynamicObject()->setProperty("notes", table.getNotes());
-    data.getDynamicObject()->setProperty("device_under_test", device);
+    json.key("device_under_test");
+    json.beginObject();
+    json.property("brand", table.getDeviceBrand());
+    json.property("model", table.getDeviceName());
+    json.property("notes", table.getNotes());
+    json.endObject();
 
     // Interface info
-    var cvInterface(new DynamicObject());
-    cvInterface.getDynamicObject()->setProperty("name", table.getInterfaceName());
-    data.getDynamicObject()->setProperty("cv_interface", cvInterface);
+    json.key("cv_interface");
+    json.beginObject();
+    json.property("name", table.getInterfaceName());
+    json.endObject();
 
     // Settings
-    var settings(new DynamicObject());
-    settings.getDynamicObject()->setProperty("voltage_standard", table.getVoltageStandard());
-    settings.getDynamicObject()->setProperty("reference_note", 60);
-    settings.getDynamicObject()->setProperty("reference_frequency_hz", 261.63);
-    data.getDynamicObject()->setProperty("calibration_settings", settings);
+    json.key("calibration_settings");
+    json.beginObject();
+    json.property("voltage_standard", table.getVoltageStandard());
+    json.property("reference_note", 60);
+    json.property("reference_frequency_hz", 261.63);
+    json.endObject();
 
     // Calibration points
-    Array<var> pointsArray;
-    for (int i = 0; i < table.getEntryCount(); ++i)
+    json.key("calibration_points");
+    json.beginArray();
+    for (const auto& entry : table.getAllEntries())
     {
-        const auto& entry = table.getEntry(i);
-        var point(new DynamicObject());
-        point.getDynamicObject()->setProperty("midi_note", entry.midiNote);
-        point.getDynamicObject()->setProperty("ideal_voltage", entry.idealVoltage);
-        point.getDynamicObject()->setProperty("corrected_voltage", entry.actualVoltage);
-        point.getDynamicObject()->setProperty("correction_offset", entry.correctionOffset);
-        point.getDynamicObject()->setProperty("measured_frequency_hz", entry.measuredFrequency);
-        point.getDynamicObject()->setProperty("error_cents", entry.errorCents);
-        point.getDynamicObject()->setProperty("std_dev_cents", entry.stdDevCents);
-        pointsArray.add(point);
+        json.beginObject();
+        json.property("midi_note", entry.midiNote);
+        json.property("ideal_voltage", entry.idealVoltage);
+        json.property("corrected_voltage", entry.actualVoltage);
+        json.property("correction_offset", entry.correctionOffset);
+        json.property("measured_frequency_hz", entry.measuredFrequency);
+        json.property("error_cents", entry.errorCents);
+        json.property("std_dev_cents", entry.stdDevCents);
+        json.endObject();
     }
-    data.getDynamicObject()->setProperty("calibration_points", pointsArray);
+    json.endArray();
 
     // Statistics
-    var stats(new DynamicObject());
-    stats.getDynamicObject()->setProperty("total_points", table.getEntryCount());
-    stats.getDynamicObject()->setProperty("max_error_cents", table.getMaxErrorCents());
-    stats.getDynamicObject()->setProperty("min_error_cents", table.getMinErrorCents());
-    stats.getDynamicObject()->setProperty("average_error_cents", table.getAverageErrorCents());
-    stats.getDynamicObject()->setProperty("rms_error_cents", table.getRMSErrorCents());
+    json.key("statistics");
+    json.beginObject();
+    json.property("total_points", table.getEntryCount());
+    json.property("max_error_cents", table.getMaxErrorCents());
+    json.property("min_error_cents", table.getMinErrorCents());
+    json.property("average_error_cents", table.getAverageErrorCents());
+    json.property("rms_error_cents", table.getRMSErrorCents());
     auto worst = table.getWorstNote();
-    stats.getDynamicObject()->setProperty("worst_note", worst.first);
-    stats.getDynamicObject()->setProperty("worst_error_cents", worst.second);
-    data.getDynamicObject()->setProperty("statistics", stats);
+    json.property("worst_note", worst.first);
+    json.property("worst_error_cents", worst.second);
+    json.endObject();
 
     // Polynomial fit
     auto coefficients = table.getPolynomialCoefficients(4);
     if (!coefficients.empty())
     {
-        var poly(new DynamicObject());
-        poly.getDynamicObject()->setProperty("degree", 4);
-        Array<var> coeffArray;
+        json.key("polynomial_fit");
+        json.beginObject();
+        json.property("degree", 4);
+        json.key("coefficients");
+        json.beginArray();
         for (double c : coefficients)
-            coeffArray.add(c);
-        poly.getDynamicObject()->setProperty("coefficients", coeffArray);
-        data.getDynamicObject()->setProperty("polynomial_fit", poly);
+            json.value(c);
+        json.endArray();
+        json.endObject();
     }
 
-    return JSON::toString(data, true);
+    json.endObject();
 }
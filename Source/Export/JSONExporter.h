@@ -19,4 +19,7 @@ public:
                                   const File& outputFile);
 
     static String generateJSONString(const CalibrationTable& table);
+
+    // Streams the JSON document without building it in memory first
+    static void writeJSON(const CalibrationTable& table, OutputStream& stream);
 };
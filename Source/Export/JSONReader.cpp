@@ -0,0 +1,269 @@
+/*
+  ==============================================================================
+
+    JSONReader.cpp
+    Pull parser for JSON read straight from an InputStream
+
+  ==============================================================================
+*/
+
+#include "JSONReader.h"
+
+JSONReader::JSONReader(InputStream& in)
+    : input(in)
+{
+}
+
+JSONReader::Token JSONReader::next()
+{
+    if (token == error || token == endOfInput)
+        return token;
+
+    // separators are accepted loosely, the tokens carry the structure
+    int c = readChar();
+    while (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ',' || c == ':')
+        c = readChar();
+
+    switch (c)
+    {
+        case -1:
+            return token = scopes.empty() ? endOfInput : fail();
+
+        case '{':
+        case '[':
+            scopes.push_back(static_cast<char>(c));
+            expectKey = c == '{';
+            return token = c == '{' ? beginObject : beginArray;
+
+        case '}':
+        case ']':
+            if (scopes.empty() || scopes.back() != (c == '}' ? '{' : '['))
+                return fail();
+            scopes.pop_back();
+            return valueRead(c == '}' ? endObject : endArray);
+
+        case '"':
+            if (!readStringText())
+                return fail();
+            if (expectKey)
+            {
+                expectKey = false;
+                return token = key;
+            }
+            return valueRead(string);
+
+        case 't':
+            if (!readLiteral("rue"))
+                return fail();
+            boolValue = true;
+            return valueRead(boolean);
+
+        case 'f':
+            if (!readLiteral("alse"))
+                return fail();
+            boolValue = false;
+            return valueRead(boolean);
+
+        case 'n':
+            if (!readLiteral("ull"))
+                return fail();
+            return valueRead(null);
+
+        default:
+            if ((c >= '0' && c <= '9') || c == '-')
+            {
+                if (!readNumberText(c))
+                    return fail();
+                return valueRead(number);
+            }
+            return fail();
+    }
+}
+
+void JSONReader::skipCurrent()
+{
+    if (token != beginObject && token != beginArray)
+        return;
+
+    for (int depth = 1; depth > 0;)
+    {
+        switch (next())
+        {
+            case beginObject:
+            case beginArray:
+                ++depth;
+                break;
+            case endObject:
+            case endArray:
+                --depth;
+                break;
+            case endOfInput:
+            case error:
+                return;
+            default:
+                break;
+        }
+    }
+}
+
+void JSONReader::skipValue()
+{
+    next();
+    skipCurrent();
+}
+
+String JSONReader::readString(const String& defaultValue)
+{
+    if (next() == string)
+        return getString();
+
+    skipCurrent();
+    return defaultValue;
+}
+
+double JSONReader::readNumber(double defaultValue)
+{
+    if (next() == number)
+        return numberValue;
+
+    skipCurrent();
+    return defaultValue;
+}
+
+bool JSONReader::readBool(bool defaultValue)
+{
+    if (next() == boolean)
+        return boolValue;
+
+    skipCurrent();
+    return defaultValue;
+}
+
+int JSONReader::peekChar()
+{
+    if (bufferPosition == bufferSize)
+    {
+        bufferSize = jmax(0, input.read(buffer, static_cast<int>(sizeof(buffer))));
+        bufferPosition = 0;
+        if (bufferSize == 0)
+            return -1;
+    }
+
+    return static_cast<unsigned char>(buffer[bufferPosition]);
+}
+
+int JSONReader::readChar()
+{
+    const int c = peekChar();
+    if (c >= 0)
+        ++bufferPosition;
+    return c;
+}
+
+JSONReader::Token JSONReader::fail()
+{
+    text.clear();
+    return token = error;
+}
+
+JSONReader::Token JSONReader::valueRead(Token t)
+{
+    // in an object a key follows every value
+    expectKey = isInObject();
+    return token = t;
+}
+
+bool JSONReader::readStringText()
+{
+    text.clear();
+
+    for (;;)
+    {
+        int c = readChar();
+        if (c < 0x20)
+            return false;   // end of input or an unescaped control character
+
+        if (c == '"')
+            return true;
+
+        if (c != '\\')
+        {
+            text.push_back(static_cast<char>(c));
+            continue;
+        }
+
+        switch (c = readChar())
+        {
+            case '"':
+            case '\\':
+            case '/': text.push_back(static_cast<char>(c)); break;
+            case 'b': text.push_back('\b'); break;
+            case 'f': text.push_back('\f'); break;
+            case 'n': text.push_back('\n'); break;
+            case 'r': text.push_back('\r'); break;
+            case 't': text.push_back('\t'); break;
+            case 'u':
+            {
+                auto readHex = [this] (juce_wchar& result)
+                {
+                    result = 0;
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        const int digit = CharacterFunctions::getHexDigitValue(static_cast<juce_wchar>(readChar()));
+                        if (digit < 0)
+                            return false;
+                        result = (result << 4) | static_cast<juce_wchar>(digit);
+                    }
+                    return true;
+                };
+
+                juce_wchar character;
+                if (!readHex(character))
+                    return false;
+
+                // characters outside the basic plane come as a surrogate pair
+                if (character >= 0xd800 && character <= 0xdbff)
+                {
+                    juce_wchar low;
+                    if (readChar() != '\\' || readChar() != 'u' || !readHex(low) || low < 0xdc00 || low > 0xdfff)
+                        return false;
+                    character = 0x10000 + ((character - 0xd800) << 10) + (low - 0xdc00);
+                }
+
+                char utf8[8];
+                CharPointer_UTF8 dest(utf8);
+                dest.write(character);
+                text.append(utf8, static_cast<size_t>(dest.getAddress() - utf8));
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+}
+
+bool JSONReader::readNumberText(int firstChar)
+{
+    text.assign(1, static_cast<char>(firstChar));
+
+    for (;;)
+    {
+        const int c = peekChar();
+        if (!((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-'))
+            break;
+        text.push_back(static_cast<char>(readChar()));
+    }
+
+    CharPointer_ASCII digits(text.c_str());
+    numberValue = CharacterFunctions::readDoubleValue(digits);
+    return digits.isEmpty();
+}
+
+bool JSONReader::readLiteral(const char* rest)
+{
+    for (; *rest != 0; ++rest)
+        if (readChar() != *rest)
+            return false;
+
+    return true;
+}
@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    JSONReader.h
+    Pull parser for JSON read straight from an InputStream
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <string>
+#include <vector>
+
+// Reads JSON one token at a time, so the caller can fill its own data while
+// parsing instead of walking a var tree afterwards. A typical object loop:
+//
+//     while (reader.next() == JSONReader::key)
+//     {
+//         if (reader.getText() == "name")
+//             name = reader.readString();
+//         else
+//             reader.skipValue();
+//     }
+class JSONReader
+{
+public:
+    enum Token
+    {
+        none,
+        beginObject,
+        endObject,
+        beginArray,
+        endArray,
+        key,
+        string,
+        number,
+        boolean,
+        null,
+        endOfInput,
+        error           // malformed input, every following call returns error as well
+    };
+
+    explicit JSONReader(InputStream& input);
+
+    Token next();
+    Token getToken() const { return token; }
+
+    // UTF-8 text of the current key or string, or the characters of a number
+    const std::string& getText() const { return text; }
+    String getString() const { return String::fromUTF8(text.data(), static_cast<int>(text.size())); }
+    double getNumber() const { return numberValue; }
+    bool getBool() const { return boolValue; }
+
+    // If the current token opens an object or array, skips to its end
+    void skipCurrent();
+
+    // Reads and discards the next value, e.g. the one of an unknown key
+    void skipValue();
+
+    // Read the next value. A value of another type is skipped and gives the default.
+    String readString(const String& defaultValue = String());
+    double readNumber(double defaultValue = 0.0);
+    bool readBool(bool defaultValue = false);
+
+private:
+    int peekChar();
+    int readChar();
+    Token fail();
+    Token valueRead(Token t);
+    bool readStringText();
+    bool readNumberText(int firstChar);
+    bool readLiteral(const char* rest);
+    bool isInObject() const { return !scopes.empty() && scopes.back() == '{'; }
+
+    InputStream& input;
+    char buffer[4096];
+    int bufferPosition = 0;
+    int bufferSize = 0;
+
+    Token token = none;
+    std::string text;           // reused for every token to avoid allocations
+    double numberValue = 0.0;
+    bool boolValue = false;
+
+    std::vector<char> scopes;   // the opening brackets of the enclosing objects and arrays
+    bool expectKey = false;
+
+    JUCE_DECLARE_NON_COPYABLE(JSONReader)
+};
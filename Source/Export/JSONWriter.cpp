@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+    JSONWriter.cpp
+    Streaming JSON output without an intermediate var tree
+
+  ==============================================================================
+*/
+
+#include "JSONWriter.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+JSONWriter::JSONWriter(OutputStream& out, bool pretty)
+    : output(out), prettyPrint(pretty)
+{
+}
+
+void JSONWriter::beginObject()
+{
+    beginScope('{');
+}
+
+void JSONWriter::endObject()
+{
+    endScope('}');
+}
+
+void JSONWriter::beginArray()
+{
+    beginScope('[');
+}
+
+void JSONWriter::endArray()
+{
+    endScope(']');
+}
+
+void JSONWriter::key(StringRef name)
+{
+    jassert(!afterKey);
+
+    beginValue();
+    writeString(name);
+    if (prettyPrint)
+        output.write(": ", 2);
+    else
+        output.writeByte(':');
+    afterKey = true;
+}
+
+void JSONWriter::value(StringRef text)
+{
+    beginValue();
+    writeString(text);
+}
+
+void JSONWriter::value(int number)
+{
+    beginValue();
+    char buffer[16];
+    const int length = std::snprintf(buffer, sizeof(buffer), "%d", number);
+    output.write(buffer, static_cast<size_t>(length));
+}
+
+void JSONWriter::value(float number)
+{
+    beginValue();
+    writeNumber(number, true);
+}
+
+void JSONWriter::value(double number)
+{
+    beginValue();
+    writeNumber(number, false);
+}
+
+void JSONWriter::value(bool b)
+{
+    beginValue();
+    if (b)
+        output.write("true", 4);
+    else
+        output.write("false", 5);
+}
+
+void JSONWriter::nullValue()
+{
+    beginValue();
+    output.write("null", 4);
+}
+
+void JSONWriter::beginValue()
+{
+    if (afterKey)
+    {
+        afterKey = false;
+        return;
+    }
+
+    if (!isFirstInScope)
+        output.writeByte(',');
+    if (depth > 0)
+        newLine();
+    isFirstInScope = false;
+}
+
+void JSONWriter::beginScope(char bracket)
+{
+    beginValue();
+    output.writeByte(bracket);
+    ++depth;
+    isFirstInScope = true;
+}
+
+void JSONWriter::endScope(char bracket)
+{
+    jassert(depth > 0 && !afterKey);
+
+    --depth;
+    if (!isFirstInScope)
+        newLine();
+    output.writeByte(bracket);
+    isFirstInScope = false;
+}
+
+void JSONWriter::newLine()
+{
+    if (!prettyPrint)
+        return;
+
+    output.writeByte('\n');
+    output.writeRepeatedByte(' ', static_cast<size_t>(depth * 2));
+}
+
+void JSONWriter::writeString(StringRef text)
+{
+    output.writeByte('"');
+
+    // copy runs of characters that need no escaping in one go
+    const char* p = text.text.getAddress();
+    const char* runStart = p;
+    for (; *p != 0; ++p)
+    {
+        const auto c = static_cast<unsigned char>(*p);
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+
+        output.write(runStart, static_cast<size_t>(p - runStart));
+        runStart = p + 1;
+
+        switch (c)
+        {
+            case '"':  output.write("\\\"", 2); break;
+            case '\\': output.write("\\\\", 2); break;
+            case '\n': output.write("\\n", 2); break;
+            case '\r': output.write("\\r", 2); break;
+            case '\t': output.write("\\t", 2); break;
+            default:
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(c));
+                output.write(escaped, 6);
+                break;
+            }
+        }
+    }
+    output.write(runStart, static_cast<size_t>(p - runStart));
+
+    output.writeByte('"');
+}
+
+void JSONWriter::writeNumber(double number, bool singlePrecision)
+{
+    // JSON has no representation for these
+    if (!std::isfinite(number))
+    {
+        output.write("null", 4);
+        return;
+    }
+
+    // the shortest text that reads back as the same value
+    const int maxDigits = singlePrecision ? 9 : 17;
+    char buffer[32];
+    int length = 0;
+    for (int digits = singlePrecision ? 6 : 15; digits <= maxDigits; ++digits)
+    {
+        length = std::snprintf(buffer, sizeof(buffer), "%.*g", digits, number);
+        const bool exact = singlePrecision ? std::strtof(buffer, nullptr) == static_cast<float>(number)
+                                           : std::strtod(buffer, nullptr) == number;
+        if (exact)
+            break;
+    }
+    output.write(buffer, static_cast<size_t>(length));
+}
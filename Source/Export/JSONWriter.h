@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    JSONWriter.h
+    Streaming JSON output without an intermediate var tree
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Writes JSON straight to an OutputStream while the caller walks its own
+// data, so no var/DynamicObject tree or complete String is ever built.
+// The caller is responsible for a well formed sequence of calls: inside an
+// object every value is preceded by key(), and scopes are closed in order.
+class JSONWriter
+{
+public:
+    explicit JSONWriter(OutputStream& output, bool prettyPrint = true);
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    void key(StringRef name);
+
+    void value(StringRef text);
+    void value(const char* text) { value(StringRef(text)); }
+    void value(int number);
+    void value(float number);   // written with the digits a float needs
+    void value(double number);
+    void value(bool b);
+    void nullValue();
+
+    template <typename ValueType>
+    void property(StringRef name, ValueType v)
+    {
+        key(name);
+        value(v);
+    }
+
+private:
+    void beginValue();
+    void beginScope(char bracket);
+    void endScope(char bracket);
+    void newLine();
+    void writeString(StringRef text);
+    void writeNumber(double number, bool singlePrecision);
+
+    OutputStream& output;
+    const bool prettyPrint;
+
+    int depth = 0;
+    bool isFirstInScope = true; // no separator before the first value of an object or array
+    bool afterKey = false;
+
+    JUCE_DECLARE_NON_COPYABLE(JSONWriter)
+};
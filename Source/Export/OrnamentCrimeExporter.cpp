@@ -8,8 +8,15 @@
 */
 
 #include "OrnamentCrimeExporter.h"
+#include "FirmwareProfile.h"
 #include <cmath>
 
+// The o_C DAC range ends on exact codes
+static_assert(DACCode::fromVoltage(OrnamentCrimeExporter::OC_MIN_VOLTAGE, OrnamentCrimeExporter::OC_MIN_VOLTAGE,
+                                   OrnamentCrimeExporter::OC_MAX_VOLTAGE, OrnamentCrimeExporter::OC_DAC_BITS) == 0, "");
+static_assert(DACCode::fromVoltage(OrnamentCrimeExporter::OC_MAX_VOLTAGE, OrnamentCrimeExporter::OC_MIN_VOLTAGE,
+                                   OrnamentCrimeExporter::OC_MAX_VOLTAGE, OrnamentCrimeExporter::OC_DAC_BITS) == 65535, "");
+
 bool OrnamentCrimeExporter::exportAsCHeader(const CalibrationTable& table,
                                             const File& outputFile,
                                             const String& arrayName,
@@ -19,6 +26,14 @@ bool OrnamentCrimeExporter::exportAsCHeader(const CalibrationTable& table,
     return outputFile.replaceWithText(header);
 }
 
+bool OrnamentCrimeExporter::exportMultiChannelCHeader(const ChannelTables& tables,
+                                                      const File& outputFile,
+                                                      const String& arrayName)
+{
+    String header = generateMultiChannelCHeaderString(tables, arrayName);
+    return outputFile.replaceWithText(header);
+}
+
 bool OrnamentCrimeExporter::exportAsReadable(const CalibrationTable& table,
                                               const File& outputFile)
 {
@@ -49,24 +64,79 @@ String OrnamentCrimeExporter::generateCHeaderString(const CalibrationTable& tabl
     header += "#ifndef OC_CUSTOM_CALIBRATION_H\n";
     header += "#define OC_CUSTOM_CALIBRATION_H\n\n";
 
-    header += "// DAC calibration values for Channel " + String(char('A' + channel)) + "\n";
+    appendChannelArray(header, ocData, arrayName);
+
+    header += "#endif // OC_CUSTOM_CALIBRATION_H\n";
+
+    return header;
+}
+
+String OrnamentCrimeExporter::generateMultiChannelCHeaderString(const ChannelTables& tables,
+                                                                 const String& arrayName)
+{
+    String header;
+
+    header += "/*\n";
+    header += " * VCOTuner Calibration for Ornament & Crime, all channels\n";
+    header += " * Generated: " + Time::getCurrentTime().toString(true, true) + "\n";
+
+    // Convert every channel first, the comment block lists them all
+    std::array<OCCalibrationData, OC_NUM_CHANNELS> ocData;
+    for (int channel = 0; channel < OC_NUM_CHANNELS; ++channel)
+    {
+        const CalibrationTable* table = tables[static_cast<size_t>(channel)];
+        if (table == nullptr)
+            continue;
+
+        ocData[static_cast<size_t>(channel)] = convertToOCFormat(*table);
+        ocData[static_cast<size_t>(channel)].channel = channel;
+
+        const QuantisationError error = measureQuantisationError(ocData[static_cast<size_t>(channel)]);
+
+        header += " *\n";
+        header += " * Channel " + String(char('A' + channel)) + ": "
+                + table->getDeviceName() + " (" + table->getDeviceBrand() + ")\n";
+        header += " *   Interface: " + table->getInterfaceName() + "\n";
+        header += " *   Max Error: " + String(table->getMaxErrorCents(), 2) + " cents\n";
+        header += " *   Avg Error: " + String(table->getAverageErrorCents(), 2) + " cents\n";
+        header += " *   DAC rounding: " + describeQuantisationError(error) + "\n";
+    }
+
+    header += " */\n\n";
+
+    header += "#ifndef OC_CUSTOM_CALIBRATION_H\n";
+    header += "#define OC_CUSTOM_CALIBRATION_H\n\n";
+
+    for (int channel = 0; channel < OC_NUM_CHANNELS; ++channel)
+        if (tables[static_cast<size_t>(channel)] != nullptr)
+            appendChannelArray(header, ocData[static_cast<size_t>(channel)], arrayName);
+
+    header += "#endif // OC_CUSTOM_CALIBRATION_H\n";
+
+    return header;
+}
+
+void OrnamentCrimeExporter::appendChannelArray(String& header, const OCCalibrationData& ocData, const String& arrayName)
+{
+    const QuantisationError error = measureQuantisationError(ocData);
+
+    header += "// DAC calibration values for Channel " + String(char('A' + ocData.channel)) + "\n";
     header += "// Octave voltages: -3V, -2V, -1V, 0V, +1V, +2V, +3V, +4V, +5V, +6V, (upper bound)\n";
-    header += "const uint16_t " + arrayName + "_dac_" + String(char('a' + channel)) + "[11] = {\n";
+    if (error.numClipped > 0)
+        header += "// WARNING: " + String(error.numClipped) + " point(s) outside the DAC range, clipped\n";
+    header += "const uint16_t " + arrayName + "_dac_" + String(char('a' + ocData.channel)) + "[11] = {\n";
 
     for (int i = 0; i < 11; ++i)
     {
-        float voltage = OC_MIN_VOLTAGE + i;
-        if (i == 10) voltage = OC_MAX_VOLTAGE;  // Last point is +6V
+        const float voltage = getPointVoltage(i);
 
         header += "    " + String(ocData.dacValues[i]);
         if (i < 10) header += ",";
-        header += "   // " + String(voltage >= 0 ? "+" : "") + String(static_cast<int>(voltage)) + "V\n";
+        header += "   // " + String(voltage >= 0 ? "+" : "") + String(static_cast<int>(voltage)) + "V";
+        header += ", rounding " + String(error.errorCents[i], 3) + " cents\n";
     }
 
     header += "};\n\n";
-    header += "#endif // OC_CUSTOM_CALIBRATION_H\n";
-
-    return header;
 }
 
 String OrnamentCrimeExporter::generateReadableString(const CalibrationTable& table)
@@ -95,8 +165,7 @@ String OrnamentCrimeExporter::generateReadableString(const CalibrationTable& tab
 
     for (int i = 0; i < 11; ++i)
     {
-        float voltage = OC_MIN_VOLTAGE + i;
-        if (i == 10) voltage = OC_MAX_VOLTAGE;
+        const float voltage = getPointVoltage(i);
 
         String voltStr = String(voltage >= 0 ? "+" : "") + String(static_cast<int>(voltage)) + "V";
         float actualV = dacValueToVoltage(ocData.dacValues[i]);
@@ -106,6 +175,8 @@ String OrnamentCrimeExporter::generateReadableString(const CalibrationTable& tab
         text += "  (actual: " + String(actualV, 4) + "V)\n";
     }
 
+    text += "\nDAC rounding: " + describeQuantisationError(measureQuantisationError(ocData)) + "\n";
+
     text += "\nNote: These values are calculated to compensate for your\n";
     text += "VCO's tracking errors when driven by the o_C.\n";
 
@@ -118,32 +189,59 @@ OrnamentCrimeExporter::OCCalibrationData OrnamentCrimeExporter::convertToOCForma
 
     // For each octave point (-3V to +6V), find the corrected voltage
     // and convert to DAC value
+    std::array<float, 11> midiPitches;
     for (int i = 0; i < 11; ++i)
     {
-        float targetVoltage = OC_MIN_VOLTAGE + i;
-        if (i == 10) targetVoltage = OC_MAX_VOLTAGE;
-
         // Convert voltage to MIDI pitch (1V/Oct, 0V = C4 = MIDI 60)
-        float midiPitch = 60.0f + targetVoltage * 12.0f;
+        midiPitches[i] = 60.0f + getPointVoltage(i) * 12.0f;
+    }
 
-        // Get corrected voltage from calibration table
-        float correctedVoltage = table.getCorrectedVoltage(midiPitch);
+    // All points in one pass over the table
+    table.getCorrectedVoltages(midiPitches.data(), ocData.correctedVoltages.data(), 11);
 
-        // Convert to DAC value
-        ocData.dacValues[i] = voltageToDACValue(correctedVoltage);
-    }
+    for (int i = 0; i < 11; ++i)
+        ocData.dacValues[i] = voltageToDACValue(ocData.correctedVoltages[i]);
 
     return ocData;
 }
 
+OrnamentCrimeExporter::QuantisationError OrnamentCrimeExporter::measureQuantisationError(const OCCalibrationData& ocData)
+{
+    QuantisationError error;
+    float sumSquares = 0.0f;
+
+    for (int i = 0; i < 11; ++i)
+    {
+        const float corrected = ocData.correctedVoltages[i];
+        if (corrected < OC_MIN_VOLTAGE || corrected > OC_MAX_VOLTAGE)
+            error.numClipped++;
+
+        // 1V/Oct: one volt is 1200 cents
+        const float cents = (dacValueToVoltage(ocData.dacValues[i]) - corrected) * 1200.0f;
+        error.errorCents[i] = cents;
+        error.maxCents = jmax(error.maxCents, std::abs(cents));
+        sumSquares += cents * cents;
+    }
+
+    error.rmsCents = std::sqrt(sumSquares / 11.0f);
+    return error;
+}
+
+String OrnamentCrimeExporter::describeQuantisationError(const QuantisationError& error)
+{
+    String text = "max " + String(error.maxCents, 3) + " cents, RMS " + String(error.rmsCents, 3) + " cents";
+    if (error.numClipped > 0)
+        text += ", " + String(error.numClipped) + " point(s) clipped to the DAC range";
+    return text;
+}
+
 CalibrationTable OrnamentCrimeExporter::importFromOCData(const OCCalibrationData& ocData)
 {
     CalibrationTable table;
 
     for (int i = 0; i < 11; ++i)
     {
-        float targetVoltage = OC_MIN_VOLTAGE + i;
-        if (i == 10) targetVoltage = OC_MAX_VOLTAGE;
+        float targetVoltage = getPointVoltage(i);
 
         float actualVoltage = dacValueToVoltage(ocData.dacValues[i]);
 
@@ -168,16 +266,20 @@ uint16_t OrnamentCrimeExporter::voltageToDACValue(float voltage)
 {
     // o_C DAC: 16-bit, -3V to +6V range
     // Linear mapping: -3V = 0, +6V = 65535
-    float normalized = (voltage - OC_MIN_VOLTAGE) / (OC_MAX_VOLTAGE - OC_MIN_VOLTAGE);
-    normalized = juce::jlimit(0.0f, 1.0f, normalized);
-    return static_cast<uint16_t>(normalized * 65535.0f);
+    return static_cast<DACCode::CodeType<OC_DAC_BITS>>(DACCode::fromVoltage(voltage, OC_MIN_VOLTAGE, OC_MAX_VOLTAGE, OC_DAC_BITS));
 }
 
 float OrnamentCrimeExporter::dacValueToVoltage(uint16_t dacValue)
 {
     // Inverse of voltageToDACValue
-    float normalized = static_cast<float>(dacValue) / 65535.0f;
-    return OC_MIN_VOLTAGE + normalized * (OC_MAX_VOLTAGE - OC_MIN_VOLTAGE);
+    return DACCode::toVoltage(dacValue, OC_MIN_VOLTAGE, OC_MAX_VOLTAGE, OC_DAC_BITS);
+}
+
+float OrnamentCrimeExporter::getPointVoltage(int index)
+{
+    if (index == 10)
+        return OC_MAX_VOLTAGE;  // Last point is +6V
+    return OC_MIN_VOLTAGE + index;
 }
 
 int OrnamentCrimeExporter::voltageToOctaveIndex(float voltage)
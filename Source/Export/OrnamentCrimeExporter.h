@@ -21,20 +21,39 @@ public:
     static constexpr float OC_MIN_VOLTAGE = -3.0f;
     static constexpr float OC_MAX_VOLTAGE = +6.0f;
     static constexpr int OC_OCTAVE_COUNT = 10;  // -3V to +6V = 9 octaves, 10 boundary points
+    static constexpr int OC_NUM_CHANNELS = 4;   // DAC channels A-D
 
     // o_C calibration data structure
     struct OCCalibrationData
     {
         std::array<uint16_t, 11> dacValues;  // 11 points for 10 octaves
         int channel = 0;
+        std::array<float, 11> correctedVoltages {};  // what the DAC values stand for
     };
 
+    // Pitch error the 16-bit DAC steps add to the corrected voltages
+    struct QuantisationError
+    {
+        std::array<float, 11> errorCents {};  // per point, DAC output minus corrected voltage
+        float maxCents = 0.0f;                // largest magnitude
+        float rmsCents = 0.0f;
+        int numClipped = 0;                   // corrected voltages outside the DAC range
+    };
+
+    // One table per DAC channel, nullptr for channels that aren't calibrated
+    using ChannelTables = std::array<const CalibrationTable*, OC_NUM_CHANNELS>;
+
     // Export as C header for compiling into firmware
     static bool exportAsCHeader(const CalibrationTable& table,
                                 const File& outputFile,
                                 const String& arrayName = "custom_cal",
                                 int channel = 0);
 
+    // Export one header with the arrays of all calibrated channels
+    static bool exportMultiChannelCHeader(const ChannelTables& tables,
+                                          const File& outputFile,
+                                          const String& arrayName = "custom_cal");
+
     // Export human-readable format for manual entry via o_C calibration menu
     static bool exportAsReadable(const CalibrationTable& table,
                                  const File& outputFile);
@@ -44,11 +63,18 @@ public:
                                         const String& arrayName = "custom_cal",
                                         int channel = 0);
 
+    static String generateMultiChannelCHeaderString(const ChannelTables& tables,
+                                                    const String& arrayName = "custom_cal");
+
     static String generateReadableString(const CalibrationTable& table);
 
     // Convert calibration table to o_C DAC values
     static OCCalibrationData convertToOCFormat(const CalibrationTable& table);
 
+    // Check the rounding to DAC values before flashing
+    static QuantisationError measureQuantisationError(const OCCalibrationData& ocData);
+    static String describeQuantisationError(const QuantisationError& error);
+
     // Import o_C calibration (if we can parse it)
     static CalibrationTable importFromOCData(const OCCalibrationData& ocData);
 
@@ -56,4 +82,8 @@ public:
     static uint16_t voltageToDACValue(float voltage);
     static float dacValueToVoltage(uint16_t dacValue);
     static int voltageToOctaveIndex(float voltage);  // Which of the 11 calibration points
+
+private:
+    static float getPointVoltage(int index);  // -3V ... +6V
+    static void appendChannelArray(String& header, const OCCalibrationData& ocData, const String& arrayName);
 };
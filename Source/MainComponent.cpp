@@ -11,6 +11,9 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "MainComponent.h"
 #include "ReportCreatorWindow.h"
+#include "ReportRenderer.h"
+#include "Export/BatchExporter.h"
+#include "Export/OrnamentCrimeExporter.h"
 #include "CVCalibrationWindow.h"
 #include "ModernLookAndFeel.h"
 #include "TunerDisplay.h"
@@ -18,7 +21,7 @@
 // Global look and feel instance
 static ModernLookAndFeel modernLookAndFeel;
 
-MainComponent::MainComponent() : tuner(&deviceManager), tunerDisplay(&tuner), display(&tuner)
+MainComponent::MainComponent() : tuner(&deviceManager), tunerDisplay(&tuner), display(&tuner), driftView(tuner), stabilityView(tuner)
 {
     // Apply modern look and feel
     LookAndFeel::setDefaultLookAndFeel(&modernLookAndFeel);
@@ -52,11 +55,21 @@ MainComponent::MainComponent() : tuner(&deviceManager), tunerDisplay(&tuner), di
     report.addListener(this);
     addAndMakeVisible(&report);
 
+    batchExport.setName("BatchExportBttn");
+    batchExport.setButtonText("Batch Export");
+    batchExport.addListener(this);
+    addAndMakeVisible(&batchExport);
+
     cvCalibration.setName("CVCalibrationBttn");
     cvCalibration.setButtonText("CV Calibration");
     cvCalibration.addListener(this);
     addAndMakeVisible(&cvCalibration);
 
+    driftLog.setName("DriftLogBttn");
+    driftLog.setButtonText("Drift Log");
+    driftLog.addListener(this);
+    addAndMakeVisible(&driftLog);
+
     statusLabel.setName("Status Label");
     statusLabel.setJustificationType(juce::Justification::centred);
     addAndMakeVisible(&statusLabel);
@@ -89,22 +102,38 @@ MainComponent::MainComponent() : tuner(&deviceManager), tunerDisplay(&tuner), di
         resolution.setSelectedId(1);
     addAndMakeVisible(&resolution);
 
+    driftLabel.setName("Drift Label");
+    driftLabel.setText("Drift: ", dontSendNotification);
+    driftLabel.setJustificationType(juce::Justification::centredRight);
+    addAndMakeVisible(&driftLabel);
+
+    drift.setName("DriftSelector");
+    drift.addItemList(StringArray(driftIntervalTexts, numDriftIntervals), 1);
+    drift.addListener(this);
+    if (getAppProperties().getUserSettings()->containsKey("DriftID"))
+        drift.setSelectedId(getAppProperties().getUserSettings()->getIntValue("DriftID"));
+    else
+        drift.setSelectedId(1);
+    addAndMakeVisible(&drift);
+
     // Create tabbed component with tuner and chart views
     tabs = std::make_unique<TabbedComponent>(TabbedButtonBar::TabsAtTop);
     tabs->setTabBarDepth(32);
     tabs->setOutline(0);
     tabs->addTab("Tuner", ModernLookAndFeel::Colors::background, &tunerDisplay, false);
     tabs->addTab("Chart", ModernLookAndFeel::Colors::background, &display, false);
+    tabs->addTab("Drift", ModernLookAndFeel::Colors::background, &driftView, false);
+    tabs->addTab("Stability", ModernLookAndFeel::Colors::background, &stabilityView, false);
     tabs->setCurrentTabIndex(0);  // Start on Tuner tab
     addAndMakeVisible(tabs.get());
 
     tuner.addListener(this);
     tuner.addListener(&tunerDisplay);
-    tuner.addListener(&display);
     if (getAppProperties().getUserSettings()->containsKey("MIDIChannel"))
         tuner.setMidiChannel(getAppProperties().getUserSettings()->getIntValue("MIDIChannel"));
     else
         tuner.setMidiChannel(1);
+    tuner.setHarmonicAnalysis(getAppProperties().getUserSettings()->getIntValue("HarmonicAnalysis", 0) == 1);
     
     cycle = false;
     creatingReport = false;
@@ -123,9 +152,9 @@ MainComponent::~MainComponent()
 {
     tuner.removeListener(this);
     tuner.removeListener(&tunerDisplay);
-    tuner.removeListener(&display);
     getAppProperties().getUserSettings()->setValue("RegimeID", regime.getSelectedId());
     getAppProperties().getUserSettings()->setValue("ResolutionID", resolution.getSelectedId());
+    getAppProperties().getUserSettings()->setValue("DriftID", drift.getSelectedId());
 }
 
 
@@ -137,17 +166,21 @@ void MainComponent::resized()
 
     audioSettings.setBounds(borderWidth, borderWidth, buttonWidth, buttonHeight);
     cvCalibration.setBounds(audioSettings.getRight() + borderWidth, borderWidth, buttonWidth, buttonHeight);
+    driftLog.setBounds(cvCalibration.getRight() + borderWidth, borderWidth, buttonWidth, buttonHeight);
     report.setBounds(getWidth() - buttonWidth - borderWidth, borderWidth, buttonWidth, buttonHeight);
+    batchExport.setBounds(driftLog.getRight() + borderWidth, borderWidth, buttonWidth, buttonHeight);
     startStop.setBounds(report.getX() - buttonWidth - borderWidth, borderWidth, buttonWidth, buttonHeight);
-    statusLabel.setBounds(cvCalibration.getRight() + borderWidth,
+    statusLabel.setBounds(batchExport.getRight() + borderWidth,
                           borderWidth,
-                          startStop.getX() - borderWidth - borderWidth - cvCalibration.getRight(),
+                          startStop.getX() - borderWidth - borderWidth - batchExport.getRight(),
                           buttonHeight);
 
     regime.setBounds(getWidth() - 120 - borderWidth, audioSettings.getBottom() + borderWidth, 120, buttonHeight);
     regimeLabel.setBounds(regime.getX() - 80 - borderWidth, audioSettings.getBottom() + borderWidth, 80, buttonHeight);
     resolution.setBounds(regimeLabel.getX() - 120 - borderWidth, audioSettings.getBottom() + borderWidth, 120, buttonHeight);
     resolutionLabel.setBounds(resolution.getX() - 80 - borderWidth, audioSettings.getBottom() + borderWidth, 80, buttonHeight);
+    drift.setBounds(resolutionLabel.getX() - 120 - borderWidth, audioSettings.getBottom() + borderWidth, 120, buttonHeight);
+    driftLabel.setBounds(drift.getX() - 50 - borderWidth, audioSettings.getBottom() + borderWidth, 50, buttonHeight);
 
     // Tabbed component takes the main area
     if (tabs != nullptr)
@@ -179,6 +212,7 @@ void MainComponent::buttonClicked (Button* bttn)
         {
             comboBoxChanged(&regime);
             comboBoxChanged(&resolution);
+            comboBoxChanged(&drift);
         }
         tuner.toggleState();
         if (tuner.isRunning())
@@ -187,6 +221,45 @@ void MainComponent::buttonClicked (Button* bttn)
             cycle = true;
         }
     }
+    else if (bttn == &driftLog)
+    {
+        if (tuner.isDriftLogging())
+        {
+            tuner.stop();
+            return;
+        }
+        
+        // burn-in test: log the pitch in the middle of the selected range until stopped
+        FileChooser chooser("Save drift log...", File(), "*.csv");
+        if (!chooser.browseForFileToSave(false))
+            return;
+        
+        // an existing log can be continued, e.g. after a break in a long burn-in
+        File logFile = chooser.getResult().withFileExtension("csv");
+        bool append = false;
+        if (logFile.existsAsFile())
+        {
+            const int choice = NativeMessageBox::showYesNoCancelBox(AlertWindow::QuestionIcon, "Drift Log",
+                                                                    logFile.getFileName() + " already exists. Append the new measurements to it?\n"
+                                                                    "(No replaces the file.)", this, nullptr);
+            if (choice == 0)
+                return;
+            append = choice == 1;
+        }
+        
+        comboBoxChanged(&regime);
+        cycle = false;
+        if (tuner.startDriftLogging((tuner.getLowestPitch() + tuner.getHighestPitch()) / 2, logFile, append))
+        {
+            driftLog.setButtonText("Stop Log");
+            tabs->setCurrentTabIndex(2);    // the drift view
+        }
+        else
+        {
+            tuner.stop();
+            NativeMessageBox::showMessageBox(AlertWindow::WarningIcon, "Error!", "The drift log file could not be created.");
+        }
+    }
     else if (bttn == &report)
     {
         ReportCreatorWindow* reportWindow = new ReportCreatorWindow(&tuner, &display);
@@ -202,6 +275,56 @@ void MainComponent::buttonClicked (Button* bttn)
 
         o.launchAsync();
     }
+    else if (bttn == &batchExport)
+    {
+        // every selected calibration table is converted in the background
+        const int ocAllChannels = 1;
+        const int dataFormats = 100;    // plus the BatchExporter format flags
+        const int firmwareProfiles = 200;   // plus the index of the profile
+        
+        StringArray profileErrors;
+        const Array<FirmwareProfile> profiles = FirmwareProfile::loadAll(FirmwareProfile::getDefaultDirectory(), profileErrors);
+        
+        PopupMenu formatMenu;
+        for (auto format : { BatchExporter::reportPNG, BatchExporter::reportEPS })
+            formatMenu.addItem(dataFormats + format, BatchExporter::getFormatName(format));
+        formatMenu.addSeparator();
+        for (auto format : { BatchExporter::csv, BatchExporter::json, BatchExporter::ocHeader, BatchExporter::ocReadable })
+            formatMenu.addItem(dataFormats + format, BatchExporter::getFormatName(format));
+        formatMenu.addItem(dataFormats + BatchExporter::allFormats, "All data formats");
+        PopupMenu firmwareMenu;
+        for (int i = 0; i < profiles.size(); i++)
+            firmwareMenu.addItem(firmwareProfiles + i, profiles[i].name);
+        if (profileErrors.size() > 0)
+            firmwareMenu.addSeparator();
+        for (int i = 0; i < profileErrors.size(); i++)     // shown but not selectable
+            firmwareMenu.addItem(firmwareProfiles + profiles.size() + i, profileErrors[i], false);
+        formatMenu.addSubMenu(BatchExporter::getFormatName(BatchExporter::firmware), firmwareMenu);
+        formatMenu.addSeparator();
+        formatMenu.addItem(ocAllChannels, "o_C header for channels A-D...");
+        const int choice = formatMenu.showAt(&batchExport);
+        if (choice == 0)
+            return;
+        
+        FileChooser tableChooser("Select calibrations...", File(), "*.json");
+        if (!tableChooser.browseForMultipleFilesToOpen())
+            return;
+        
+        if (choice == ocAllChannels)
+        {
+            exportOrnamentCrimeChannels(tableChooser.getResults());
+            return;
+        }
+        
+        FileChooser directoryChooser("Export to...", tableChooser.getResult().getParentDirectory());
+        if (!directoryChooser.browseForDirectory())
+            return;
+        
+        if (choice >= firmwareProfiles)
+            (new BatchExport(tableChooser.getResults(), directoryChooser.getResult(), BatchExporter::firmware, profiles[choice - firmwareProfiles]))->launchThread();
+        else
+            (new BatchExport(tableChooser.getResults(), directoryChooser.getResult(), choice - dataFormats))->launchThread();
+    }
     else if (bttn == &cvCalibration)
     {
         CVCalibrationWindow* calibrationWindow = new CVCalibrationWindow(&tuner, cvOutput.get(), &display);
@@ -219,6 +342,60 @@ void MainComponent::buttonClicked (Button* bttn)
     }
 }
 
+/** Writes one o_C header for up to four calibrations. The files are assigned
+    to the DAC channels A-D in the order of their names. */
+void MainComponent::exportOrnamentCrimeChannels(Array<File> calibrationFiles)
+{
+    std::sort(calibrationFiles.begin(), calibrationFiles.end(), [] (const File& a, const File& b)
+    {
+        return a.getFileName().compareNatural(b.getFileName()) < 0;
+    });
+    
+    if (calibrationFiles.size() > OrnamentCrimeExporter::OC_NUM_CHANNELS)
+    {
+        NativeMessageBox::showMessageBoxAsync(AlertWindow::WarningIcon, "o_C Export",
+                                              "Please select at most " + String(OrnamentCrimeExporter::OC_NUM_CHANNELS) + " calibrations, one per DAC channel.");
+        return;
+    }
+    
+    OwnedArray<CalibrationTable> tables;
+    OrnamentCrimeExporter::ChannelTables channels {};
+    for (int i = 0; i < calibrationFiles.size(); i++)
+    {
+        CalibrationTable* table = tables.add(new CalibrationTable());
+        if (!table->loadFromFile(calibrationFiles[i]))
+        {
+            NativeMessageBox::showMessageBoxAsync(AlertWindow::WarningIcon, "o_C Export",
+                                                  calibrationFiles[i].getFileName() + " is not a calibration table.");
+            return;
+        }
+        channels[static_cast<size_t>(i)] = table;
+    }
+    
+    FileChooser chooser("Save o_C header...", calibrationFiles[0].getSiblingFile("oc_calibration.h"), "*.h");
+    if (!chooser.browseForFileToSave(true))
+        return;
+    
+    const File headerFile = chooser.getResult().withFileExtension("h");
+    if (!OrnamentCrimeExporter::exportMultiChannelCHeader(channels, headerFile))
+    {
+        NativeMessageBox::showMessageBoxAsync(AlertWindow::WarningIcon, "o_C Export",
+                                              "Could not write " + headerFile.getFullPathName());
+        return;
+    }
+    
+    // the DAC rounding of every channel, to check before flashing
+    String message = "Written to " + headerFile.getFullPathName() + newLine;
+    for (int i = 0; i < calibrationFiles.size(); i++)
+    {
+        const auto ocData = OrnamentCrimeExporter::convertToOCFormat(*tables[i]);
+        const auto error = OrnamentCrimeExporter::measureQuantisationError(ocData);
+        message << newLine << "Channel " << String(char('A' + i)) << " (" << calibrationFiles[i].getFileName() << "): "
+                << OrnamentCrimeExporter::describeQuantisationError(error);
+    }
+    NativeMessageBox::showMessageBoxAsync(AlertWindow::InfoIcon, "o_C Export", message);
+}
+
 void MainComponent::startCreatingReport()
 {
     tuner.setNumMeasurementRange(reportRange.startNote, reportRange.interval, reportRange.endNote);
@@ -260,7 +437,10 @@ void MainComponent::comboBoxChanged (ComboBox* comboBoxThatHasChanged)
         }
         
         int selected = comboBoxThatHasChanged->getSelectedId() - 1;
-        tuner.setResolution(resolutions[selected]);        
+        if (resolutions[selected] > 0)
+            tuner.setResolution(resolutions[selected]);
+        else
+            tuner.setEarlyStop(autoResolutionTargetCents, maxNumAutoResolutionPeriods);        
         
         if (wasRunning)
         {
@@ -268,6 +448,12 @@ void MainComponent::comboBoxChanged (ComboBox* comboBoxThatHasChanged)
             cycle = wasCycling;
         }
     }
+    else if (comboBoxThatHasChanged == &drift)
+    {
+        // takes effect with the next reference measurement, no restart needed
+        int selected = comboBoxThatHasChanged->getSelectedId() - 1;
+        tuner.setReferenceInterval(driftIntervals[selected]);
+    }
 }
 
 void MainComponent::showAudioSettings()
@@ -298,6 +484,11 @@ void MainComponent::showAudioSettings()
                 channelEdit.setSelectedId(1);
             addAndMakeVisible(&channelEdit);
             
+            harmonics.setButtonText("Analyse the waveform of each note");
+            harmonics.setToggleState(t->isHarmonicAnalysisEnabled(), dontSendNotification);
+            harmonics.addListener(this);
+            addAndMakeVisible(&harmonics);
+            
             close.setButtonText("Close");
             close.addListener(this);
             addAndMakeVisible(&close);
@@ -317,10 +508,11 @@ void MainComponent::showAudioSettings()
             const int height = selectorComponent.getItemHeight();
             const int border = 10;
             
-            selectorComponent.setBounds(0, 0, getWidth(), getHeight() - 4*border - 2*height);
+            selectorComponent.setBounds(0, 0, getWidth(), getHeight() - 5*border - 3*height);
             // selectorComponent overwrites its height in its resized() function. But it doesnt seem to work
             channelEdit.setBounds(proportionOfWidth (0.35f), selectorComponent.getBottom() + border, proportionOfWidth (0.6f), height);
             channelLabel.setBounds(0, selectorComponent.getBottom() + border, proportionOfWidth (0.35f), height);
+            harmonics.setBounds(proportionOfWidth (0.35f), channelEdit.getBottom() + border, proportionOfWidth (0.6f), height);
             close.setBounds(border, getHeight() - border - height, getWidth() - 2*border, height);
         }
         
@@ -331,6 +523,11 @@ void MainComponent::showAudioSettings()
                 if (DialogWindow* dw = findParentComponentOfClass<DialogWindow>())
                     dw->exitModalState (0);
             }
+            else if (bttn == &harmonics)
+            {
+                t->setHarmonicAnalysis(harmonics.getToggleState());
+                getAppProperties().getUserSettings()->setValue("HarmonicAnalysis", harmonics.getToggleState() ? 1 : 0);
+            }
         }
         
     private:
@@ -338,11 +535,12 @@ void MainComponent::showAudioSettings()
         Label channelLabel;
         TextButton close;
         ComboBox channelEdit;
+        ToggleButton harmonics;
         VCOTuner* t;
     };
     
     SettingsWrapperComponent content(&tuner, deviceManager);
-    content.setSize(400, 410);
+    content.setSize(400, 444);
     
     
     DialogWindow::LaunchOptions o;
@@ -378,11 +576,17 @@ void MainComponent::tunerStatusChanged(String statusString)
 
 void MainComponent::tunerStopped()
 {
+    // failed calibration measurements are retried by the calibration
+    // engine, a modal popup would block an unattended run
+    if (tuner.wasSingleMeasurementStopped())
+        return;
+    
     StringArray errors = tuner.getLastErrors();
     for (int i = 0; i < errors.size(); i++)
         NativeMessageBox::showMessageBox(AlertWindow::WarningIcon, "Error!", errors[i]);
     
     startStop.setButtonText("Start");
+    driftLog.setButtonText("Drift Log");
     cycle = false;
     creatingReport = false;
 }
@@ -429,13 +633,22 @@ const char* MainComponent::regimeTexts[numRegimes] = {
     "huge > fine (24-96, +1)",
 };
 
-const int MainComponent::resolutions[numResolutions] = {20, 50, 100, 200, 400};
+const int MainComponent::driftIntervals[numDriftIntervals] = {0, 12, 6, 3};
+const char* MainComponent::driftIntervalTexts[numDriftIntervals] = {
+    "off - warm up first",
+    "check every 12 notes",
+    "check every 6 notes",
+    "check every 3 notes"
+};
+
+const int MainComponent::resolutions[numResolutions] = {20, 50, 100, 200, 400, 0};
 const char* MainComponent::resolutionsTexts[numResolutions] = {
     "20 - quick & dirty",
     "50 - not quite enough",
     "100 - okay",
     "200 - neat and tidy",
-    "400 - never accurate enough"
+    "400 - never accurate enough",
+    "auto - 0.1 cent"
 };
 
 const MainComponent::regime_t MainComponent::reportRange = {24, 96, 1};
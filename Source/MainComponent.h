@@ -14,6 +14,8 @@
 #include "VCOTuner.h"
 #include "Visualizer.h"
 #include "TunerDisplay.h"
+#include "DriftView.h"
+#include "StabilityView.h"
 #include "CVOutput/CVOutputManager.h"
 
 //==============================================================================
@@ -51,21 +53,28 @@ private:
     VCOTuner tuner;
     
     void showAudioSettings();
+    void exportOrnamentCrimeChannels(Array<File> calibrationFiles);
     
     TextButton audioSettings;
     TextButton startStop;
     TextButton report;
+    TextButton batchExport;
     TextButton cvCalibration;
+    TextButton driftLog;
 
     // Tabbed display with tuner and chart views
     std::unique_ptr<TabbedComponent> tabs;
     TunerDisplay tunerDisplay;
     Visualizer display;
+    DriftView driftView;
+    StabilityView stabilityView;
     Label statusLabel;
     Label regimeLabel;
     ComboBox regime;
     Label resolutionLabel;
     ComboBox resolution;
+    Label driftLabel;
+    ComboBox drift;
     
     typedef struct
     {
@@ -77,9 +86,14 @@ private:
     static const regime_t regimes[numRegimes];
     static const char* regimeTexts[numRegimes];
     static const regime_t reportRange;
-    static const int numResolutions = 5;
+    static const int numResolutions = 6;
     static const int resolutions[numResolutions];
     static const char* resolutionsTexts[numResolutions];
+    static constexpr double autoResolutionTargetCents = 0.1; // standard error at which "auto" stops
+    static const int maxNumAutoResolutionPeriods = 400;
+    static const int numDriftIntervals = 4;
+    static const int driftIntervals[numDriftIntervals]; // notes between reference measurements
+    static const char* driftIntervalTexts[numDriftIntervals];
     
     bool cycle;
     bool creatingReport;
@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    DecimationPyramid.cpp
+    Min/max/mean levels of detail over a series of values
+
+  ==============================================================================
+*/
+
+#include "DecimationPyramid.h"
+
+void DecimationPyramid::reset(int numValues)
+{
+    levels.clear();
+
+    int numBuckets = jmax(0, numValues);
+    levels.emplace_back(static_cast<size_t>(numBuckets));
+    while (numBuckets > 1)
+    {
+        numBuckets = (numBuckets + 1) / 2;
+        levels.emplace_back(static_cast<size_t>(numBuckets));
+    }
+}
+
+void DecimationPyramid::set(int index, double value, double low, double high)
+{
+    jassert(index >= 0 && index < size());
+    if (index < 0 || index >= size())
+        return;
+
+    Bucket& b = levels[0][static_cast<size_t>(index)];
+    b.minimum = jmin(low, value);
+    b.maximum = jmax(high, value);
+    b.mean = value;
+    b.count = 1;
+
+    for (size_t level = 1; level < levels.size(); ++level)
+    {
+        const auto& below = levels[level - 1];
+        const size_t first = static_cast<size_t>(index & ~1);
+        index /= 2;
+
+        levels[level][static_cast<size_t>(index)] = first + 1 < below.size() ? combine(below[first], below[first + 1])
+                                                                              : below[first];
+    }
+}
+
+int DecimationPyramid::getLevelFor(double valuesPerBucket) const
+{
+    int level = 0;
+    while (level + 1 < getNumLevels() && (double) (1 << level) < valuesPerBucket)
+        ++level;
+    return level;
+}
+
+DecimationPyramid::Bucket DecimationPyramid::combine(const Bucket& a, const Bucket& b)
+{
+    if (a.count == 0)
+        return b;
+    if (b.count == 0)
+        return a;
+
+    Bucket c;
+    c.minimum = jmin(a.minimum, b.minimum);
+    c.maximum = jmax(a.maximum, b.maximum);
+    c.count = a.count + b.count;
+    c.mean = (a.mean * a.count + b.mean * b.count) / c.count;
+    return c;
+}
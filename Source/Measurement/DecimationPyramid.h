@@ -0,0 +1,53 @@
+/*
+  ==============================================================================
+
+    DecimationPyramid.h
+    Min/max/mean levels of detail over a series of values
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+// Keeps a series of values with an error band together with coarser levels
+// in which every bucket combines two buckets of the level below, so a chart
+// can draw any range of the series with at most one bucket per pixel.
+// Changing a single value only updates the buckets above it.
+class DecimationPyramid
+{
+public:
+    struct Bucket
+    {
+        double minimum = 0.0;   // lowest low end of the combined values
+        double maximum = 0.0;   // highest high end of the combined values
+        double mean = 0.0;      // of the values themselves
+        int count = 0;          // number of values, 0 for an empty bucket
+    };
+
+    // Discards everything and makes room for numValues empty values
+    void reset(int numValues);
+
+    // value lies within [low, high], e.g. a mean and its deviation band
+    void set(int index, double value, double low, double high);
+
+    int size() const { return levels.empty() ? 0 : static_cast<int>(levels[0].size()); }
+    int getNumLevels() const { return static_cast<int>(levels.size()); }
+
+    // Lowest level whose buckets combine at least valuesPerBucket values
+    int getLevelFor(double valuesPerBucket) const;
+
+    int getNumBuckets(int level) const { return static_cast<int>(levels[static_cast<size_t>(level)].size()); }
+    const Bucket& getBucket(int level, int index) const { return levels[static_cast<size_t>(level)][static_cast<size_t>(index)]; }
+
+    // Range of values that a bucket covers
+    static Range<int> getValueRange(int level, int bucketIndex) { return Range<int>(bucketIndex << level, (bucketIndex + 1) << level); }
+
+private:
+    static Bucket combine(const Bucket& a, const Bucket& b);
+
+    // level 0 holds the values, level n buckets of 2^n values
+    std::vector<std::vector<Bucket>> levels;
+};
@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+    DriftLogger.cpp
+    Bounded-memory log of continuous frequency measurements
+
+  ==============================================================================
+*/
+
+#include "DriftLogger.h"
+
+DriftLogger::DriftLogger(int rawCapacity, int tierCapacity, int factor)
+    : tierFactor(jmax(2, factor))
+{
+    raw.items.resize(static_cast<size_t>(jmax(1, rawCapacity)));
+    for (auto& tier : tiers)
+        tier.items.resize(static_cast<size_t>(jmax(1, tierCapacity)));
+}
+
+DriftLogger::~DriftLogger()
+{
+    stop();
+}
+
+bool DriftLogger::start(const File& logFile, bool appendToFile)
+{
+    stop();
+
+    raw.head = raw.size = 0;
+    for (int i = 0; i < numTiers; ++i)
+    {
+        tiers[i].head = tiers[i].size = 0;
+        pending[i] = Bucket();
+        pendingChildren[i] = 0;
+    }
+
+    startTime = Time::getMillisecondCounterHiRes() * 0.001;
+    lastSeconds = 0.0;
+    lastFlushSeconds = 0.0;
+    totalEntries = 0;
+    file = logFile;
+
+    if (file != File())
+    {
+        if (!csv.open(file, appendToFile ? CSVWriter::Mode::append : CSVWriter::Mode::replace))
+            return false;
+
+        // an appended run restarts its seconds at zero after this line
+        csv.writeComment("VCOTuner drift log, started " + Time::getCurrentTime().toISO8601(true));
+        if (!csv.isContinuingFile())
+            csv.writeHeader({ "seconds", "frequency", "deviation" });
+    }
+
+    logging = true;
+    return true;
+}
+
+void DriftLogger::stop()
+{
+    logging = false;
+    csv.close();
+}
+
+void DriftLogger::add(double frequency, double deviation)
+{
+    if (!logging || frequency <= 0.0)
+        return;
+
+    Entry entry;
+    entry.seconds = Time::getMillisecondCounterHiRes() * 0.001 - startTime;
+    entry.frequency = frequency;
+    entry.deviation = deviation;
+
+    raw.push(entry);
+    lastSeconds = entry.seconds;
+    totalEntries++;
+
+    Bucket single;
+    single.startSeconds = single.endSeconds = entry.seconds;
+    single.minimum = single.maximum = single.mean = frequency;
+    single.count = 1;
+    addToTier(0, single);
+
+    if (csv.isOpen())
+    {
+        csv.add(entry.seconds, 3).add(frequency, 6).add(deviation, 6).endRow();
+
+        // Flushing every line would cost more than the measurement itself
+        if (entry.seconds - lastFlushSeconds >= 1.0)
+        {
+            csv.flush();
+            lastFlushSeconds = entry.seconds;
+        }
+    }
+}
+
+void DriftLogger::addToTier(int tier, const Bucket& bucket)
+{
+    // Tier 0 buckets hold tierFactor raw entries, every further tier
+    // tierFactor buckets of the tier below
+    fold(pending[tier], bucket);
+    if (++pendingChildren[tier] < tierFactor)
+        return;
+
+    const Bucket full = pending[tier];
+    pending[tier] = Bucket();
+    pendingChildren[tier] = 0;
+
+    tiers[tier].push(full);
+    if (tier + 1 < numTiers)
+        addToTier(tier + 1, full);
+}
+
+void DriftLogger::fold(Bucket& into, const Bucket& from)
+{
+    if (into.count == 0)
+    {
+        into = from;
+        return;
+    }
+
+    const int total = into.count + from.count;
+    into.mean = (into.mean * into.count + from.mean * from.count) / total;
+    into.minimum = jmin(into.minimum, from.minimum);
+    into.maximum = jmax(into.maximum, from.maximum);
+    into.endSeconds = from.endSeconds;
+    into.count = total;
+}
+
+std::vector<DriftLogger::Entry> DriftLogger::getRecentEntries() const
+{
+    return raw.toVector();
+}
+
+std::vector<DriftLogger::Bucket> DriftLogger::getTier(int tier) const
+{
+    if (tier < 0 || tier >= numTiers)
+        return {};
+
+    // Include the bucket that is still filling, so the display reaches the present
+    std::vector<Bucket> result = tiers[tier].toVector();
+    if (pending[tier].count > 0)
+        result.push_back(pending[tier]);
+    return result;
+}
+
+int DriftLogger::getFinestCompleteTier() const
+{
+    if (totalEntries <= raw.size)
+        return -1;
+
+    for (int tier = 0; tier < numTiers; ++tier)
+        if (tiers[tier].size < static_cast<int>(tiers[tier].items.size()))
+            return tier;
+
+    return numTiers - 1;
+}
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    DriftLogger.h
+    Bounded-memory log of continuous frequency measurements
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "../Export/CSVWriter.h"
+
+// Records every result of a continuous frequency measurement for burn-in
+// tests that run for many hours. Memory stays constant: the latest raw
+// entries live in a ring buffer, and older data survives only in a few
+// downsampled tiers of min/max/mean buckets, each tier covering tierFactor
+// times the time span of the one below. Optionally every raw entry is also
+// streamed to a CSV file. All functions are called from the message thread.
+class DriftLogger
+{
+public:
+    struct Entry
+    {
+        double seconds = 0.0;       // since the start of the log
+        double frequency = 0.0;
+        double deviation = 0.0;     // frequency standard deviation of the measurement
+    };
+
+    struct Bucket
+    {
+        double startSeconds = 0.0;
+        double endSeconds = 0.0;
+        double minimum = 0.0;
+        double maximum = 0.0;
+        double mean = 0.0;
+        int count = 0;              // number of raw entries folded into this bucket
+    };
+
+    static const int numTiers = 4;
+
+    explicit DriftLogger(int rawCapacity = 8192, int tierCapacity = 4096, int tierFactor = 16);
+    ~DriftLogger();
+
+    // Starts a new log. An empty file logs to memory only. With appendToFile
+    // the rows continue an existing CSV file instead of replacing it.
+    bool start(const File& logFile = File(), bool appendToFile = false);
+    void stop();
+    bool isLogging() const { return logging; }
+
+    void add(double frequency, double deviation);
+
+    // Oldest to newest
+    std::vector<Entry> getRecentEntries() const;
+    std::vector<Bucket> getTier(int tier) const;
+
+    // Finest tier that still reaches back to the start of the log, or -1 if
+    // the raw entries do. The coarsest tier is returned once all have wrapped.
+    int getFinestCompleteTier() const;
+
+    int64 getTotalNumEntries() const { return totalEntries; }
+    double getDurationSeconds() const { return lastSeconds; }
+    const File& getFile() const { return file; }
+
+private:
+    template <typename T>
+    struct Ring
+    {
+        std::vector<T> items;
+        int head = 0;
+        int size = 0;
+
+        void push(const T& item)
+        {
+            items[static_cast<size_t>(head)] = item;
+            head = (head + 1) % static_cast<int>(items.size());
+            size = jmin(size + 1, static_cast<int>(items.size()));
+        }
+
+        std::vector<T> toVector() const
+        {
+            std::vector<T> result;
+            result.reserve(static_cast<size_t>(size));
+            const int capacity = static_cast<int>(items.size());
+            for (int i = 0; i < size; ++i)
+                result.push_back(items[static_cast<size_t>((head - size + i + capacity) % capacity)]);
+            return result;
+        }
+    };
+
+    void addToTier(int tier, const Bucket& bucket);
+    static void fold(Bucket& into, const Bucket& from);
+
+    const int tierFactor;
+    Ring<Entry> raw;
+    Ring<Bucket> tiers[numTiers];
+    Bucket pending[numTiers];       // bucket of each tier still being filled
+    int pendingChildren[numTiers] = {};
+
+    bool logging = false;
+    double startTime = 0.0;
+    double lastSeconds = 0.0;
+    int64 totalEntries = 0;
+
+    File file;
+    CSVWriter csv;
+    double lastFlushSeconds = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DriftLogger)
+};
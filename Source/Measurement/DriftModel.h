@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    DriftModel.h
+    Least-squares drift of a repeatedly measured reference over time
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <cmath>
+
+// Collects (time, value) pairs of the same quantity measured again and again,
+// e.g. the reference pitch in cents, and fits a straight line through them.
+// Evaluating the line between or after the samples predicts how far the
+// quantity has moved since the first one, so measurements taken in between
+// can be corrected for it. A single sample gives a constant model.
+class DriftModel
+{
+public:
+    void reset() noexcept
+    {
+        n = 0;
+        t0 = 0.0;
+        v0 = 0.0;
+        sumT = sumV = sumTT = sumTV = 0.0;
+    }
+
+    void addSample(double seconds, double value) noexcept
+    {
+        // Fit relative to the first sample to keep the sums well conditioned
+        if (n == 0)
+        {
+            t0 = seconds;
+            v0 = value;
+        }
+
+        const double t = seconds - t0;
+        const double v = value - v0;
+        ++n;
+        sumT += t;
+        sumV += v;
+        sumTT += t * t;
+        sumTV += t * v;
+    }
+
+    int getNumSamples() const noexcept { return n; }
+
+    // Change per second
+    double getSlope() const noexcept
+    {
+        const double denominator = n * sumTT - sumT * sumT;
+        if (n < 2 || std::abs(denominator) < 1e-12)
+            return 0.0;
+        return (n * sumTV - sumT * sumV) / denominator;
+    }
+
+    // Drift at the given time relative to the first sample
+    double getDriftAt(double seconds) const noexcept
+    {
+        if (n == 0)
+            return 0.0;
+
+        const double slope = getSlope();
+        const double intercept = (sumV - slope * sumT) / n;
+        return intercept + slope * (seconds - t0);
+    }
+
+private:
+    int n = 0;
+    double t0 = 0.0;
+    double v0 = 0.0;
+    double sumT = 0.0, sumV = 0.0, sumTT = 0.0, sumTV = 0.0;
+};
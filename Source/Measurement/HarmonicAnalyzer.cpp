@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    HarmonicAnalyzer.cpp
+    Harmonic content and waveform shape of a captured window
+
+  ==============================================================================
+*/
+
+#include "HarmonicAnalyzer.h"
+#include <cmath>
+
+HarmonicAnalyzer::HarmonicAnalyzer()
+    : fft(fftOrder),
+      window(static_cast<size_t>(fftSize)),
+      buffer(static_cast<size_t>(2 * fftSize))
+{
+    // Blackman-Harris keeps the leakage of a strong fundamental far below
+    // the upper harmonics of a sine-like waveform
+    dsp::WindowingFunction<float>::fillWindowingTables(window.data(), static_cast<size_t>(fftSize),
+                                                        dsp::WindowingFunction<float>::blackmanHarris, false);
+
+    for (float w : window)
+        windowPower += static_cast<double>(w) * w;
+}
+
+HarmonicAnalyzer::Result HarmonicAnalyzer::analyze(const float* samples, int numSamples, double sampleRate, double fundamental)
+{
+    Result result;
+    result.fundamental = fundamental;
+
+    if (samples == nullptr || numSamples < fftSize || sampleRate <= 0.0 || fundamental <= 0.0)
+        return result;
+
+    // Waveform shape in the time domain
+    double sum = 0.0;
+    float minimum = samples[0], maximum = samples[0];
+    for (int i = 0; i < fftSize; ++i)
+    {
+        sum += samples[i];
+        minimum = jmin(minimum, samples[i]);
+        maximum = jmax(maximum, samples[i]);
+    }
+
+    result.dcOffset = sum / fftSize;
+    result.peakToPeak = maximum - minimum;
+
+    double sumSquares = 0.0;
+    for (int i = 0; i < fftSize; ++i)
+    {
+        const double x = samples[i] - result.dcOffset;
+        sumSquares += x * x;
+    }
+    result.rms = std::sqrt(sumSquares / fftSize);
+
+    std::fill(buffer.begin(), buffer.end(), 0.0f);
+    for (int i = 0; i < fftSize; ++i)
+        buffer[static_cast<size_t>(i)] = static_cast<float>(samples[i] - result.dcOffset) * window[static_cast<size_t>(i)];
+
+    fft.performFrequencyOnlyForwardTransform(buffer.data());
+
+    // A harmonic is the energy of its window main lobe (+-4 bins for
+    // Blackman-Harris) around the strongest bin near the expected position.
+    // For a sine of amplitude A that energy is A^2 * N * sum(w^2) / 4.
+    const double binWidth = sampleRate / fftSize;
+    const int lobe = 4;
+    const int nyquistBin = fftSize / 2;
+
+    for (int h = 1; h <= maxNumHarmonics; ++h)
+    {
+        const double expected = h * fundamental / binWidth;
+        if (expected + lobe >= nyquistBin)
+            break;
+
+        const int centre = roundToInt(expected);
+        int peak = centre;
+        for (int k = jmax(1, centre - 2); k <= centre + 2; ++k)
+            if (buffer[static_cast<size_t>(k)] > buffer[static_cast<size_t>(peak)])
+                peak = k;
+
+        double energy = 0.0;
+        for (int k = jmax(1, peak - lobe); k <= jmin(nyquistBin, peak + lobe); ++k)
+            energy += static_cast<double>(buffer[static_cast<size_t>(k)]) * buffer[static_cast<size_t>(k)];
+
+        result.harmonics[static_cast<size_t>(h - 1)] = static_cast<float>(2.0 * std::sqrt(energy / (fftSize * windowPower)));
+        result.numHarmonics = h;
+    }
+
+    if (result.numHarmonics == 0 || result.harmonics[0] <= 0.0f)
+        return result;
+
+    double harmonicPower = 0.0;
+    for (int h = 2; h <= result.numHarmonics; ++h)
+        harmonicPower += static_cast<double>(result.harmonics[static_cast<size_t>(h - 1)]) * result.harmonics[static_cast<size_t>(h - 1)];
+
+    result.thd = std::sqrt(harmonicPower) / result.harmonics[0];
+    result.valid = true;
+    return result;
+}
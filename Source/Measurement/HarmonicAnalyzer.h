@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    HarmonicAnalyzer.h
+    Harmonic content and waveform shape of a captured window
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+// Analyses a window of raw input samples with a known fundamental frequency:
+// the amplitude of each harmonic, THD, DC offset and levels. The FFT, window
+// and work buffer are allocated once, so repeated analyses on the message
+// thread don't allocate either.
+class HarmonicAnalyzer
+{
+public:
+    static const int fftOrder = 14;
+    static const int fftSize = 1 << fftOrder;
+    static const int maxNumHarmonics = 16;
+
+    struct Result
+    {
+        double fundamental = 0.0;       // Hz, from the period measurement
+        double dcOffset = 0.0;          // Mean sample value
+        double peakToPeak = 0.0;
+        double rms = 0.0;               // Without the DC offset
+        double thd = 0.0;               // Harmonics 2..n relative to the fundamental
+        int numHarmonics = 0;           // Harmonics below Nyquist, up to maxNumHarmonics
+        std::array<float, maxNumHarmonics> harmonics {};    // Peak amplitudes, index 0 = fundamental
+        bool valid = false;
+
+        // Level of a harmonic (1 = fundamental) relative to the fundamental
+        float getHarmonicDecibels(int harmonic) const
+        {
+            if (harmonic < 1 || harmonic > numHarmonics || harmonics[0] <= 0.0f)
+                return -200.0f;
+            return Decibels::gainToDecibels(harmonics[static_cast<size_t>(harmonic - 1)] / harmonics[0], -200.0f);
+        }
+    };
+
+    HarmonicAnalyzer();
+
+    // Needs at least fftSize samples, only the first fftSize are used
+    Result analyze(const float* samples, int numSamples, double sampleRate, double fundamental);
+
+private:
+    dsp::FFT fft;
+    std::vector<float> window;
+    std::vector<float> buffer;
+    double windowPower = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HarmonicAnalyzer)
+};
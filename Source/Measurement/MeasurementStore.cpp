@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    MeasurementStore.cpp
+    Pitch-indexed store of the measurements of a sweep
+
+  ==============================================================================
+*/
+
+#include "MeasurementStore.h"
+#include <algorithm>
+
+MeasurementStore::MeasurementStore()
+{
+    indexOfPitch.fill(-1);
+    pitches.reserve(numPitches);
+}
+
+void MeasurementStore::add(const Measurement& m)
+{
+    jassert(isValidPitch(m.midiPitch));
+    if (!isValidPitch(m.midiPitch))
+        return;
+
+    auto& notes = history[static_cast<size_t>(m.midiPitch)];
+    if (notes.empty())
+    {
+        // a new note: insert it in order and renumber the notes above it
+        auto position = std::lower_bound(pitches.begin(), pitches.end(), m.midiPitch);
+        position = pitches.insert(position, m.midiPitch);
+        for (auto it = position; it != pitches.end(); ++it)
+            indexOfPitch[static_cast<size_t>(*it)] = static_cast<int>(it - pitches.begin());
+
+        notes.reserve(maxHistoryPerPitch);
+    }
+    else if (static_cast<int>(notes.size()) >= maxHistoryPerPitch)
+        notes.erase(notes.begin());
+
+    notes.push_back(m);
+    latestPitch = m.midiPitch;
+
+    notify(Range<int>(m.midiPitch, m.midiPitch + 1));
+}
+
+void MeasurementStore::clear()
+{
+    if (pitches.empty())
+        return;
+
+    for (int pitch : pitches)
+    {
+        history[static_cast<size_t>(pitch)].clear();
+        indexOfPitch[static_cast<size_t>(pitch)] = -1;
+    }
+    pitches.clear();
+    latestPitch = -1;
+
+    notify(Range<int>(0, numPitches));
+}
+
+const MeasurementStore::Measurement& MeasurementStore::get(int midiPitch) const
+{
+    jassert(contains(midiPitch));
+    return history[static_cast<size_t>(midiPitch)].back();
+}
+
+const std::vector<MeasurementStore::Measurement>& MeasurementStore::getHistory(int midiPitch) const
+{
+    jassert(isValidPitch(midiPitch));
+    return history[static_cast<size_t>(jlimit(0, numPitches - 1, midiPitch))];
+}
+
+void MeasurementStore::notify(Range<int> dirtyPitches)
+{
+    ++version;
+    listeners.call(&Listener::measurementsChanged, *this, dirtyPitches);
+}
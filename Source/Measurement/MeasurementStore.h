@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    MeasurementStore.h
+    Pitch-indexed store of the measurements of a sweep
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "../VCOTuner.h"
+
+// Holds the measurements of the tuner, directly indexed by MIDI note, with a
+// short history of repeated measurements per note. VCOTuner owns the store and
+// adds every note before it calls Listener::newMeasurementReady(), so all
+// views read the same data instead of keeping their own copies. Listeners are
+// told which range of pitches changed.
+//
+// Only used from the message thread.
+class MeasurementStore
+{
+public:
+    typedef VCOTuner::measurement_t Measurement;
+
+    static const int numPitches = 128;
+    static const int maxHistoryPerPitch = 16;
+
+    class Listener
+    {
+    public:
+        virtual ~Listener() {}
+
+        // dirtyPitches is the half-open range of MIDI notes whose measurements changed
+        virtual void measurementsChanged(const MeasurementStore& store, Range<int> dirtyPitches) = 0;
+    };
+
+    MeasurementStore();
+
+    // Replaces the current measurement of m.midiPitch, the old one moves to its history
+    void add(const Measurement& m);
+    void clear();
+
+    // Number of notes that have a measurement
+    int size() const { return static_cast<int>(pitches.size()); }
+    bool isEmpty() const { return pitches.empty(); }
+
+    bool contains(int midiPitch) const { return isValidPitch(midiPitch) && indexOfPitch[static_cast<size_t>(midiPitch)] >= 0; }
+
+    // The most recent measurement of a note, which must be contained
+    const Measurement& get(int midiPitch) const;
+
+    // Oldest to newest, the last one is the same as get()
+    const std::vector<Measurement>& getHistory(int midiPitch) const;
+
+    // The measured notes in ascending order, index must be below size()
+    int getPitchAt(int index) const { return pitches[static_cast<size_t>(index)]; }
+    const Measurement& getAt(int index) const { return get(getPitchAt(index)); }
+
+    // Position of a note in the ascending order, -1 if it has no measurement
+    int indexOf(int midiPitch) const { return isValidPitch(midiPitch) ? indexOfPitch[static_cast<size_t>(midiPitch)] : -1; }
+
+    // The measurement that was added last, the store must not be empty
+    const Measurement& getLatest() const { return get(latestPitch); }
+
+    // Incremented on every change, so views can tell whether cached data is stale
+    int64 getVersion() const { return version; }
+
+    void addListener(Listener* l) { listeners.add(l); }
+    void removeListener(Listener* l) { listeners.remove(l); }
+
+private:
+    static bool isValidPitch(int midiPitch) { return midiPitch >= 0 && midiPitch < numPitches; }
+    void notify(Range<int> dirtyPitches);
+
+    std::array<std::vector<Measurement>, numPitches> history;
+    std::array<int, numPitches> indexOfPitch;
+    std::vector<int> pitches; // measured notes, ascending
+    int latestPitch = -1;
+    int64 version = 0;
+
+    ListenerList<Listener> listeners;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MeasurementStore)
+};
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    PeriodStorage.cpp
+    Chunked period length storage with a preallocated block pool
+
+  ==============================================================================
+*/
+
+#include "PeriodStorage.h"
+
+PeriodStorage::PeriodStorage(int size, int count)
+    : blockSize(jmax(1, size)), numBlocks(jmax(2, count))
+{
+    pool.resize(static_cast<size_t>(numBlocks));
+    for (auto& block : pool)
+        block.resize(static_cast<size_t>(blockSize));
+
+    activeBlocks.resize(static_cast<size_t>(numBlocks));
+    freeBlocks.resize(static_cast<size_t>(numBlocks));
+    clear();
+}
+
+void PeriodStorage::clear() noexcept
+{
+    for (int i = 0; i < numBlocks; ++i)
+        freeBlocks[static_cast<size_t>(i)] = i;
+
+    numFree = numBlocks;
+    activeHead = 0;
+    numActive = 0;
+    numPeriods = 0;
+    firstRetainedBlock = 0;
+}
+
+void PeriodStorage::add(double periodLength) noexcept
+{
+    const int offset = numPeriods % blockSize;
+
+    if (offset == 0)
+    {
+        // Pool exhausted, the oldest block goes back to it
+        if (numFree == 0)
+        {
+            freeBlocks[static_cast<size_t>(numFree++)] = activeBlocks[static_cast<size_t>(activeHead)];
+            activeHead = (activeHead + 1) % numBlocks;
+            numActive--;
+            firstRetainedBlock++;
+        }
+
+        activeBlocks[static_cast<size_t>((activeHead + numActive) % numBlocks)] = freeBlocks[static_cast<size_t>(--numFree)];
+        numActive++;
+    }
+
+    const int block = activeBlocks[static_cast<size_t>((activeHead + numActive - 1) % numBlocks)];
+    pool[static_cast<size_t>(block)][static_cast<size_t>(offset)] = periodLength;
+    numPeriods++;
+}
+
+double PeriodStorage::operator[](int index) const noexcept
+{
+    jassert(isRetained(index));
+
+    const int slot = index / blockSize - firstRetainedBlock;
+    const int block = activeBlocks[static_cast<size_t>((activeHead + slot) % numBlocks)];
+    return pool[static_cast<size_t>(block)][static_cast<size_t>(index % blockSize)];
+}
+
+void PeriodStorage::copyRetained(std::vector<double>& destination, int fromIndex) const
+{
+    destination.clear();
+    for (int i = jmax(fromIndex, getFirstRetainedIndex()); i < numPeriods; ++i)
+        destination.push_back((*this)[i]);
+}
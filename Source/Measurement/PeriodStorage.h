@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    PeriodStorage.h
+    Chunked period length storage with a preallocated block pool
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+// Holds the period lengths of one measurement in fixed-size blocks taken from
+// a pool that is allocated once up front, so add() never allocates and is
+// safe to call from the audio thread. A measurement can run for any number of
+// periods: when the pool is used up, the oldest block is recycled. Callers
+// fold every period into streaming statistics as it is added, so recycled
+// periods are already accounted for and only the most recent ones stay
+// available for inspection.
+//
+// Like the rest of the measurement state in VCOTuner, the storage belongs to
+// the audio thread while a measurement runs and to the message thread after.
+class PeriodStorage
+{
+public:
+    explicit PeriodStorage(int blockSize = 1024, int numBlocks = 64);
+
+    // Returns all blocks to the pool
+    void clear() noexcept;
+
+    void add(double periodLength) noexcept;
+
+    // Number of periods added since clear(), including recycled ones
+    int size() const noexcept { return numPeriods; }
+
+    // Periods with an index below this have been recycled
+    int getFirstRetainedIndex() const noexcept { return firstRetainedBlock * blockSize; }
+    bool isRetained(int index) const noexcept { return index >= getFirstRetainedIndex() && index < numPeriods; }
+
+    // The index must be retained
+    double operator[](int index) const noexcept;
+
+    // Copies the retained periods from the given index on
+    void copyRetained(std::vector<double>& destination, int fromIndex = 0) const;
+
+    int getCapacity() const noexcept { return blockSize * numBlocks; }
+
+private:
+    const int blockSize;
+    const int numBlocks;
+
+    std::vector<std::vector<double>> pool;
+
+    // Blocks in use, oldest first, as a ring of pool indices
+    std::vector<int> activeBlocks;
+    int activeHead = 0;
+    int numActive = 0;
+
+    // Unused pool indices
+    std::vector<int> freeBlocks;
+    int numFree = 0;
+
+    int numPeriods = 0;
+    int firstRetainedBlock = 0;     // block number of activeBlocks[activeHead]
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PeriodStorage)
+};
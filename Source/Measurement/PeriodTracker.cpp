@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    PeriodTracker.cpp
+    Per-period frequency tracking on a single input channel
+
+  ==============================================================================
+*/
+
+#include "PeriodTracker.h"
+
+PeriodTracker::PeriodTracker(int fifoCapacity)
+    : fifo(fifoCapacity), buffer(static_cast<size_t>(fifoCapacity))
+{
+}
+
+PeriodTracker::~PeriodTracker()
+{
+}
+
+void PeriodTracker::start()
+{
+    resetRequested.store(true);
+    active.store(true);
+
+    // discard anything left over from a previous run (only the reader side of
+    // the FIFO may be touched from here)
+    fifo.finishedRead(fifo.getNumReady());
+    droppedPeriods.store(0);
+}
+
+void PeriodTracker::stop()
+{
+    active.store(false);
+}
+
+int PeriodTracker::readPeriods(std::vector<Period>& destination)
+{
+    const int numReady = fifo.getNumReady();
+    if (numReady <= 0)
+        return 0;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numReady, start1, size1, start2, size2);
+
+    destination.insert(destination.end(), buffer.begin() + start1, buffer.begin() + start1 + size1);
+    if (size2 > 0)
+        destination.insert(destination.end(), buffer.begin() + start2, buffer.begin() + start2 + size2);
+
+    fifo.finishedRead(size1 + size2);
+    return size1 + size2;
+}
+
+void PeriodTracker::processBlock(const float* input, int numSamples, int64 blockStartPosition)
+{
+    if (!active.load() || input == nullptr)
+        return;
+
+    if (resetRequested.exchange(false))
+    {
+        // the first crossing after a restart only marks the beginning of a period
+        lastCrossing = -1.0;
+        lastSample = input[0];
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float currentSample = input[i];
+
+        if (lastSample < 0.0f && currentSample >= 0.0f)
+        {
+            // linear interpolation between the sample before and after the crossing
+            const double fraction = lastSample / (double) (lastSample - currentSample);
+            const double crossing = (double) (blockStartPosition + i - 1) + fraction;
+
+            if (lastCrossing >= 0.0)
+            {
+                int start1, size1, start2, size2;
+                fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+                if (size1 > 0)
+                {
+                    buffer[(size_t) start1] = { crossing, crossing - lastCrossing };
+                    fifo.finishedWrite(1);
+                }
+                else
+                {
+                    droppedPeriods.fetch_add(1);
+                }
+            }
+
+            lastCrossing = crossing;
+        }
+
+        lastSample = currentSample;
+    }
+}
@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    PeriodTracker.h
+    Per-period frequency tracking on a single input channel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+
+// Detects every rising zero crossing on one input channel and hands the
+// resulting period lengths to the message thread through a lock-free FIFO.
+// Unlike the measurement state machine in VCOTuner, the tracker never stops on
+// its own, so it can follow an oscillator whose pitch changes continuously.
+class PeriodTracker
+{
+public:
+    struct Period
+    {
+        double position = 0.0;  // end of the period on the CV output sample clock
+        double length = 0.0;    // period length in samples
+    };
+
+    explicit PeriodTracker(int fifoCapacity = 32768);
+    ~PeriodTracker();
+
+    // Message thread
+    void start();
+    void stop();
+    bool isTracking() const { return active.load(); }
+
+    // Appends all periods detected since the last call, returns the number added
+    int readPeriods(std::vector<Period>& destination);
+
+    // Number of periods lost because the FIFO was full since start()
+    int getNumDroppedPeriods() const { return droppedPeriods.load(); }
+
+    // Audio thread - blockStartPosition is the CV output sample clock
+    // value that corresponds to the first sample of this block
+    void processBlock(const float* input, int numSamples, int64 blockStartPosition);
+
+private:
+    AbstractFifo fifo;
+    std::vector<Period> buffer;
+
+    std::atomic<bool> active{false};
+    std::atomic<bool> resetRequested{false};
+    std::atomic<int> droppedPeriods{0};
+
+    // Only accessed from the audio thread
+    float lastSample = 0.0f;
+    double lastCrossing = -1.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PeriodTracker)
+};
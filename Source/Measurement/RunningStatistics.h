@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    RunningStatistics.h
+    Streaming mean / variance (Welford) without storing samples
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <cmath>
+#include <limits>
+
+// Numerically stable single-pass statistics. Cheap enough to update for every
+// audio sample, and two accumulators can be merged so partial results from
+// separate runs can be pooled.
+class RunningStatistics
+{
+public:
+    void reset() noexcept
+    {
+        count = 0;
+        mean = 0.0;
+        m2 = 0.0;
+        minimum = std::numeric_limits<double>::max();
+        maximum = std::numeric_limits<double>::lowest();
+    }
+
+    void add(double x) noexcept
+    {
+        ++count;
+        const double delta = x - mean;
+        mean += delta / static_cast<double>(count);
+        m2 += delta * (x - mean);
+        minimum = jmin(minimum, x);
+        maximum = jmax(maximum, x);
+    }
+
+    // Rebuilds an accumulator from a summary, e.g. one measurement that only
+    // reported its count, mean and standard deviation
+    static RunningStatistics fromSummary(int64 count, double mean, double standardDeviation) noexcept
+    {
+        RunningStatistics s;
+        if (count <= 0)
+            return s;
+
+        s.count = count;
+        s.mean = mean;
+        s.m2 = standardDeviation * standardDeviation * static_cast<double>(jmax((int64) 0, count - 1));
+        s.minimum = mean;
+        s.maximum = mean;
+        return s;
+    }
+
+    // Chan et al. parallel combination
+    void merge(const RunningStatistics& other) noexcept
+    {
+        if (other.count == 0)
+            return;
+
+        if (count == 0)
+        {
+            *this = other;
+            return;
+        }
+
+        const double total = static_cast<double>(count + other.count);
+        const double delta = other.mean - mean;
+
+        mean += delta * static_cast<double>(other.count) / total;
+        m2 += other.m2 + delta * delta * static_cast<double>(count) * static_cast<double>(other.count) / total;
+        count += other.count;
+        minimum = jmin(minimum, other.minimum);
+        maximum = jmax(maximum, other.maximum);
+    }
+
+    int64 getCount() const noexcept { return count; }
+    double getMean() const noexcept { return mean; }
+    double getMin() const noexcept { return count > 0 ? minimum : 0.0; }
+    double getMax() const noexcept { return count > 0 ? maximum : 0.0; }
+
+    // Sample variance (n - 1)
+    double getVariance() const noexcept { return count > 1 ? m2 / static_cast<double>(count - 1) : 0.0; }
+    double getStandardDeviation() const noexcept { return std::sqrt(getVariance()); }
+
+    // Standard error of the mean
+    double getStandardError() const noexcept
+    {
+        return count > 1 ? std::sqrt(getVariance() / static_cast<double>(count)) : 0.0;
+    }
+
+private:
+    int64 count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    double minimum = std::numeric_limits<double>::max();
+    double maximum = std::numeric_limits<double>::lowest();
+};
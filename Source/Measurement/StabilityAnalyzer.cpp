@@ -0,0 +1,159 @@
+/*
+  ==============================================================================
+
+    StabilityAnalyzer.cpp
+    Allan deviation and jitter spectrum of captured period sequences
+
+  ==============================================================================
+*/
+
+#include "StabilityAnalyzer.h"
+#include <cmath>
+
+StabilityAnalyzer::StabilityAnalyzer(std::vector<double> periodLengths, double rate)
+    : periods(std::move(periodLengths)), sampleRate(rate)
+{
+    if (periods.empty() || sampleRate <= 0.0)
+        return;
+
+    double sum = 0.0;
+    for (double p : periods)
+        sum += p;
+    meanPeriod = sum / static_cast<double>(periods.size());
+
+    // x[k] = sum of (period - mean) over the first k periods. Subtracting the
+    // mean first keeps the running sum small, so doubles stay exact enough
+    // even after hours of periods.
+    phase.resize(periods.size() + 1);
+    phase[0] = 0.0;
+    for (size_t i = 0; i < periods.size(); ++i)
+        phase[i + 1] = phase[i] + (periods[i] - meanPeriod);
+}
+
+std::vector<double> StabilityAnalyzer::getPeriodLengths(const std::vector<PeriodTracker::Period>& trackedPeriods)
+{
+    std::vector<double> lengths;
+    lengths.reserve(trackedPeriods.size());
+    for (const auto& p : trackedPeriods)
+        lengths.push_back(p.length);
+    return lengths;
+}
+
+double StabilityAnalyzer::getPeriodJitter() const
+{
+    if (periods.size() < 2)
+        return 0.0;
+
+    double sumSquares = 0.0;
+    for (double p : periods)
+        sumSquares += (p - meanPeriod) * (p - meanPeriod);
+
+    return std::sqrt(sumSquares / static_cast<double>(periods.size() - 1)) / sampleRate;
+}
+
+StabilityAnalyzer::AllanPoint StabilityAnalyzer::computeAllanDeviationAt(int m) const
+{
+    AllanPoint point;
+    const int numPhase = static_cast<int>(phase.size());
+    if (m < 1 || numPhase <= 2 * m || meanPeriod <= 0.0)
+        return point;
+
+    // Overlapping estimator on phase data:
+    // sigma^2(tau) = sum (x[i+2m] - 2 x[i+m] + x[i])^2 / (2 tau^2 (N - 2m))
+    double sum = 0.0;
+    for (int i = 0; i + 2 * m < numPhase; ++i)
+    {
+        const double d = phase[static_cast<size_t>(i + 2 * m)] - 2.0 * phase[static_cast<size_t>(i + m)] + phase[static_cast<size_t>(i)];
+        sum += d * d;
+    }
+
+    // Phase and tau are both in samples here, the ratio is dimensionless
+    const double tauSamples = m * meanPeriod;
+    point.numTerms = numPhase - 2 * m;
+    point.tau = tauSamples / sampleRate;
+    point.deviation = std::sqrt(sum / (2.0 * tauSamples * tauSamples * point.numTerms));
+    return point;
+}
+
+std::vector<StabilityAnalyzer::AllanPoint> StabilityAnalyzer::computeAllanDeviation(int pointsPerDecade) const
+{
+    std::vector<AllanPoint> result;
+    const int maxM = static_cast<int>(phase.size()) / 3;
+    const double step = std::pow(10.0, 1.0 / jmax(1, pointsPerDecade));
+
+    int lastM = 0;
+    for (double mf = 1.0; mf <= maxM; mf *= step)
+    {
+        const int m = static_cast<int>(std::round(mf));
+        if (m == lastM)
+            continue;
+
+        lastM = m;
+        result.push_back(computeAllanDeviationAt(m));
+    }
+
+    return result;
+}
+
+std::vector<StabilityAnalyzer::SpectrumBin> StabilityAnalyzer::computeJitterSpectrum(int fftOrder) const
+{
+    std::vector<SpectrumBin> result;
+
+    // Shorter captures get a shorter transform rather than no spectrum
+    int order = fftOrder;
+    while (order > 4 && (static_cast<size_t>(1) << order) > periods.size())
+        --order;
+
+    const int size = 1 << order;
+    if (static_cast<int>(periods.size()) < size || meanPeriod <= 0.0)
+        return result;
+
+    dsp::FFT fft(order);
+    std::vector<float> window(static_cast<size_t>(size));
+    dsp::WindowingFunction<float>::fillWindowingTables(window.data(), static_cast<size_t>(size),
+                                                        dsp::WindowingFunction<float>::hann, false);
+
+    double windowPower = 0.0;
+    for (float w : window)
+        windowPower += static_cast<double>(w) * w;
+
+    std::vector<double> accumulated(static_cast<size_t>(size / 2 + 1), 0.0);
+    std::vector<float> buffer(static_cast<size_t>(2 * size));
+    int numSegments = 0;
+
+    for (size_t start = 0; start + static_cast<size_t>(size) <= periods.size(); start += static_cast<size_t>(size / 2))
+    {
+        // Remove the segment mean so slow drift doesn't leak into the low bins
+        double segmentMean = 0.0;
+        for (int i = 0; i < size; ++i)
+            segmentMean += periods[start + static_cast<size_t>(i)];
+        segmentMean /= size;
+
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        for (int i = 0; i < size; ++i)
+            buffer[static_cast<size_t>(i)] = static_cast<float>((periods[start + static_cast<size_t>(i)] - segmentMean) / sampleRate * 1.0e6)
+                                             * window[static_cast<size_t>(i)];
+
+        fft.performFrequencyOnlyForwardTransform(buffer.data());
+
+        for (int k = 0; k <= size / 2; ++k)
+            accumulated[static_cast<size_t>(k)] += static_cast<double>(buffer[static_cast<size_t>(k)]) * buffer[static_cast<size_t>(k)];
+
+        numSegments++;
+    }
+
+    // One-sided density. The input was scaled to microseconds for float precision.
+    const double rate = sampleRate / meanPeriod;
+    const double scale = 1.0e-12 / (rate * windowPower * numSegments);
+
+    result.reserve(accumulated.size());
+    for (int k = 0; k <= size / 2; ++k)
+    {
+        SpectrumBin bin;
+        bin.frequency = k * rate / size;
+        bin.psd = accumulated[static_cast<size_t>(k)] * scale * ((k == 0 || k == size / 2) ? 1.0 : 2.0);
+        result.push_back(bin);
+    }
+
+    return result;
+}
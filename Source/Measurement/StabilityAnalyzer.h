@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    StabilityAnalyzer.h
+    Allan deviation and jitter spectrum of captured period sequences
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "PeriodTracker.h"
+
+// Short-term stability of an oscillator from a long run of consecutive
+// period lengths, as captured by a PeriodTracker. Both analyses work on the
+// time error of each zero crossing against an ideal clock running at the mean
+// period, which is the prefix sum of the period fluctuations. That keeps the
+// overlapping Allan deviation at O(n) per averaging time, so captures with
+// millions of periods are fine.
+class StabilityAnalyzer
+{
+public:
+    struct AllanPoint
+    {
+        double tau = 0.0;           // averaging time in seconds
+        double deviation = 0.0;     // overlapping Allan deviation, fractional frequency
+        int numTerms = 0;           // second differences that went into this point
+    };
+
+    struct SpectrumBin
+    {
+        double frequency = 0.0;     // Hz, up to half the oscillator frequency
+        double psd = 0.0;           // period fluctuation power density, s^2/Hz
+    };
+
+    // Takes period lengths in samples at the given sample rate
+    StabilityAnalyzer(std::vector<double> periodLengths, double sampleRate);
+
+    static std::vector<double> getPeriodLengths(const std::vector<PeriodTracker::Period>& periods);
+
+    int getNumPeriods() const { return static_cast<int>(periods.size()); }
+    double getMeanPeriodSeconds() const { return meanPeriod / sampleRate; }
+    double getFrequency() const { return meanPeriod > 0.0 ? sampleRate / meanPeriod : 0.0; }
+
+    // RMS period jitter in seconds
+    double getPeriodJitter() const;
+
+    // Averaging times are multiples m of the mean period, spaced evenly on a
+    // log scale, up to a third of the capture so each point has enough terms
+    std::vector<AllanPoint> computeAllanDeviation(int pointsPerDecade = 10) const;
+    AllanPoint computeAllanDeviationAt(int m) const;
+
+    // Welch estimate with a Hann window and 50% overlap. The period sequence
+    // is treated as uniformly sampled at the mean oscillator frequency.
+    std::vector<SpectrumBin> computeJitterSpectrum(int fftOrder = 12) const;
+
+private:
+    std::vector<double> periods;    // in samples
+    std::vector<double> phase;      // time error of each crossing, in samples
+    double sampleRate;
+    double meanPeriod = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StabilityAnalyzer)
+};
@@ -208,7 +208,9 @@ void ReportDetailsEditorScreen::tunerFinished()
             return;
             break;
         case reMeasuringReference:
-            double initalReferenceFreq = tuner->getReferenceFrequency();
+            // with interleaved reference measurements, only the drift the
+            // model did not predict has ended up in the results
+            double initalReferenceFreq = tuner->getExpectedReferenceFrequency();
             double reMeasuredFreq = tuner->getSingleMeasurementResult();
             double pitchDrift = 12.0 * log(reMeasuredFreq / initalReferenceFreq) / log(2.0);
             
@@ -12,7 +12,10 @@
 
 
 ReportDisplayScreen::ReportDisplayScreen(VCOTuner* t, Visualizer* v, ReportCreatorWindow* p)
-: img(Image::RGB, 800, 600, true)
+: data(ReportRenderer::createFromTuner(*t)),
+  pool(1),
+  progress(0.0),
+  progressBar(progress)
 {
     tuner = t;
     visualizer = v;
@@ -20,47 +23,57 @@ ReportDisplayScreen::ReportDisplayScreen(VCOTuner* t, Visualizer* v, ReportCreat
 
     save.setButtonText("Save Report");
     save.addListener(this);
+    save.setEnabled(false);
     addAndMakeVisible(&save);
     
     close.setButtonText("Close");
     close.addListener(this);
     addAndMakeVisible(&close);
     
-    drawReport();
+    addAndMakeVisible(&progressBar);
+    
+    // render at the export resolution so the preview stays sharp on high-DPI displays
+    previewJob.reset(new ReportRenderJob(data, ReportRenderer::exportScale));
+    pool.addJob(previewJob.get(), false);
+    startTimer(50);
 }
 
 ReportDisplayScreen::~ReportDisplayScreen()
 {
-
+    stopTimer();
+    pool.removeAllJobs(true, 10000);
 }
 
 void ReportDisplayScreen::resized()
 {
     save.setBounds(10, 10, 60, 20);
     close.setBounds(getWidth() - 10 - 60, 10, 60, 20);
+    progressBar.setBounds(80, 10, getWidth() - 160, 20);
 }
 
 void ReportDisplayScreen::buttonClicked (Button* bttn)
 {
     if (bttn == &save)
     {
-        // store as an image file (don't use native file chooser for linux - it crashes on some systems)
+        // store as an image or vector file (don't use native file chooser for linux - it crashes on some systems)
 #ifdef JUCE_LINUX
-        FileChooser fileChooser("Save report ... ", File(), "*.png", false);
+        FileChooser fileChooser("Save report ... ", File(), "*.png;*.eps", false);
 #else
-        FileChooser fileChooser("Save report ... ", File(), "*.png", true);
+        FileChooser fileChooser("Save report ... ", File(), "*.png;*.eps", true);
 #endif
         if (fileChooser.browseForFileToSave(true))
         {
-            if (fileChooser.getResult().existsAsFile())
-                fileChooser.getResult().deleteFile();
+            File file = fileChooser.getResult();
+            if (!ReportRenderer::isVectorFormat(file))
+                file = file.withFileExtension("png");
             
-            FileOutputStream stream(fileChooser.getResult().withFileExtension("png"));
-            PNGImageFormat format;
-            if (!format.writeImageToStream(img, stream))
-            {
-                NativeMessageBox::showMessageBox(AlertWindow::WarningIcon, "Error!", "Error writing the report image file!");
-            }
+            // encoding a high resolution image takes a while, so it's done on the pool as well
+            saveJob.reset(new ReportRenderJob(data, ReportRenderer::exportScale, file));
+            pool.addJob(saveJob.get(), false);
+            save.setEnabled(false);
+            progress = 0.0;
+            progressBar.setVisible(true);
+            startTimer(50);
         }
     }
     else if (bttn == &close)
@@ -70,84 +83,43 @@ void ReportDisplayScreen::buttonClicked (Button* bttn)
     }
 }
 
-void ReportDisplayScreen::paint(juce::Graphics &g)
+void ReportDisplayScreen::timerCallback()
 {
-    g.drawImageAt(img, 0, 40);
+    ReportRenderJob* job = saveJob != nullptr ? saveJob.get() : previewJob.get();
+    progress = job->getProgress();
+    // the pool still holds the job for a moment after it is done
+    if (!job->isDone() || pool.contains(job))
+        return;
+    
+    stopTimer();
+    progressBar.setVisible(false);
+    save.setEnabled(true);
+    
+    if (job == previewJob.get())
+    {
+        img = previewJob->getImage();
+        repaint();
+    }
+    else
+    {
+        if (saveJob->getError().isNotEmpty())
+            NativeMessageBox::showMessageBox(AlertWindow::WarningIcon, "Error!", saveJob->getError());
+        saveJob.reset();
+    }
 }
 
-void ReportDisplayScreen::drawReport()
+void ReportDisplayScreen::paint(juce::Graphics &g)
 {
-    Graphics g(img);
-    
-    g.fillAll(Colours::white);
-    
-    g.setColour(Colours::black);
-    
-    const int contentHeight = 16;
-    const int lineHeight = contentHeight + contentHeight/4;
-    Rectangle<int> leftColumnLabels(10, 10, 170, contentHeight);
-    Rectangle<int> leftColumnContent(170, 10, 230, contentHeight);
-    Rectangle<int> rightColumnLabels(420, 10, 120, contentHeight);
-    Rectangle<int> rightColumnContent(540, 10, 800 - 10 - 540, contentHeight);
-    
-    
-    String dutBrand = getAppProperties().getUserSettings()->getValue("DUT-Brand");
-    String dutType = getAppProperties().getUserSettings()->getValue("DUT-Device");
-    String interfaceBrand = getAppProperties().getUserSettings()->getValue("Interface-Brand");
-    String interfaceType = getAppProperties().getUserSettings()->getValue("Interface-Device");
-    String notes = getAppProperties().getUserSettings()->getValue("Notes");
-    double initalReferenceFreq = tuner->getReferenceFrequency();
-    double reMeasuredFreq = tuner->getSingleMeasurementResult();
-    double pitchDrift = 12.0 * log(reMeasuredFreq / initalReferenceFreq) / log(2.0);
-    String driftString;
-    if (std::abs(pitchDrift) >= 1)
-        driftString = String(pitchDrift, 2) + " semitones";
-    else if (String(std::abs(pitchDrift), 2) == "1.00")
-        driftString = String(pitchDrift, 2) + " semitone";
+    Rectangle<float> reportArea(0.0f, 40.0f, (float) ReportRenderer::width, (float) ReportRenderer::height);
+    if (img.isValid())
+    {
+        g.drawImage(img, reportArea);
+    }
     else
-        driftString = String(pitchDrift * 100, 1) + " cents";
-    if (std::abs(pitchDrift) >= 2)
-        driftString += " (Holy crap! R u ok?)";
-    else if (std::abs(pitchDrift) >= 0.5)
-        driftString += " (Oh dear.)";
-    else if (std::abs(pitchDrift) > 0.02)
-        driftString += " (not quite stable)";
-    
-    g.drawText("Device under test:", leftColumnLabels, Justification::topLeft);
-    g.drawText("'" + dutType + "' (" + dutBrand + ")", leftColumnContent, Justification::topLeft);
-    leftColumnLabels.translate(0, lineHeight);
-    leftColumnContent.translate(0, lineHeight);
-    
-    g.drawText("CV Interface:", leftColumnLabels, Justification::topLeft);
-    g.drawText("'" + interfaceType + "' (" + interfaceBrand + ")", leftColumnContent, Justification::topLeft);
-    leftColumnLabels.translate(0, lineHeight);
-    leftColumnContent.translate(0, lineHeight);
-    
-    g.drawText("Samplerate:", leftColumnLabels, Justification::topLeft);
-    g.drawText(String(tuner->getCurrentSampleRate() / 1000) + " kHz", leftColumnContent, Justification::topLeft);
-    leftColumnLabels.translate(0, lineHeight);
-    leftColumnContent.translate(0, lineHeight);
-    
-    g.drawText("Reference frequency:", leftColumnLabels, Justification::topLeft);
-    g.drawText(String(tuner->getReferenceFrequency()) + " Hz", leftColumnContent, Justification::topLeft);
-    leftColumnLabels.translate(0, lineHeight);
-    leftColumnContent.translate(0, lineHeight);
-    
-    g.drawText("Drift during measurement:", leftColumnLabels, Justification::topLeft);
-    g.drawText(driftString, leftColumnContent, Justification::topLeft);
-    leftColumnLabels.translate(0, lineHeight);
-    leftColumnContent.translate(0, lineHeight);
-    
-    g.drawText("Notes:", rightColumnLabels, Justification::topLeft);
-    Rectangle<int> noteArea = rightColumnContent.withHeight(lineHeight + contentHeight);
-    g.drawMultiLineText(notes, noteArea.getX(), noteArea.getY() + juce::roundToInt(g.getCurrentFont().getHeight()), noteArea.getWidth());
-    
-    g.saveState();
-    int bottom = jmax(leftColumnLabels.getBottom(), leftColumnContent.getBottom(),
-                      rightColumnLabels.getBottom(), rightColumnContent.getBottom());
-    Rectangle<int> graphArea(10, bottom + 10, img.getWidth() - 20, img.getHeight() - 10 - bottom - 10);
-    g.reduceClipRegion(graphArea);
-    g.setOrigin(graphArea.getTopLeft());
-    visualizer->paintWithFixedScaling(g, graphArea.getWidth(), graphArea.getHeight(), -0.15, 0.15);
-    g.restoreState();
+    {
+        g.setColour(Colours::white);
+        g.fillRect(reportArea);
+        g.setColour(Colours::grey);
+        g.drawText("Rendering report...", reportArea, Justification::centred);
+    }
 }
@@ -12,9 +12,14 @@
 #define REPORTDISPLAYSCREEN_H_INCLUDED
 
 #include "ReportCreatorWindow.h"
+#include "ReportRenderer.h"
 
+/** Shows the report while it is rendered on a background thread and saves
+    it as an image or a vector file without blocking the UI.
+ */
 class ReportDisplayScreen: public Component,
-                           public Button::Listener
+                           public Button::Listener,
+                           private Timer
 {
 public:
     ReportDisplayScreen(VCOTuner* t, Visualizer* v, ReportCreatorWindow* parent);
@@ -25,13 +30,22 @@ public:
     void paint(Graphics& g) override;
     
 private:
-    void drawReport();
+    void timerCallback() override;
     
     VCOTuner* tuner;
     Visualizer* visualizer;
     ReportCreatorWindow* parent;
   
+    /** snapshot of the report, taken when the screen opens */
+    const ReportRenderer::ReportData data;
+    
+    ThreadPool pool;
+    std::unique_ptr<ReportRenderJob> previewJob;
+    std::unique_ptr<ReportRenderJob> saveJob;
+    
     Image img;
+    double progress;
+    ProgressBar progressBar;
     TextButton save;
     TextButton close;
 };
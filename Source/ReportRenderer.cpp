@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+    ReportRenderer.cpp
+    Offscreen report rendering to images and vector files
+
+  ==============================================================================
+*/
+
+#include "ReportRenderer.h"
+#include "ChartPainter.h"
+#include "Calibration/CalibrationTable.h"
+
+ApplicationProperties& getAppProperties();
+
+ReportRenderer::ReportData ReportRenderer::createFromTuner(VCOTuner& tuner)
+{
+    ReportData data;
+
+    String dutBrand = getAppProperties().getUserSettings()->getValue("DUT-Brand");
+    String dutType = getAppProperties().getUserSettings()->getValue("DUT-Device");
+    String interfaceBrand = getAppProperties().getUserSettings()->getValue("Interface-Brand");
+    String interfaceType = getAppProperties().getUserSettings()->getValue("Interface-Device");
+    double initalReferenceFreq = tuner.getReferenceFrequency();
+    double reMeasuredFreq = tuner.getSingleMeasurementResult();
+    double pitchDrift = 12.0 * log(reMeasuredFreq / initalReferenceFreq) / log(2.0);
+    String driftString;
+    if (std::abs(pitchDrift) >= 1)
+        driftString = String(pitchDrift, 2) + " semitones";
+    else if (String(std::abs(pitchDrift), 2) == "1.00")
+        driftString = String(pitchDrift, 2) + " semitone";
+    else
+        driftString = String(pitchDrift * 100, 1) + " cents";
+    if (std::abs(pitchDrift) >= 2)
+        driftString += " (Holy crap! R u ok?)";
+    else if (std::abs(pitchDrift) >= 0.5)
+        driftString += " (Oh dear.)";
+    else if (std::abs(pitchDrift) > 0.02)
+        driftString += " (not quite stable)";
+
+    data.title = dutBrand + " " + dutType;
+    data.details.emplace_back("Device under test:", "'" + dutType + "' (" + dutBrand + ")");
+    data.details.emplace_back("CV Interface:", "'" + interfaceType + "' (" + interfaceBrand + ")");
+    data.details.emplace_back("Samplerate:", String(tuner.getCurrentSampleRate() / 1000) + " kHz");
+    data.details.emplace_back("Reference frequency:", String(tuner.getReferenceFrequency()) + " Hz");
+    data.details.emplace_back("Drift during measurement:", driftString);
+    data.notes = getAppProperties().getUserSettings()->getValue("Notes");
+    data.referencePitch = tuner.getReferencePitch();
+
+    const MeasurementStore& store = tuner.getMeasurementStore();
+    data.measurements.reserve(static_cast<size_t>(store.size()));
+    for (int i = 0; i < store.size(); ++i)
+        data.measurements.push_back(store.getAt(i));
+
+    return data;
+}
+
+ReportRenderer::ReportData ReportRenderer::createFromCalibration(const CalibrationTable& table)
+{
+    ReportData data;
+
+    data.title = table.getDeviceBrand() + " " + table.getDeviceName();
+    data.details.emplace_back("Device under test:", "'" + table.getDeviceName() + "' (" + table.getDeviceBrand() + ")");
+    data.details.emplace_back("CV Interface:", "'" + table.getInterfaceName() + "'");
+    data.details.emplace_back("Calibrated:", table.getCalibrationDate().toString(true, true, false));
+    data.details.emplace_back("Voltage standard:", table.getVoltageStandard());
+    data.details.emplace_back("Pitch error:", "RMS " + String(table.getRMSErrorCents(), 1) + " cents, max "
+                                              + String(table.getMaxErrorCents(), 1) + " cents");
+    data.notes = table.getNotes();
+
+    // the chart shows the error that remains after the calibration
+    data.measurements.reserve(table.getAllEntries().size());
+    for (const auto& entry : table.getAllEntries())
+    {
+        VCOTuner::measurement_t m;
+        m.midiPitch = entry.midiNote;
+        m.frequency = entry.measuredFrequency;
+        m.pitchOffset = entry.errorCents / 100.0;
+        m.pitch = entry.midiNote + m.pitchOffset;
+        m.pitchDeviation = entry.stdDevCents / 100.0;
+        m.freqDeviation = entry.measuredFrequency * (std::pow(2.0, entry.stdDevCents / 1200.0) - 1.0);
+        m.numMeasurements = 0;
+        m.referenceDrift = 0.0;
+        m.timestamp = table.getCalibrationDate();
+        data.measurements.push_back(m);
+    }
+
+    return data;
+}
+
+void ReportRenderer::draw(Graphics& g, const ReportData& data)
+{
+    g.fillAll(Colours::white);
+
+    g.setColour(Colours::black);
+
+    const int contentHeight = 16;
+    const int lineHeight = contentHeight + contentHeight/4;
+    Rectangle<int> leftColumnLabels(10, 10, 170, contentHeight);
+    Rectangle<int> leftColumnContent(170, 10, 230, contentHeight);
+    Rectangle<int> rightColumnLabels(420, 10, 120, contentHeight);
+    Rectangle<int> rightColumnContent(540, 10, width - 10 - 540, contentHeight);
+
+    for (const auto& line : data.details)
+    {
+        g.drawText(line.first, leftColumnLabels, Justification::topLeft);
+        g.drawText(line.second, leftColumnContent, Justification::topLeft);
+        leftColumnLabels.translate(0, lineHeight);
+        leftColumnContent.translate(0, lineHeight);
+    }
+
+    g.drawText("Notes:", rightColumnLabels, Justification::topLeft);
+    Rectangle<int> noteArea = rightColumnContent.withHeight(lineHeight + contentHeight);
+    g.drawMultiLineText(data.notes, noteArea.getX(), noteArea.getY() + juce::roundToInt(g.getCurrentFont().getHeight()), noteArea.getWidth());
+
+    // the chart draws a private copy of the measurements, which is safe on any thread
+    MeasurementStore store;
+    for (const auto& m : data.measurements)
+        store.add(m);
+    ChartPainter painter(store);
+    painter.setReferencePitch(data.referencePitch);
+
+    g.saveState();
+    int bottom = jmax(leftColumnLabels.getBottom(), leftColumnContent.getBottom(),
+                      rightColumnLabels.getBottom(), rightColumnContent.getBottom());
+    Rectangle<int> graphArea(10, bottom + 10, width - 20, height - 10 - bottom - 10);
+    g.reduceClipRegion(graphArea);
+    g.setOrigin(graphArea.getTopLeft());
+    painter.paintWithFixedScaling(g, graphArea.getWidth(), graphArea.getHeight(), -0.15, 0.15);
+    g.restoreState();
+}
+
+Image ReportRenderer::renderImage(const ReportData& data, float scale)
+{
+    Image image(Image::RGB, roundToInt(width * scale), roundToInt(height * scale), true);
+    Graphics g(image);
+    g.addTransform(AffineTransform::scale(scale));
+    draw(g, data);
+    return image;
+}
+
+String ReportRenderer::writeToFile(const ReportData& data, const File& file, float scale)
+{
+    if (isVectorFormat(file))
+        return writeVectorFile(data, file);
+
+    return writeImageFile(renderImage(data, scale), file);
+}
+
+String ReportRenderer::writeImageFile(const Image& image, const File& file)
+{
+    if (file.existsAsFile() && !file.deleteFile())
+        return "Can't replace " + file.getFullPathName();
+
+    FileOutputStream stream(file);
+    if (stream.failedToOpen())
+        return "Can't write " + file.getFullPathName();
+
+    PNGImageFormat format;
+    if (!format.writeImageToStream(image, stream))
+        return "Error writing the report image file!";
+
+    stream.flush();
+    return stream.getStatus().getErrorMessage();
+}
+
+String ReportRenderer::writeVectorFile(const ReportData& data, const File& file)
+{
+    if (file.existsAsFile() && !file.deleteFile())
+        return "Can't replace " + file.getFullPathName();
+
+    FileOutputStream stream(file);
+    if (stream.failedToOpen())
+        return "Can't write " + file.getFullPathName();
+
+    {
+        // the renderer finishes the document when it is deleted
+        LowLevelGraphicsPostScriptRenderer renderer(stream, data.title, width, height);
+        Graphics g(renderer);
+        draw(g, data);
+    }
+
+    stream.flush();
+    return stream.getStatus().getErrorMessage();
+}
+
+//==============================================================================
+ReportRenderJob::ReportRenderJob(const ReportRenderer::ReportData& d, float s, const File& file)
+    : ThreadPoolJob("Report"), data(d), scale(s), outputFile(file)
+{
+}
+
+ThreadPoolJob::JobStatus ReportRenderJob::runJob()
+{
+    if (outputFile != File() && ReportRenderer::isVectorFormat(outputFile))
+    {
+        error = ReportRenderer::writeVectorFile(data, outputFile);
+    }
+    else
+    {
+        image = ReportRenderer::renderImage(data, scale);
+        progress = 0.5f;
+
+        if (outputFile != File() && !shouldExit())
+            error = ReportRenderer::writeImageFile(image, outputFile);
+    }
+
+    progress = 1.0f;
+    done = true;
+    return jobHasFinished;
+}
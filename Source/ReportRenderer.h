@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    ReportRenderer.h
+    Offscreen report rendering to images and vector files
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <utility>
+#include <vector>
+#include "VCOTuner.h"
+
+class CalibrationTable;
+
+// Draws a measurement report from a snapshot of its data, so it can be
+// rendered and written on a background thread. Reports are written as PNG
+// images or, for a .eps file, as vector PostScript.
+class ReportRenderer
+{
+public:
+    static const int width = 800;
+    static const int height = 600;
+
+    // Pixels per point of saved images
+    static constexpr float exportScale = 2.0f;
+
+    // Everything a report shows, copied on the message thread
+    struct ReportData
+    {
+        String title;                                   // used for file names and document titles
+        std::vector<std::pair<String, String>> details; // label and text of the lines at the top
+        String notes;
+        int referencePitch = -1;
+        std::vector<VCOTuner::measurement_t> measurements;
+    };
+
+    // The report of the sweep the tuner has just finished. Message thread only.
+    static ReportData createFromTuner(VCOTuner& tuner);
+
+    // The report of a stored calibration
+    static ReportData createFromCalibration(const CalibrationTable& table);
+
+    // Draws the report into a width x height area
+    static void draw(Graphics& g, const ReportData& data);
+
+    // scale is the number of pixels per point, 2 for high-DPI output
+    static Image renderImage(const ReportData& data, float scale);
+
+    // Writes a PNG image, or PostScript for a .eps file. Returns an error message on failure.
+    static String writeToFile(const ReportData& data, const File& file, float scale);
+
+    static String writeImageFile(const Image& image, const File& file);
+    static String writeVectorFile(const ReportData& data, const File& file);
+
+    static bool isVectorFormat(const File& file) { return file.hasFileExtension("eps"); }
+};
+
+// Renders one report on a ThreadPool and, if a file is given, writes it.
+// The owner polls getProgress() and isDone() from the message thread.
+class ReportRenderJob : public ThreadPoolJob
+{
+public:
+    ReportRenderJob(const ReportRenderer::ReportData& data, float scale, const File& outputFile = File());
+
+    JobStatus runJob() override;
+
+    float getProgress() const { return progress.load(); }
+    bool isDone() const { return done.load(); }
+
+    // Only valid once isDone() returns true
+    const Image& getImage() const { return image; }
+    const String& getError() const { return error; }
+    const File& getOutputFile() const { return outputFile; }
+
+private:
+    const ReportRenderer::ReportData data;
+    const float scale;
+    const File outputFile;
+
+    Image image;
+    String error;
+    std::atomic<float> progress { 0.0f };
+    std::atomic<bool> done { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReportRenderJob)
+};
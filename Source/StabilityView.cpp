@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+    StabilityView.cpp
+    Period capture control with Allan deviation and jitter spectrum plots
+
+  ==============================================================================
+*/
+
+#include "StabilityView.h"
+#include <cmath>
+
+StabilityView::StabilityView(VCOTuner& t) : tuner(t)
+{
+    captureButton.setButtonText("Start Capture");
+    captureButton.addListener(this);
+    addAndMakeVisible(captureButton);
+
+    tuner.addListener(this);
+}
+
+StabilityView::~StabilityView()
+{
+    stopTimer();
+    tuner.removeListener(this);
+}
+
+void StabilityView::resized()
+{
+    captureButton.setBounds(getLocalBounds().reduced(35).removeFromTop(30).removeFromRight(120));
+}
+
+void StabilityView::buttonClicked(Button* button)
+{
+    if (button != &captureButton)
+        return;
+
+    if (capturing)
+    {
+        tuner.stop();   // tunerStopped() analyses the capture
+        return;
+    }
+
+    tuner.startStabilityCapture((tuner.getLowestPitch() + tuner.getHighestPitch()) / 2);
+    capturing = true;
+    numPeriodsShown = 0;
+    numDroppedPeriods = 0;
+    captureButton.setButtonText("Stop Capture");
+    startTimerHz(4);
+    updateScheduler.requestRepaint();
+}
+
+void StabilityView::timerCallback()
+{
+    const int numPeriods = tuner.getNumCapturedPeriods();
+    const int numDropped = tuner.getNumDroppedCapturePeriods();
+    if (numPeriods != numPeriodsShown || numDropped != numDroppedPeriods)
+    {
+        numPeriodsShown = numPeriods;
+        numDroppedPeriods = numDropped;
+        updateScheduler.requestRepaint();
+    }
+}
+
+void StabilityView::tunerStopped()
+{
+    if (!capturing)
+        return;
+
+    capturing = false;
+    stopTimer();
+    captureButton.setButtonText("Start Capture");
+
+    allanDeviation.clear();
+    jitterSpectrum.clear();
+    numPeriodsAnalysed = 0;
+
+    // A capture with a gap can't be analysed, the view explains why
+    numDroppedPeriods = tuner.getNumDroppedCapturePeriods();
+    if (numDroppedPeriods > 0)
+    {
+        updateScheduler.requestRepaint();
+        return;
+    }
+
+    // O(n) per averaging time, fine on the message thread for captures of a few minutes
+    auto analysis = tuner.createStabilityAnalysis();
+    numPeriodsAnalysed = analysis->getNumPeriods();
+    frequency = analysis->getFrequency();
+    periodJitter = analysis->getPeriodJitter();
+
+    for (const auto& point : analysis->computeAllanDeviation())
+        allanDeviation.push_back({ point.tau, point.deviation });
+
+    for (const auto& bin : analysis->computeJitterSpectrum())
+        if (bin.frequency > 0.0)
+            jitterSpectrum.push_back({ bin.frequency, bin.psd });
+
+    updateScheduler.requestRepaint();
+}
+
+void StabilityView::paint(Graphics& g)
+{
+    g.fillAll(ModernLookAndFeel::Colors::background);
+
+    auto panelBounds = getLocalBounds().toFloat().reduced(15);
+    ModernLookAndFeel::drawPanel(g, panelBounds, 12.0f);
+    auto contentBounds = panelBounds.reduced(20);
+
+    auto headerArea = contentBounds.removeFromTop(30).withTrimmedRight(130.0f);
+    g.setColour(ModernLookAndFeel::Colors::textSecondary);
+    g.setFont(Font(12.0f));
+    if (capturing)
+        g.drawText("CAPTURING  " + String(numPeriodsShown) + " periods"
+                       + (numDroppedPeriods > 0 ? ", " + String(numDroppedPeriods) + " dropped" : String()),
+                   headerArea, Justification::centredLeft);
+    else if (numPeriodsAnalysed > 0)
+        g.drawText(String(numPeriodsAnalysed) + " periods at " + String(frequency, 2) + " Hz, RMS period jitter "
+                       + String(periodJitter * 1.0e9, 2) + " ns",
+                   headerArea, Justification::centredLeft);
+    else
+        g.drawText("STABILITY", headerArea, Justification::centredLeft);
+
+    if (capturing || allanDeviation.empty())
+    {
+        String message = "Capture the periods of the middle note to see its Allan deviation and jitter spectrum.";
+        if (numDroppedPeriods > 0)
+            message = String(numDroppedPeriods) + " periods were dropped, so the capture has a gap and can't be analysed."
+                      + (capturing ? String() : String(" Capture again."));
+        else if (capturing)
+            message = "Stop the capture to analyse it.";
+
+        g.setColour(ModernLookAndFeel::Colors::textDim);
+        g.setFont(Font(14.0f));
+        g.drawText(message, contentBounds, Justification::centred);
+        return;
+    }
+
+    contentBounds.removeFromTop(10);
+    auto left = contentBounds.removeFromLeft(contentBounds.getWidth() * 0.5f).withTrimmedRight(10.0f);
+    auto right = contentBounds.withTrimmedLeft(10.0f);
+    drawLogLogPlot(g, left, "Allan deviation", "s", allanDeviation);
+    drawLogLogPlot(g, right, "Period jitter spectrum (s^2/Hz)", "Hz", jitterSpectrum);
+}
+
+void StabilityView::drawLogLogPlot(Graphics& g, Rectangle<float> area, const String& title, const String& xUnit,
+                                   const std::vector<Point<double>>& points)
+{
+    g.setColour(ModernLookAndFeel::Colors::textSecondary);
+    g.setFont(Font(12.0f));
+    g.drawText(title, area.removeFromTop(20.0f), Justification::centredLeft);
+
+    auto plotArea = area.withTrimmedLeft(50.0f).withTrimmedBottom(20.0f);
+    g.setColour(ModernLookAndFeel::Colors::panelLight);
+    g.drawRect(plotArea);
+
+    // Whole decades around the positive values
+    double minX = 0.0, maxX = 0.0, minY = 0.0, maxY = 0.0;
+    bool first = true;
+    for (const auto& p : points)
+    {
+        if (p.x <= 0.0 || p.y <= 0.0)
+            continue;
+        const double x = std::log10(p.x), y = std::log10(p.y);
+        minX = first ? x : jmin(minX, x);
+        maxX = first ? x : jmax(maxX, x);
+        minY = first ? y : jmin(minY, y);
+        maxY = first ? y : jmax(maxY, y);
+        first = false;
+    }
+    if (first)
+        return;
+
+    minX = std::floor(minX);
+    maxX = jmax(minX + 1.0, std::ceil(maxX));
+    minY = std::floor(minY);
+    maxY = jmax(minY + 1.0, std::ceil(maxY));
+
+    auto xFor = [&] (double x) { return plotArea.getX() + static_cast<float>((x - minX) / (maxX - minX)) * plotArea.getWidth(); };
+    auto yFor = [&] (double y) { return plotArea.getBottom() - static_cast<float>((y - minY) / (maxY - minY)) * plotArea.getHeight(); };
+
+    // A grid line and label per decade
+    g.setFont(Font(11.0f));
+    for (int decade = static_cast<int>(minX); decade <= static_cast<int>(maxX); ++decade)
+    {
+        const float x = xFor(decade);
+        g.setColour(ModernLookAndFeel::Colors::panelLight);
+        g.drawVerticalLine(roundToInt(x), plotArea.getY(), plotArea.getBottom());
+        g.setColour(ModernLookAndFeel::Colors::textDim);
+        g.drawText("1e" + String(decade) + " " + xUnit, roundToInt(x - 35.0f), roundToInt(plotArea.getBottom() + 2.0f), 70, 16, Justification::centred);
+    }
+    for (int decade = static_cast<int>(minY); decade <= static_cast<int>(maxY); ++decade)
+    {
+        const float y = yFor(decade);
+        g.setColour(ModernLookAndFeel::Colors::panelLight);
+        g.drawHorizontalLine(roundToInt(y), plotArea.getX(), plotArea.getRight());
+        g.setColour(ModernLookAndFeel::Colors::textDim);
+        g.drawText("1e" + String(decade), roundToInt(plotArea.getX() - 50.0f), roundToInt(y - 8.0f), 45, 16, Justification::centredRight);
+    }
+
+    Path line;
+    for (const auto& p : points)
+    {
+        if (p.x <= 0.0 || p.y <= 0.0)
+            continue;
+        const float x = xFor(std::log10(p.x));
+        const float y = yFor(std::log10(p.y));
+        if (line.isEmpty())
+            line.startNewSubPath(x, y);
+        else
+            line.lineTo(x, y);
+    }
+    g.setColour(ModernLookAndFeel::Colors::accentAlt);
+    g.strokePath(line, PathStrokeType(1.5f));
+}
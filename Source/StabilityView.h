@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    StabilityView.h
+    Period capture control with Allan deviation and jitter spectrum plots
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "VCOTuner.h"
+#include "ModernLookAndFeel.h"
+#include "UpdateScheduler.h"
+
+// Starts and stops a stability capture of the note in the middle of the
+// tuner's range. While it runs, the number of captured periods is shown;
+// when it stops, the capture is analysed and the Allan deviation and the
+// jitter spectrum are drawn as log-log plots. A capture that lost periods
+// to a full FIFO is not analysed, its joined runs would corrupt both.
+class StabilityView : public Component,
+                      public VCOTuner::Listener,
+                      private Button::Listener,
+                      private Timer
+{
+public:
+    explicit StabilityView(VCOTuner& tuner);
+    ~StabilityView() override;
+
+    void paint(Graphics& g) override;
+    void resized() override;
+
+    void tunerStopped() override;
+
+private:
+    void buttonClicked(Button* button) override;
+    void timerCallback() override;
+
+    void drawLogLogPlot(Graphics& g, Rectangle<float> area, const String& title, const String& xUnit,
+                        const std::vector<Point<double>>& points);
+
+    VCOTuner& tuner;
+    TextButton captureButton;
+    bool capturing = false;
+    int numPeriodsShown = 0;
+    int numDroppedPeriods = 0;     // a capture with a gap isn't analysed
+
+    // Results of the last finished capture
+    int numPeriodsAnalysed = 0;
+    double frequency = 0.0;
+    double periodJitter = 0.0;
+    std::vector<Point<double>> allanDeviation;   // tau in s, deviation
+    std::vector<Point<double>> jitterSpectrum;   // Hz, s^2/Hz
+
+    UpdateScheduler updateScheduler { *this };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StabilityView)
+};
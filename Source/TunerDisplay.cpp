@@ -11,10 +11,12 @@
 
 TunerDisplay::TunerDisplay(VCOTuner* t) : tuner(t)
 {
+    tuner->getMeasurementStore().addListener(this);
 }
 
 TunerDisplay::~TunerDisplay()
 {
+    tuner->getMeasurementStore().removeListener(this);
 }
 
 void TunerDisplay::paint(Graphics& g)
@@ -167,6 +169,45 @@ void TunerDisplay::paint(Graphics& g)
     float periodMs = hasSignal ? 1000.0f / currentFrequency : 0.0f;
     drawSmallDataBox(g, dataCol4.reduced(3), "PERIOD",
                      hasSignal ? String(periodMs, 4) + " ms" : "-.---- ms");
+
+    // === WAVEFORM (only with the harmonic analysis enabled) ===
+    if (harmonics.valid && contentBounds.getHeight() > 60)
+    {
+        contentBounds.removeFromTop(10);
+        auto waveSection = contentBounds.removeFromTop(jmin(90.0f, contentBounds.getHeight()));
+        auto waveData = waveSection.removeFromLeft(waveSection.getWidth() * 0.5f);
+        float waveColWidth = waveData.getWidth() / 3.0f;
+
+        drawSmallDataBox(g, waveData.removeFromLeft(waveColWidth).reduced(3), "THD",
+                         String(harmonics.thd * 100.0, 2) + " %");
+        drawSmallDataBox(g, waveData.removeFromLeft(waveColWidth).reduced(3), "DC",
+                         String(harmonics.dcOffset, 4));
+        drawSmallDataBox(g, waveData.reduced(3), "PEAK-PEAK",
+                         String(harmonics.peakToPeak, 3));
+
+        drawHarmonics(g, waveSection.reduced(8, 4));
+    }
+}
+
+void TunerDisplay::drawHarmonics(Graphics& g, Rectangle<float> bounds)
+{
+    // One bar per harmonic, level relative to the fundamental from 0 to -60 dB
+    const float range = 60.0f;
+    const int n = jmax(1, harmonics.numHarmonics);
+    const float barWidth = bounds.getWidth() / n;
+
+    g.setColour(ModernLookAndFeel::Colors::panel);
+    g.fillRoundedRectangle(bounds, 4.0f);
+
+    for (int h = 1; h <= harmonics.numHarmonics; ++h)
+    {
+        float level = jlimit(0.0f, 1.0f, 1.0f + harmonics.getHarmonicDecibels(h) / range);
+        auto bar = Rectangle<float>(bounds.getX() + (h - 1) * barWidth, bounds.getY(), barWidth, bounds.getHeight()).reduced(1.5f, 0);
+        bar = bar.removeFromBottom(bar.getHeight() * level);
+
+        g.setColour(h == 1 ? ModernLookAndFeel::Colors::accent : ModernLookAndFeel::Colors::meter.withAlpha(0.7f));
+        g.fillRect(bar);
+    }
 }
 
 void TunerDisplay::drawMeasurementBox(Graphics& g, Rectangle<float> bounds, const String& label, const String& value, Colour valueColor)
@@ -275,12 +316,23 @@ void TunerDisplay::drawPrecisionMeter(Graphics& g, Rectangle<float> bounds)
     }
 }
 
-void TunerDisplay::newMeasurementReady(const VCOTuner::measurement_t& m)
+void TunerDisplay::newHarmonicAnalysisReady(const VCOTuner::measurement_t&, const HarmonicAnalyzer::Result& result)
 {
+    harmonics = result;
+    updateScheduler.requestRepaint();
+}
+
+void TunerDisplay::measurementsChanged(const MeasurementStore& store, Range<int>)
+{
+    // keep showing the last note when the store is cleared for a new sweep
+    if (store.isEmpty())
+        return;
+
+    const auto& m = store.getLatest();
     currentMidiNote = m.midiPitch;
     currentFrequency = (float)m.frequency;
     currentCents = (float)(m.pitchOffset * 100.0); // Convert semitones to cents
     currentDeviation = (float)m.pitchDeviation;
     hasSignal = true;
-    repaint();
+    updateScheduler.requestRepaint();
 }
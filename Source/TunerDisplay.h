@@ -11,10 +11,13 @@
 
 #include <JuceHeader.h>
 #include "VCOTuner.h"
+#include "Measurement/MeasurementStore.h"
 #include "ModernLookAndFeel.h"
+#include "UpdateScheduler.h"
 
 class TunerDisplay : public Component,
-                     public VCOTuner::Listener
+                     public VCOTuner::Listener,
+                     public MeasurementStore::Listener
 {
 public:
     TunerDisplay(VCOTuner* t);
@@ -26,16 +29,18 @@ public:
     // For consistency with Visualizer interface
     void clearCache() { hasSignal = false; repaint(); }
 
-    void newMeasurementReady(const VCOTuner::measurement_t& m) override;
+    void measurementsChanged(const MeasurementStore& store, Range<int> dirtyPitches) override;
     void tunerStarted() override { isActive = true; repaint(); }
     void tunerStopped() override { isActive = false; repaint(); }
     void tunerFinished() override {}
     void tunerStatusChanged(String) override {}
+    void newHarmonicAnalysisReady(const VCOTuner::measurement_t& m, const HarmonicAnalyzer::Result& result) override;
 
 private:
     void drawMeasurementBox(Graphics& g, Rectangle<float> bounds, const String& label, const String& value, Colour valueColor);
     void drawSmallDataBox(Graphics& g, Rectangle<float> bounds, const String& label, const String& value);
     void drawPrecisionMeter(Graphics& g, Rectangle<float> bounds);
+    void drawHarmonics(Graphics& g, Rectangle<float> bounds);
 
     VCOTuner* tuner;
 
@@ -47,5 +52,11 @@ private:
     bool isActive = false;
     bool hasSignal = false;
 
+    // Waveform analysis of the last note, if enabled
+    HarmonicAnalyzer::Result harmonics;
+
+    // New notes can arrive faster than the screen refreshes
+    UpdateScheduler updateScheduler { *this };
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TunerDisplay)
 };
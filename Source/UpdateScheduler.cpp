@@ -0,0 +1,36 @@
+/*
+  ==============================================================================
+
+    UpdateScheduler.cpp
+    Coalesces repaint requests to the display refresh rate
+
+  ==============================================================================
+*/
+
+#include "UpdateScheduler.h"
+
+UpdateScheduler::UpdateScheduler(Component& c)
+    : owner(c), vBlankAttachment(&c, [this] { onVBlank(); })
+{
+}
+
+void UpdateScheduler::requestRepaint()
+{
+    repaintAll = true;
+}
+
+void UpdateScheduler::requestRepaint(Rectangle<int> area)
+{
+    pendingArea = pendingArea.isEmpty() ? area : pendingArea.getUnion(area);
+}
+
+void UpdateScheduler::onVBlank()
+{
+    if (repaintAll)
+        owner.repaint();
+    else if (!pendingArea.isEmpty())
+        owner.repaint(pendingArea);
+
+    repaintAll = false;
+    pendingArea = Rectangle<int>();
+}
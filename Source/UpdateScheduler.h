@@ -0,0 +1,40 @@
+/*
+  ==============================================================================
+
+    UpdateScheduler.h
+    Coalesces repaint requests to the display refresh rate
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Collects the repaint requests of a component between two display frames
+// and issues them as one repaint on the next vertical blank. Listener
+// callbacks can arrive much faster than the screen refreshes; this way only
+// the latest state is drawn and the message thread stays free for the tuner.
+class UpdateScheduler
+{
+public:
+    explicit UpdateScheduler(Component& owner);
+
+    // Repaint the whole component on the next frame
+    void requestRepaint();
+
+    // Repaint an area of the component on the next frame
+    void requestRepaint(Rectangle<int> area);
+
+    bool isRepaintPending() const { return repaintAll || !pendingArea.isEmpty(); }
+
+private:
+    void onVBlank();
+
+    Component& owner;
+    Rectangle<int> pendingArea;
+    bool repaintAll = false;
+    VBlankAttachment vBlankAttachment;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(UpdateScheduler)
+};
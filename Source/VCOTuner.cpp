@@ -11,11 +11,14 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "VCOTuner.h"
 #include "CVOutput/CVOutputManager.h"
+#include "Measurement/MeasurementStore.h"
 
 VCOTuner::VCOTuner(AudioDeviceManager* d)
 {
     state = stopped;
     numPeriodSamples = 10;
+    earlyStopTargetCents = 0.0;
+    earlyStopMaxPeriods = 400;
     lowestPitch = 30;
     highestPitch = 120;
     pitchIncrement = 12;
@@ -23,6 +26,12 @@ VCOTuner::VCOTuner(AudioDeviceManager* d)
     midiChannel = 1;
     currentlyPlayingMidiNote = -1;
     
+    for (int i = 0; i < maxNumTrackedInputChannels; i++)
+        periodTrackers.add(new PeriodTracker());
+    
+    waveformCapture.resize(HarmonicAnalyzer::fftSize);
+    measurementStore = std::make_unique<MeasurementStore>();
+    
     d->addChangeListener(this);
     d->addAudioCallback(this);
     
@@ -81,6 +90,69 @@ void VCOTuner::stop()
         switchState(stopped);
 }
 
+void VCOTuner::setEarlyStop(double targetCents, int maxPeriods)
+{
+    earlyStopTargetCents = jmax(0.0, targetCents);
+    earlyStopMaxPeriods = jmax((int) minEarlyStopPeriods, maxPeriods);
+}
+
+VCOTuner::periodResult_t VCOTuner::getPeriodResult() const
+{
+    periodResult_t result;
+    result.numMeasurements = (int) periodStatistics.getCount();
+    result.frequency = sampleRate / periodStatistics.getMean();
+    result.freqDeviation = 0;
+    result.pitchDeviation = 0;
+    
+    const double n = (double) result.numMeasurements;
+    if (n < 2)
+        return result;
+    
+    // the deviations are taken around the result and not around the mean of the
+    // per-period values: sum (x - c)^2 = (n - 1) var(x) + n (mean(x) - c)^2
+    double fMeanOffset = sampleRate * inversePeriodStatistics.getMean() - result.frequency;
+    double fSquares = (n - 1) * sampleRate * sampleRate * inversePeriodStatistics.getVariance() + n * fMeanOffset * fMeanOffset;
+    result.freqDeviation = sqrt(fSquares / (n - 1));
+    
+    // pitch of a period = const - 12 * log2(period length)
+    double logMeanOffset = logPeriodStatistics.getMean() - log(periodStatistics.getMean());
+    double logSquares = (n - 1) * logPeriodStatistics.getVariance() + n * logMeanOffset * logMeanOffset;
+    result.pitchDeviation = 12.0 / log(2.0) * sqrt(logSquares / (n - 1));
+    
+    return result;
+}
+
+int VCOTuner::getMeasurementTimeoutCycles(int pitch) const
+{
+    // a single measurement may run before any reference was measured
+    const float reference = referenceFrequency > 0.0f ? referenceFrequency : 440.0f;
+    const int referenceNote = referenceFrequency > 0.0f ? referencePitch : 69;
+    float expectedFrequency = reference * powf(2,((float) pitch - (float) referenceNote)/12.0f);
+    // with the early stop a measurement may run up to earlyStopMaxPeriods periods
+    const int maxPeriods = earlyStopTargetCents > 0.0 ? earlyStopMaxPeriods : numPeriodSamples;
+    float expectedTime = 1.0f / (float) expectedFrequency * maxPeriods;
+    if (captureWaveform)
+        expectedTime += (float) HarmonicAnalyzer::fftSize / (float) sampleRate;
+    expectedTime *= 2;
+    return juce::roundToInt(expectedTime * 100);
+}
+
+void VCOTuner::getLastPeriodLengths(std::vector<double>& destination) const
+{
+    if (indexOfFirstValidPeriodLength < 0)
+        destination.clear();
+    else
+        periodLengths.copyRetained(destination, indexOfFirstValidPeriodLength);
+}
+
+double VCOTuner::getExpectedReferenceFrequency() const
+{
+    if (referenceInterval <= 0 || referenceDriftModel.getNumSamples() == 0)
+        return referenceFrequency;
+    
+    return referenceFrequency * pow(2.0, referenceDriftModel.getDriftAt(getSeconds()) / 1200.0);
+}
+
 void VCOTuner::startSingleMeasurement(int pitch)
 {
     if (state != stopped && state != finished)
@@ -92,6 +164,11 @@ void VCOTuner::startSingleMeasurement(int pitch)
     switchState(prepareSingleMeasurement);
 }
 
+PeriodTracker* VCOTuner::getPeriodTracker(int inputChannel)
+{
+    return periodTrackers[inputChannel];
+}
+
 StringArray VCOTuner::getLastErrors()
 {
     StringArray tmp = errors;
@@ -108,10 +185,15 @@ void VCOTuner::timerCallback()
         case prepRefMeasurement:
             if (cycleCounter == 0)
             {
-                // send reference midi note
-                referencePitch = (highestPitch + lowestPitch) / 2;
-                currentPitch = referencePitch;
-                trySendMidiNoteOn(currentPitch);
+                // send reference midi note. a check in the middle of a sweep
+                // keeps the pitch and the drift model of the sweep
+                if (!checkingReference)
+                {
+                    referencePitch = (highestPitch + lowestPitch) / 2;
+                    currentPitch = referencePitch;
+                    referenceDriftModel.reset();
+                }
+                trySendMidiNoteOn(referencePitch);
             }
             else
             {
@@ -133,7 +215,7 @@ void VCOTuner::timerCallback()
             if (!startMeasurement)
             {
                 // send note off
-                trySendMidiNoteOff(currentPitch);
+                trySendMidiNoteOff(referencePitch);
                 
                 if (lError == notStable)
                 {
@@ -143,18 +225,19 @@ void VCOTuner::timerCallback()
                 else
                 {
                     // calculate frequency
-                    int numMeasurements = periodLengthsHead - indexOfFirstValidPeriodLength;
-                    double accumulator = 0;
-                    for (int i = indexOfFirstValidPeriodLength; i < periodLengthsHead; i++)
-                        accumulator += periodLengths[i];
-                    
-                    double averagePeriod = accumulator / (double) numMeasurements;
+                    double frequency = getPeriodResult().frequency;
                     
-                    referenceFrequency = float(sampleRate / averagePeriod);
+                    if (!checkingReference)
+                    {
+                        referenceFrequency = float(frequency);
+                        
+                        // prepare next measurement
+                        currentPitch = lowestPitch;
+                        currentIndex = 0;
+                    }
                     
-                    // prepare next measurement
-                    currentPitch = lowestPitch;
-                    currentIndex = 0;
+                    referenceDriftModel.addSample(getSeconds(), 1200.0 * log(frequency / referenceFrequency) / log(2.0));
+                    checkingReference = false;
                     switchState(prepMeasurement);
                     break;
                 }
@@ -162,7 +245,7 @@ void VCOTuner::timerCallback()
 
             if (cycleCounter > 1000)
             {
-                if (periodLengthsHead == 0)
+                if (periodLengths.size() == 0)
                     errors.add(Errors::noZeroCrossings);
                 else if (lError == notStable)
                     errors.add(Errors::highJitterTimeOut);
@@ -188,6 +271,7 @@ void VCOTuner::timerCallback()
                 if (cycleCounter >= 10)
                 {
                     // start a measurement and see if we get a stable pitch here
+                    captureWaveform = harmonicAnalysisEnabled;
                     startMeasurement = true;
                     switchState(measurement);
                     break;
@@ -211,15 +295,14 @@ void VCOTuner::timerCallback()
                 else
                 {
                     // calculate frequency
-                    int numMeasurements = periodLengthsHead - indexOfFirstValidPeriodLength;
-                    double accumulator = 0;
-                    for (int i = indexOfFirstValidPeriodLength; i < periodLengthsHead; i++)
-                        accumulator += periodLengths[i];
-                    
-                    double averagePeriod = (double) accumulator / (double) numMeasurements;
+                    periodResult_t result = getPeriodResult();
+                    int numMeasurements = result.numMeasurements;
+                    double frequency = result.frequency;
                     
-                    double frequency = sampleRate / averagePeriod;
-                    double pitch = 12.0 * log(frequency / referenceFrequency) / log(2.0) + referencePitch;
+                    // measure against the reference as it is now, not as it was at the start
+                    double drift = referenceInterval > 0 ? referenceDriftModel.getDriftAt(getSeconds()) : 0.0;
+                    double currentReferenceFrequency = referenceFrequency * pow(2.0, drift / 1200.0);
+                    double pitch = 12.0 * log(frequency / currentReferenceFrequency) / log(2.0) + referencePitch;
                     
                     // check if the frequency has changed compared to the reference frequency
                     // if not, it is likely that the MIDI output is not working. Do this only for the very first measurement
@@ -232,19 +315,10 @@ void VCOTuner::timerCallback()
                         }
                     }
                     
-                    // estimate deviation of frequency and pitch
-                    double fAccumulator = 0;
-                    double pAccumulator = 0;
-                    for (int i = indexOfFirstValidPeriodLength; i < periodLengthsHead; i++)
-                    {
-                        double f = sampleRate / (double) periodLengths[i];
-                        fAccumulator += pow(f - frequency, 2);
-                        pAccumulator += pow(12.0 * log(f / referenceFrequency) / log(2.0) + referencePitch - pitch, 2);
-                    }
-                    fAccumulator = fAccumulator / (numMeasurements - 1);
-                    pAccumulator = pAccumulator / (numMeasurements - 1);
-                    double fDeviation = sqrt(fAccumulator);
-                    double pDeviation = sqrt(pAccumulator);
+                    // deviation of frequency and pitch. the pitch deviation doesn't
+                    // depend on the reference, it only shifts all pitches alike
+                    double fDeviation = result.freqDeviation;
+                    double pDeviation = result.pitchDeviation;
                     
                     measurement_t m;
                     m.timestamp = Time::getCurrentTime();
@@ -255,27 +329,38 @@ void VCOTuner::timerCallback()
                     m.freqDeviation = fDeviation;
                     m.pitchDeviation = pDeviation;
                     m.numMeasurements = numMeasurements;
+                    m.referenceDrift = drift;
+                    measurementStore->add(m);
                     listeners.call(&Listener::newMeasurementReady, m);
                     
+                    // the waveform analysis runs here on the message thread, the audio thread only records
+                    if (captureWaveform && waveformCaptureLength >= HarmonicAnalyzer::fftSize)
+                    {
+                        HarmonicAnalyzer::Result harmonics = harmonicAnalyzer.analyze(waveformCapture.data(), waveformCaptureLength, sampleRate, frequency);
+                        listeners.call(&Listener::newHarmonicAnalysisReady, m, harmonics);
+                    }
+                    captureWaveform = false;
+                    
                     // prepare next measurement
                     currentPitch += pitchIncrement;
                     currentIndex++;
                     
-                    if (currentPitch <= highestPitch)
-                        switchState(prepMeasurement);
-                    else
+                    if (currentPitch > highestPitch)
                         switchState(finished);
+                    else if (referenceInterval > 0 && currentIndex % referenceInterval == 0)
+                    {
+                        checkingReference = true;
+                        switchState(prepRefMeasurement);
+                    }
+                    else
+                        switchState(prepMeasurement);
                     break;
                 }
             }
             
-            float expectedFrequency = referenceFrequency * powf(2,((float) currentPitch - (float) referencePitch)/12.0f);
-            float expectedTime = 1.0f / (float) expectedFrequency * numPeriodSamples;
-            expectedTime *= 2;
-            int expectedCycles = juce::roundToInt(expectedTime * 100);
-            if (cycleCounter > expectedCycles)
+            if (cycleCounter > getMeasurementTimeoutCycles(currentPitch))
             {
-                if (periodLengthsHead == 0)
+                if (periodLengths.size() == 0)
                     errors.add(Errors::noZeroCrossings);
                 else if (lError == notStable)
                     errors.add(Errors::highJitterTimeOut);
@@ -304,31 +389,21 @@ void VCOTuner::timerCallback()
         } break;
         case continuousFrequencyMeasurement:
         {
+            // the tracker FIFO only holds a fraction of a second at audio rates
+            if (capturingPeriods)
+                readCapturedPeriods();
+            
             // if the measurement is done)
             if (!startMeasurement)
             {
-                // calculate frequency
-                int numMeasurements = periodLengthsHead - indexOfFirstValidPeriodLength;
-                double accumulator = 0;
-                for (int i = indexOfFirstValidPeriodLength; i < periodLengthsHead; i++)
-                    accumulator += periodLengths[i];
-                
-                double averagePeriod = (double) accumulator / (double) numMeasurements;
-                
-                double frequency = sampleRate / averagePeriod;
-                
-                // estimate deviation of frequency
-                double fAccumulator = 0;
-                for (int i = indexOfFirstValidPeriodLength; i < periodLengthsHead; i++)
-                {
-                    double f = sampleRate / (double) periodLengths[i];
-                    fAccumulator += pow(f - frequency, 2);
-                }
-                fAccumulator = fAccumulator / (numMeasurements - 1);
-                double fDeviation = sqrt(fAccumulator);
+                // calculate frequency and its deviation
+                periodResult_t result = getPeriodResult();
+                double frequency = result.frequency;
+                double fDeviation = result.freqDeviation;
                 
                 continuousFreqMeasurementResult = frequency;
                 continuousFreqMeasurementDeviation = fDeviation;
+                driftLogger.add(frequency, fDeviation);
                 
                 // restart measurement
                 startMeasurement = true;
@@ -375,38 +450,22 @@ void VCOTuner::timerCallback()
                 }
                 else
                 {
-                    // calculate frequency
-                    int numMeasurements = periodLengthsHead - indexOfFirstValidPeriodLength;
-                    double accumulator = 0;
-                    for (int i = indexOfFirstValidPeriodLength; i < periodLengthsHead; i++)
-                        accumulator += periodLengths[i];
-                    
-                    double averagePeriod = (double) accumulator / (double) numMeasurements;
+                    // calculate frequency and its deviation
+                    periodResult_t result = getPeriodResult();
                     
-                    double frequency = sampleRate / averagePeriod;
-                    
-                    // estimate deviation of frequency
-                    double fAccumulator = 0;
-                    for (int i = indexOfFirstValidPeriodLength; i < periodLengthsHead; i++)
-                    {
-                        double f = sampleRate / (double) periodLengths[i];
-                        fAccumulator += pow(f - frequency, 2);
-                    }
-                    fAccumulator = fAccumulator / (numMeasurements - 1);
-                    double fDeviation = sqrt(fAccumulator);
-                    
-                    singleMeasurementResult = frequency;
-                    singleMeasurementDeviation = fDeviation;
+                    singleMeasurementResult = result.frequency;
+                    singleMeasurementDeviation = result.freqDeviation;
+                    singleMeasurementNumPeriods = result.numMeasurements;
                     
                     switchState(finished);
                     break;
                 }
             }
             
-            // timeout handling
-            if (cycleCounter > 1000)
+            // timeout handling, never shorter than the 10 s it used to be
+            if (cycleCounter > jmax(1000, getMeasurementTimeoutCycles(singleMeasurementPitch)))
             {
-                if (periodLengthsHead == 0)
+                if (periodLengths.size() == 0)
                     errors.add(Errors::noZeroCrossings);
                 else if (lError == notStable)
                     errors.add(Errors::highJitterTimeOut);
@@ -432,11 +491,51 @@ void VCOTuner::startContinuousMeasurement(int pitch)
     state = prepareContinuousFrequencyMeasurement;
 }
 
+bool VCOTuner::startDriftLogging(int pitch, const File& logFile, bool appendToFile)
+{
+    startContinuousMeasurement(pitch);
+    bool ok = driftLogger.start(logFile, appendToFile);
+    listeners.call(&Listener::tunerStatusChanged, getStatusString());
+    return ok;
+}
+
+void VCOTuner::startStabilityCapture(int pitch)
+{
+    startContinuousMeasurement(pitch);
+    
+    capturedPeriodLengths.clear();
+    numDroppedCapturePeriods = 0;
+    periodScratch.reserve(32768);
+    periodTrackers[0]->start();
+    capturingPeriods = true;
+    listeners.call(&Listener::tunerStatusChanged, getStatusString());
+}
+
+void VCOTuner::readCapturedPeriods()
+{
+    periodScratch.clear();
+    periodTrackers[0]->readPeriods(periodScratch);
+    for (const auto& p : periodScratch)
+        capturedPeriodLengths.push_back(p.length);
+    numDroppedCapturePeriods = periodTrackers[0]->getNumDroppedPeriods();
+}
+
+std::unique_ptr<StabilityAnalyzer> VCOTuner::createStabilityAnalysis() const
+{
+    if (numDroppedCapturePeriods > 0)
+        return nullptr;
+    return std::make_unique<StabilityAnalyzer>(capturedPeriodLengths, sampleRate);
+}
+
 void VCOTuner::trySendMidiNoteOn(int pitch)
 {
     MidiOutput* midiOut = deviceManager->getDefaultMidiOutput();
     if (midiOut == nullptr)
     {
+        // the pitch is set by the CV output, MIDI is optional then
+        if (cvOutputManager != nullptr && cvOutputManager->isActive())
+            return;
+        
         errors.add(Errors::noMidiDeviceAvailable);
         switchState(stopped);
         return;
@@ -454,6 +553,12 @@ void VCOTuner::trySendMidiNoteOff(int pitch)
     MidiOutput* midiOut = deviceManager->getDefaultMidiOutput();
     if (midiOut == nullptr)
     {
+        if (cvOutputManager != nullptr && cvOutputManager->isActive())
+        {
+            currentlyPlayingMidiNote = -1;
+            return;
+        }
+        
         errors.add(Errors::noMidiDeviceAvailable);
         switchState(stopped);
         return;
@@ -490,7 +595,11 @@ void VCOTuner::audioDeviceIOCallback (const float** inputChannelData,
             sampleCounter = 0;
             lastZeroCrossing = -1;
             indexOfFirstValidPeriodLength = -1;
-            periodLengthsHead = 0;
+            periodLengths.clear();
+            periodStatistics.reset();
+            inversePeriodStatistics.reset();
+            logPeriodStatistics.reset();
+            waveformCaptureLength = 0;
             initialized = true;
         }
         
@@ -500,9 +609,6 @@ void VCOTuner::audioDeviceIOCallback (const float** inputChannelData,
             float currentSample = inputBuffer.getSample(0, i);
             if (lastSample < 0 && currentSample >= 0)
             {
-                if (periodLengthsHead >= maxNumPeriodLengths)
-                    break;
-                
                 // interpolate line between the sample before and after the crossing
                 // y = mx + n
                 double m = (lastSample - currentSample);
@@ -511,14 +617,30 @@ void VCOTuner::audioDeviceIOCallback (const float** inputChannelData,
                 // zero crossing of interpolated line: y = 0 => x0 = -n/m
                 double zeroCrossingPos = -n / m;
                 
-                periodLengths[periodLengthsHead++] = zeroCrossingPos - lastZeroCrossing;
-                lastZeroCrossing = zeroCrossingPos;                
+                double periodLength = zeroCrossingPos - lastZeroCrossing;
+                periodLengths.add(periodLength);
+                lastZeroCrossing = zeroCrossingPos;
+                
+                // streaming statistics of the periods that make up the result.
+                // these are final, so the storage is free to recycle the period later
+                if (indexOfFirstValidPeriodLength >= 0)
+                {
+                    periodStatistics.add(periodLength);
+                    inversePeriodStatistics.add(1.0 / periodLength);
+                    logPeriodStatistics.add(std::log(periodLength));
+                }
             }
+            
+            // raw input of the settled oscillator for the harmonic analysis
+            if (captureWaveform && indexOfFirstValidPeriodLength >= 0 && waveformCaptureLength < HarmonicAnalyzer::fftSize)
+                waveformCapture[waveformCaptureLength++] = currentSample;
+            
             lastSample = currentSample;
             sampleCounter++;
         }
         
         // see if the period length is stable
+        const int periodLengthsHead = periodLengths.size();
         if (periodLengthsHead > 5 && indexOfFirstValidPeriodLength < 0)
         {
             double sum = 0;
@@ -544,7 +666,21 @@ void VCOTuner::audioDeviceIOCallback (const float** inputChannelData,
         
         // finish measurement when the required number of valid measurements are made
         int numMeasurements = periodLengthsHead - indexOfFirstValidPeriodLength;
-        if ((indexOfFirstValidPeriodLength > 0) && (numMeasurements > numPeriodSamples))
+        bool enoughMeasurements = numMeasurements > numPeriodSamples;
+        bool waveformComplete = !captureWaveform || waveformCaptureLength >= HarmonicAnalyzer::fftSize;
+        if (earlyStopTargetCents > 0.0)
+        {
+            // stop as soon as the pitch is known precisely enough. Low notes get
+            // there after a few periods, high notes with more jitter take longer.
+            int maxPeriods = earlyStopMaxPeriods;
+            double standardErrorCents = 1200.0 / std::log(2.0)
+                                        * periodStatistics.getStandardError() / jmax(1.0e-9, periodStatistics.getMean());
+            
+            enoughMeasurements = numMeasurements >= maxPeriods
+                                 || (numMeasurements >= minEarlyStopPeriods && standardErrorCents <= earlyStopTargetCents);
+        }
+        
+        if ((indexOfFirstValidPeriodLength > 0) && enoughMeasurements && waveformComplete)
         {
             lError = noError;
             initialized = false;
@@ -557,8 +693,8 @@ void VCOTuner::audioDeviceIOCallback (const float** inputChannelData,
         {
             lError = notStable;
             
-            // ran out of recording space => period length too jittery or does change constantly - stop here.
-            if ((periodLengthsHead >= maxNumPeriodLengths))
+            // still not stable after many periods => period length too jittery or does change constantly - stop here.
+            if ((periodLengthsHead >= maxNumUnstablePeriods))
             {
                 initialized = false;
                 startMeasurement = false;
@@ -566,18 +702,28 @@ void VCOTuner::audioDeviceIOCallback (const float** inputChannelData,
         }
     }
 
+    // feed the continuous period trackers, positions are expressed on the
+    // CV output clock so they can be related to the voltage being output
+    const int64 outputPosition = (cvOutputManager != nullptr) ? cvOutputManager->getOutputSamplePosition() : 0;
+    for (int ch = 0; ch < jmin(numInputChannels, periodTrackers.size()); ch++)
+    {
+        if (periodTrackers[ch]->isTracking())
+            periodTrackers[ch]->processBlock(inputChannelData[ch], numSamples, outputPosition);
+    }
+
     // Handle CV output
     if (outputChannelData != nullptr && numOutputChannels > 0)
     {
-        AudioBuffer<float> outputBuffer(outputChannelData, numOutputChannels, numSamples);
-
-        // Use CVOutputManager if available and active
-        if (cvOutputManager != nullptr && cvOutputManager->isActive())
+        // Use CVOutputManager if available. It renders every active CV channel
+        // into its own output, outputs silence elsewhere and keeps its sample
+        // clock running for the period trackers
+        if (cvOutputManager != nullptr)
         {
-            cvOutputManager->fillOutputBuffer(outputBuffer.getWritePointer(0), numSamples);
+            cvOutputManager->fillOutputBuffers(outputChannelData, numOutputChannels, numSamples);
         }
         else
         {
+            AudioBuffer<float> outputBuffer(outputChannelData, numOutputChannels, numSamples);
             outputBuffer.clear();
         }
     }
@@ -586,15 +732,27 @@ void VCOTuner::audioDeviceIOCallback (const float** inputChannelData,
 void VCOTuner::switchState(VCOTuner::State newState)
 {
     cycleCounter = 0;
+    const State previousState = state;
     state = newState;
     if (state == stopped)
     {
+        singleMeasurementStopped = (previousState == prepareSingleMeasurement || previousState == singleMeasurement);
+        checkingReference = false;
         if (currentlyPlayingMidiNote >= 0 && currentlyPlayingMidiNote < 128)
             trySendMidiNoteOff(currentlyPlayingMidiNote);
         stopMeasurement = true;
+        captureWaveform = false;
+        driftLogger.stop();
+        if (capturingPeriods)
+        {
+            // keep what the tracker still holds, the capture ends here
+            readCapturedPeriods();
+            periodTrackers[0]->stop();
+            capturingPeriods = false;
+        }
         listeners.call(&Listener::tunerStopped);
     }
-    else if (newState == prepRefMeasurement)
+    else if (newState == prepRefMeasurement && !checkingReference)
         listeners.call(&Listener::tunerStarted);
     else if (newState == finished)
         listeners.call(&Listener::tunerFinished);
@@ -606,6 +764,10 @@ void VCOTuner::switchState(VCOTuner::State newState)
 void VCOTuner::audioDeviceAboutToStart (AudioIODevice* device)
 {
     sampleRate = device->getCurrentSampleRate();
+    deviceLatencySamples = device->getInputLatencyInSamples() + device->getOutputLatencyInSamples();
+    
+    if (cvOutputManager != nullptr)
+        cvOutputManager->setSampleRate(sampleRate);
 }
 
 /** inherited from AudioIODeviceCallback */
@@ -634,6 +796,8 @@ String VCOTuner::getStatusString() const
             break; // these breaks are only here to prevent IDE warnings...
         case prepRefMeasurement:
         case refMeasurement:
+            if (checkingReference)
+                return "Re-measuring reference frequency for drift ...";
             return "Measuring reference frequency ...";
             break;
         case prepMeasurement:
@@ -645,6 +809,10 @@ String VCOTuner::getStatusString() const
             break;
         case prepareContinuousFrequencyMeasurement:
         case continuousFrequencyMeasurement:
+            if (driftLogger.isLogging())
+                return "Logging frequency drift...";
+            if (capturingPeriods)
+                return "Capturing periods for stability analysis...";
             return "Continuously measuring frequency...";
             break;
         case prepareSingleMeasurement:
@@ -12,8 +12,16 @@
 #define VCOTUNER_H_INCLUDED
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "Measurement/PeriodTracker.h"
+#include "Measurement/RunningStatistics.h"
+#include "Measurement/DriftModel.h"
+#include "Measurement/DriftLogger.h"
+#include "Measurement/StabilityAnalyzer.h"
+#include "Measurement/PeriodStorage.h"
+#include "Measurement/HarmonicAnalyzer.h"
 
 class CVOutputManager;
+class MeasurementStore;
 
 class VCOTuner: public ChangeListener,
                 private Timer,
@@ -36,20 +44,73 @@ public:
     void setMidiChannel(int channel) { midiChannel = channel; }
     int  getMidiChannel() const { return midiChannel; }
     
-    void setResolution(int numCyclesPerNote) { numPeriodSamples = numCyclesPerNote; }
+    /** measures a fixed number of periods per note (disables the early stop) */
+    void setResolution(int numCyclesPerNote) { numPeriodSamples = numCyclesPerNote; earlyStopTargetCents = 0.0; }
     int getResolution() { return numPeriodSamples; }
     
+    /** ends each measurement as soon as the standard error of the pitch estimate
+        drops below targetCents, but after no more than maxPeriods periods.
+        A target of 0 returns to the fixed count set with setResolution(). */
+    void setEarlyStop(double targetCents, int maxPeriods);
+    double getEarlyStopTarget() const { return earlyStopTargetCents; }
+    int getEarlyStopMaxPeriods() const { return earlyStopMaxPeriods; }
+    bool isEarlyStopEnabled() const { return earlyStopTargetCents > 0.0; }
+    
     double getCurrentSampleRate() { return sampleRate; }
     double getReferenceFrequency() { return referenceFrequency; }
     int getReferencePitch() const { return referencePitch; }
     
+    /** re-measures the reference pitch after every numNotes notes of a sweep and
+        corrects each measurement for the drift fitted through all reference
+        measurements so far. 0 measures the reference only once at the start. */
+    void setReferenceInterval(int numNotes) { referenceInterval = jmax(0, numNotes); }
+    int getReferenceInterval() const { return referenceInterval; }
+    
+    /** the reference frequency the drift model predicts for this moment */
+    double getExpectedReferenceFrequency() const;
+    
     String getStatusString()const;
     
     void startContinuousMeasurement(int pitch);
     double getContinuousMesurementResult() const { return continuousFreqMeasurementResult; }
+    double getContinuousMeasurementDeviation() const { return continuousFreqMeasurementDeviation; }
+    
+    /** continuous measurement that records every result for long burn-in tests,
+        optionally streaming it to a CSV file or appending to an existing one.
+        runs until stop() is called. */
+    bool startDriftLogging(int pitch, const File& logFile = File(), bool appendToFile = false);
+    bool isDriftLogging() const { return driftLogger.isLogging(); }
+    const DriftLogger& getDriftLogger() const { return driftLogger; }
+    
+    /** continuous measurement that keeps every single period length of the
+        first input channel for a stability analysis. runs until stop() is called. */
+    void startStabilityCapture(int pitch);
+    bool isCapturingPeriods() const { return capturingPeriods; }
+    int getNumCapturedPeriods() const { return (int) capturedPeriodLengths.size(); }
+    /** periods the tracker lost because its FIFO was full, e.g. during a long
+        message thread stall. the captured periods then have a gap. */
+    int getNumDroppedCapturePeriods() const { return numDroppedCapturePeriods; }
+    /** Allan deviation and jitter spectrum of the periods captured so far,
+        nullptr if periods were dropped, as the joined runs would corrupt both */
+    std::unique_ptr<StabilityAnalyzer> createStabilityAnalysis() const;
     
     void startSingleMeasurement(int pitch);
     double getSingleMeasurementResult() const { return singleMeasurementResult; }
+    double getSingleMeasurementDeviation() const { return singleMeasurementDeviation; }
+    int getSingleMeasurementNumPeriods() const { return singleMeasurementNumPeriods; }
+    
+    /** captures the waveform of every note of a sweep and reports its harmonics,
+        THD, DC offset and level through newHarmonicAnalysisReady(). makes each
+        note take about HarmonicAnalyzer::fftSize samples longer. */
+    void setHarmonicAnalysis(bool enabled) { harmonicAnalysisEnabled = enabled; }
+    bool isHarmonicAnalysisEnabled() const { return harmonicAnalysisEnabled; }
+    
+    /** all measurements of the sweeps so far, indexed by MIDI note. every note is
+        added here right before newMeasurementReady() is called. */
+    MeasurementStore& getMeasurementStore() { return *measurementStore; }
+    
+    /** the valid period lengths of the last measurement, as far as they are still stored */
+    void getLastPeriodLengths(std::vector<double>& destination) const;
     
     /** holds all properties of a single measurements */
     typedef struct
@@ -61,12 +122,17 @@ public:
         double freqDeviation;
         double pitchDeviation;
         int numMeasurements;
+        double referenceDrift; // drift of the reference in cents, already removed from pitch
         Time timestamp;
     } measurement_t;
     
     /** returns all error messages and removes them from the internal list */
     StringArray getLastErrors();
     
+    /** true if the last stop ended a single measurement. Those are started by
+        the calibration, which handles the errors itself. */
+    bool wasSingleMeasurementStopped() const { return singleMeasurementStopped; }
+    
     /** inherited from AudioIODeviceCallback */
     virtual void audioDeviceIOCallback (const float** inputChannelData,
                                         int numInputChannels,
@@ -93,6 +159,8 @@ public:
         virtual void tunerStopped() {}
         virtual void tunerFinished() {}
         virtual void tunerStatusChanged(String /* statusString */) {}
+        /** called right after newMeasurementReady() for the same note */
+        virtual void newHarmonicAnalysisReady(const measurement_t& /*m*/, const HarmonicAnalyzer::Result& /*result*/) {}
     };
     
     void addListener(Listener* l);
@@ -101,6 +169,14 @@ public:
     // CV Output integration
     void setCVOutputManager(CVOutputManager* manager) { cvOutputManager = manager; }
     CVOutputManager* getCVOutputManager() { return cvOutputManager; }
+    AudioDeviceManager* getAudioDeviceManager() { return deviceManager; }
+
+    /** continuous per-period tracking, independent of the measurement state machine */
+    static const int maxNumTrackedInputChannels = 8;
+    PeriodTracker* getPeriodTracker(int inputChannel);
+
+    /** input + output latency reported by the audio device */
+    int getDeviceLatencyInSamples() const { return deviceLatencySamples; }
 
 private:
     CVOutputManager* cvOutputManager = nullptr;
@@ -121,6 +197,20 @@ private:
     
     ListenerList<Listener> listeners;
     
+    /** result of the valid periods of the last measurement, computed from the
+        streaming statistics so it doesn't need every period to still be stored */
+    typedef struct
+    {
+        int numMeasurements;
+        double frequency; // from the average period length
+        double freqDeviation; // of the per-period frequencies around frequency
+        double pitchDeviation; // the same in semitones
+    } periodResult_t;
+    periodResult_t getPeriodResult() const;
+    
+    /** number of timer cycles a measurement at the given pitch may take before it times out */
+    int getMeasurementTimeoutCycles(int pitch) const;
+    
     // processes the state machine
     virtual void timerCallback();
     void switchState(State newState);
@@ -154,6 +244,14 @@ private:
     /** frequency returned during the reference measurement */
     float referenceFrequency;
     
+    /** number of notes between two reference measurements, 0 = only at the start */
+    int referenceInterval = 0;
+    /** true while the reference is re-measured in the middle of a sweep */
+    bool checkingReference = false;
+    /** reference pitch in cents relative to referenceFrequency over time */
+    DriftModel referenceDriftModel;
+    static double getSeconds() { return Time::getMillisecondCounterHiRes() * 0.001; }
+    
     /** a list with recent error messages */
     StringArray errors;
     
@@ -168,12 +266,20 @@ private:
      be accessed from the audio thread, when startMeasurement == true */
     bool startMeasurement; // set by message thread, reset by audio thread.
     bool stopMeasurement;  // set by message thread, reset by audio thread.
-    static const int maxNumPeriodLengths = 600;
-    double periodLengths[maxNumPeriodLengths]; // all measured period lengths of this measurement
+    PeriodStorage periodLengths; // period lengths of this measurement, very long ones only keep the most recent
+    static const int maxNumUnstablePeriods = 600; // give up when the pitch hasn't settled after this many periods
     int numPeriodSamples; // number of periods to measure before averaging
+    double earlyStopTargetCents; // standard error at which a measurement ends, 0 = use numPeriodSamples
+    int earlyStopMaxPeriods; // upper limit for the number of periods when the early stop is used
+    static const int minEarlyStopPeriods = 8; // the variance estimate is meaningless below this
+    RunningStatistics periodStatistics; // statistics of all valid period lengths of this measurement
+    RunningStatistics inversePeriodStatistics; // ... of 1 / period length, for the frequency deviation
+    RunningStatistics logPeriodStatistics; // ... of log(period length), for the pitch deviation
+    bool captureWaveform = false; // record the raw input of this measurement for the harmonic analysis
+    std::vector<float> waveformCapture; // preallocated to HarmonicAnalyzer::fftSize
+    int waveformCaptureLength = 0;
     int indexOfFirstValidPeriodLength; // the index in periodLengths[] at which the system has reached a stable frequency
                                        // this is also the first valid period length measurement that is included in the result
-    int periodLengthsHead;
     LowLevelError lError; // holds error message from the audio thread
     
     /** the following are only to be accessed from the audio thread */
@@ -182,14 +288,31 @@ private:
     float lastSample;
     double sampleRate;
     bool initialized;
+    int deviceLatencySamples = 0;
+
+    OwnedArray<PeriodTracker> periodTrackers;
     
     int continuousFrequencyMeasurementPitch;
     double continuousFreqMeasurementResult;
     double continuousFreqMeasurementDeviation;
+    DriftLogger driftLogger;
+    
+    std::unique_ptr<MeasurementStore> measurementStore;
+    
+    bool harmonicAnalysisEnabled = false;
+    HarmonicAnalyzer harmonicAnalyzer;
+    
+    void readCapturedPeriods();
+    bool capturingPeriods = false;
+    std::vector<PeriodTracker::Period> periodScratch;
+    std::vector<double> capturedPeriodLengths;
+    int numDroppedCapturePeriods = 0;
     
     int singleMeasurementPitch;
     double singleMeasurementResult;
     double singleMeasurementDeviation;
+    int singleMeasurementNumPeriods = 0;
+    bool singleMeasurementStopped = false;
     
     struct Errors
     {
@@ -13,13 +13,15 @@
 #include "Visualizer.h"
 #include "ModernLookAndFeel.h"
 
-Visualizer::Visualizer(VCOTuner* t)
+Visualizer::Visualizer(VCOTuner* t) : measurements(t->getMeasurementStore()), painter(measurements), updateScheduler(*this)
 {
     tuner = t;
+    measurements.addListener(this);
 }
 
 Visualizer::~Visualizer()
 {
+    measurements.removeListener(this);
 }
 
 void Visualizer::paint(juce::Graphics &g, int width, int height)
@@ -27,7 +29,7 @@ void Visualizer::paint(juce::Graphics &g, int width, int height)
     // Dark background
     g.fillAll(ModernLookAndFeel::Colors::background);
 
-    if (measurements.size() == 0)
+    if (measurements.isEmpty())
     {
         // Draw empty state message
         g.setColour(ModernLookAndFeel::Colors::textDim);
@@ -39,365 +41,193 @@ void Visualizer::paint(juce::Graphics &g, int width, int height)
     }
 
     // Calculate display range
-    double max = 0;
-    double min = 0;
-    for (int i = 0; i < measurements.size(); i++)
-    {
-        double value = measurements[i].pitchOffset;
-        double deviation = measurements[i].pitchDeviation;
-        if (value - deviation < min)
-            min = value - deviation;
-        if (value + deviation > max)
-            max = value + deviation;
-    }
-    double expandAmount = (max - min) * 0.2;
-    min -= expandAmount;
-    max += expandAmount;
-
-    paintWithFixedScaling(g, width, height, min, max);
+    Range<double> range = painter.getAutoRange();
+    paintWithFixedScaling(g, width, height, range.getStart(), range.getEnd());
 }
 
 void Visualizer::paintWithFixedScaling(Graphics& g, int width, int height, double min, double max)
 {
-    // Dark background
-    g.fillAll(ModernLookAndFeel::Colors::background);
-
-    if (measurements.size() == 0)
-    {
-        g.setColour(ModernLookAndFeel::Colors::textDim);
-        g.setFont(Font(18.0f));
-        g.drawText("No Data", 0, 0, width, height, juce::Justification::centred);
-        return;
-    }
-
-    // Full width chart layout (tuner is now in separate tab)
-    const int bottomBarHeight = 35;
-    const int topInfoHeight = 70;
-    int imageHeight = height - bottomBarHeight - topInfoHeight;
-
-    // Draw top info panel
-    drawTopInfoPanel(g, width, topInfoHeight);
-
-    // prepare coordinate transformation (flipping the y axis)
-    heightForFlipping = (float)imageHeight + topInfoHeight;
-
-    const float sidebarWidth = 60.0f;  // Y-axis labels width
-    const float chartTop = (float)topInfoHeight;
-    double columnWidth = (double)(width - sidebarWidth) / (double)measurements.size();
-    const double allowedPitchOffset = 0.02; // 2 cents allowed (tight)
+    painter.setReferencePitch(tuner->getReferencePitch());
+    painter.paintWithFixedScaling(g, width, height, min, max);
+}
 
-    if (min > -allowedPitchOffset)
-        min = -allowedPitchOffset;
-    if (max < allowedPitchOffset)
-        max = allowedPitchOffset;
-    if (max < min)
+void Visualizer::renderChartCache(float scale)
+{
+    const int width = getWidth();
+    const int height = getHeight();
+    chartCacheValid = false;
+    dirtyColumns = Range<int>();
+
+    Range<double> range = painter.getAutoRange();
+    painter.setReferencePitch(tuner->getReferencePitch());
+    if (width <= 0 || height <= 0 || !painter.computeLayout(cachedLayout, width, height, range.getStart(), range.getEnd(), getVisibleColumns()))
         return;
 
-    double vertScaling = (double)imageHeight / (max - min);
-
-    // Draw graph area background
-    Rectangle<float> graphArea(sidebarWidth, chartTop, (float)(width - sidebarWidth), (float)imageHeight);
-    g.setColour(ModernLookAndFeel::Colors::panel.withAlpha(0.3f));
-    g.fillRect(graphArea);
-
-    // Draw "in-tune" zone (green band around center)
-    double tuneZoneTop = (allowedPitchOffset - min) * vertScaling;
-    double tuneZoneBottom = (-allowedPitchOffset - min) * vertScaling;
-    g.setColour(ModernLookAndFeel::Colors::meter.withAlpha(0.08f));
-    g.fillRect(Rectangle<float>(sidebarWidth, yFlip((float)tuneZoneTop),
-                                 (float)(width - sidebarWidth), (float)(tuneZoneTop - tuneZoneBottom)));
-
-    // Draw maximum "in-tune" pitch offset and center line
-    g.setColour(ModernLookAndFeel::Colors::meter.withAlpha(0.4f));
-    const float dashLengths[] = {6, 4};
-    double position = (allowedPitchOffset - min) * vertScaling;
-    g.drawDashedLine(Line<float>(sidebarWidth, yFlip((float)position), (float)width, yFlip((float)position)), dashLengths, 2);
-    position = (-allowedPitchOffset - min) * vertScaling;
-    g.drawDashedLine(Line<float>(sidebarWidth, yFlip((float)position), (float)width, yFlip((float)position)), dashLengths, 2);
-
-    // Center line (0 offset)
-    position = (-min) * vertScaling;
-    g.setColour(ModernLookAndFeel::Colors::textSecondary);
-    g.drawLine(sidebarWidth, yFlip((float)position), (float)width, yFlip((float)position), 2.0f);
-
-    // Draw Y-axis grid and labels
-    g.setColour(ModernLookAndFeel::Colors::textDim);
-    const int numIntervals = 13;
-    const double allowedIntervals[numIntervals] = {0.005, 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1, 2, 5, 10, 20, 50};
-    double lineInterval = allowedIntervals[0];
-    int currentIntervalIndex = 0;
-
-    int numLinesAllowed = imageHeight / 40;
-    while (((max - min) / lineInterval) > numLinesAllowed)
+    const int imageWidth = roundToInt(width * scale);
+    const int imageHeight = roundToInt(height * scale);
+    if (backgroundCache.getWidth() != imageWidth || backgroundCache.getHeight() != imageHeight)
     {
-        lineInterval = allowedIntervals[++currentIntervalIndex];
-        if (currentIntervalIndex >= numIntervals)
-            break;
+        backgroundCache = Image(Image::ARGB, imageWidth, imageHeight, false);
+        chartCache = Image(Image::ARGB, imageWidth, imageHeight, false);
     }
-    bool useSemitoneTexts = lineInterval >= 1.0;
 
-    int numPosLines = (int)trunc(max / lineInterval);
-    int numNegLines = (int)trunc(-min / lineInterval);
-    for (double y = numPosLines; y > -numNegLines; y--)
     {
-        double linePos = (y * lineInterval - min) * vertScaling;
-        double number = y * lineInterval * ((useSemitoneTexts) ? 1.0 : 100.0);
-        String numberString = (std::abs(number - round(number)) > 0.1) ? String(number, 1) : String((int)round(number));
-        String lineText = numberString;
-        if (!useSemitoneTexts)
-            lineText += "c";
-
-        g.setColour(ModernLookAndFeel::Colors::textSecondary);
-        g.setFont(Font(11.0f));
-        g.drawText(lineText, juce::Rectangle<float>(0, yFlip(float(linePos) + 7), sidebarWidth - 6, 14), Justification::centredRight);
-
-        // don't overwrite maximum "in-tune" lines
-        if (y * lineInterval == allowedPitchOffset || y * lineInterval == -allowedPitchOffset)
-            continue;
-
-        g.setColour(ModernLookAndFeel::Colors::panelLight.withAlpha(0.3f));
-        const float lineDashLengths[] = {2, 8};
-        g.drawDashedLine(Line<float>(sidebarWidth, yFlip((float)linePos), (float)width, yFlip((float)linePos)), lineDashLengths, 2);
+        Graphics g(backgroundCache);
+        g.addTransform(AffineTransform::scale(scale));
+        g.fillAll(ModernLookAndFeel::Colors::background);
+        painter.drawChartBackground(g, cachedLayout);
     }
 
-    // Draw pitch measurement bars with modern styling
-    for (int i = 0; i < measurements.size(); i++)
-    {
-        float left = sidebarWidth + i * (float)columnWidth;
-        float barCenter = left + (float)columnWidth / 2.0f;
-        float barWidth = jmax(2.0f, (float)columnWidth * 0.7f);
-
-        // draw deviation range
-        float maxPosition = (float)((measurements[i].pitchOffset + measurements[i].pitchDeviation - min) * vertScaling) ;
-        float minPosition = (float)((measurements[i].pitchOffset - measurements[i].pitchDeviation - min) * vertScaling) ;
-
-        // Determine color based on pitch offset
-        float pitchCents = (float)(measurements[i].pitchOffset * 100.0);
-        Colour barColor;
-        if (std::abs(pitchCents) < 5.0f)
-            barColor = ModernLookAndFeel::Colors::meter;
-        else if (std::abs(pitchCents) < 15.0f)
-            barColor = ModernLookAndFeel::Colors::meterWarn;
-        else
-            barColor = ModernLookAndFeel::Colors::meterBad;
+    Graphics g(chartCache);
+    g.drawImageAt(backgroundCache, 0, 0);
+    g.addTransform(AffineTransform::scale(scale));
+    painter.drawColumns(g, cachedLayout, Range<int>(0, measurements.size()));
+    painter.drawNoteLabels(g, cachedLayout);
 
-        // Draw deviation band
-        g.setColour(barColor.withAlpha(0.25f));
-        g.fillRoundedRectangle(barCenter - barWidth / 2, yFlip(maxPosition), barWidth, maxPosition - minPosition, 2.0f);
-
-        // Draw average value bar
-        float pointPosition = (float)((measurements[i].pitchOffset - min) * vertScaling) ;
-        float centerLineY = (float)((-min) * vertScaling) ;
+    cachedRange = range;
+    cachedNumMeasurements = measurements.size();
+    cacheScale = scale;
+    chartCacheValid = true;
+}
 
-        // Bar from center to value
-        float barTop = jmin(pointPosition, centerLineY);
-        float barHeight = std::abs(pointPosition - centerLineY);
+void Visualizer::renderColumns(Range<int> columns)
+{
+    Rectangle<int> area = painter.getColumnArea(cachedLayout, columns);
 
-        g.setColour(barColor);
-        g.fillRoundedRectangle(barCenter - barWidth / 2, yFlip(barTop + barHeight), barWidth, barHeight, 2.0f);
+    // the columns whose glow reaches into the area have to be redrawn as well
+    Range<int> redrawn(columns.getStart() - (1 << cachedLayout.level), columns.getEnd() + (1 << cachedLayout.level));
 
-        // Draw glow effect for the bar
-        g.setColour(barColor.withAlpha(0.3f));
-        g.fillRoundedRectangle(barCenter - barWidth / 2 - 2, yFlip(barTop + barHeight) - 2,
-                               barWidth + 4, barHeight + 4, 3.0f);
-    }
+    Graphics g(chartCache);
+    g.reduceClipRegion((area.toFloat() * cacheScale).getSmallestIntegerContainer());
+    g.drawImageAt(backgroundCache, 0, 0);
+    g.addTransform(AffineTransform::scale(cacheScale));
+    painter.drawColumns(g, cachedLayout, redrawn);
+    painter.drawNoteLabels(g, cachedLayout);
+}
 
-    // Draw the X-Axis label
-    g.setColour(ModernLookAndFeel::Colors::textSecondary);
-    g.setFont(Font(12.0f));
-    g.drawText("MIDI Note", 0, height - bottomBarHeight, (int)sidebarWidth - 10, bottomBarHeight, Justification::centredRight);
-
-    // Draw note labels on X axis
-    const int numPitchTextIntervals = 5;
-    const int pitchTextIntervals[numPitchTextIntervals] = {1, 2, 5, 10, 20};
-    int currentPitchTextIntervalIndex = 0;
-    while (g.getCurrentFont().getStringWidth("123.") > pitchTextIntervals[currentPitchTextIntervalIndex] * columnWidth)
-    {
-        currentPitchTextIntervalIndex++;
-        if (currentPitchTextIntervalIndex >= numPitchTextIntervals)
-            break;
-    }
-    int pitchTextInterval = pitchTextIntervals[currentPitchTextIntervalIndex];
-    int startLine = 0;
-    int endLine = measurements.size() - 1;
-    while (measurements[startLine].midiPitch % pitchTextInterval != 0)
-    {
-        startLine++;
-        if (startLine >= measurements.size())
-            return;
-    }
-    while (measurements[endLine].midiPitch % pitchTextInterval != 0)
+void Visualizer::paint(Graphics& g)
+{
+    if (measurements.isEmpty())
     {
-        endLine--;
-        if (endLine < 0 || endLine < startLine)
-            return;
+        paint(g, getWidth(), getHeight());
+        return;
     }
 
-    for (int i = startLine; i <= endLine; i += pitchTextInterval)
-    {
-        g.setColour(ModernLookAndFeel::Colors::textSecondary);
-        g.setFont(Font(11.0f));
-        float textWidth = g.getCurrentFont().getStringWidth(String(measurements[i].midiPitch));
-        float xLeft = sidebarWidth + i * float(columnWidth);
-        float x = xLeft + float(columnWidth) / 2.0f - textWidth / 2.0f;
-        float yPos = height - bottomBarHeight + 8;
-        g.drawText(String(measurements[i].midiPitch), juce::Rectangle<float>(x, yPos, textWidth, bottomBarHeight - 10), Justification::centred);
-
-        // the line for the reference pitch will be drawn later
-        if (measurements[i].midiPitch == tuner->getReferencePitch())
-            continue;
-
-        // also draw dim vertical lines for the larger divisions
-        if (pitchTextInterval >= 2)
-        {
-            g.setColour(ModernLookAndFeel::Colors::accentAlt.withAlpha(0.05f));
-            g.fillRect(Rectangle<float>(xLeft, chartTop, float(columnWidth), (float)imageHeight));
-        }
-    }
+    // the chart is drawn from the cache, only the info panel is drawn every time
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (!chartCacheValid || scale != cacheScale)
+        renderChartCache(scale);
+    else if (!dirtyColumns.isEmpty())
+        renderColumns(dirtyColumns);
+    dirtyColumns = Range<int>();
 
-    // Draw a highlight for the reference pitch (if included in the measurements)
-    if (measurements[0].midiPitch < tuner->getReferencePitch() &&
-        measurements.getLast().midiPitch > tuner->getReferencePitch())
+    if (!chartCacheValid)
     {
-        for (int i = 0; i < measurements.size(); i++)
-        {
-            if (measurements[i].midiPitch == tuner->getReferencePitch())
-            {
-                float xLeft = sidebarWidth + i * float(columnWidth);
-                g.setColour(ModernLookAndFeel::Colors::accentAlt.withAlpha(0.15f));
-                g.fillRect(Rectangle<float>(xLeft, chartTop, float(columnWidth), (float)imageHeight));
-
-                // Draw reference label
-                g.setColour(ModernLookAndFeel::Colors::accentAlt);
-                g.setFont(Font(10.0f, Font::bold));
-                g.drawText("REF", xLeft, height - bottomBarHeight + 22, float(columnWidth), 12, Justification::centred);
-            }
-        }
+        paint(g, getWidth(), getHeight());
+        return;
     }
 
+    g.drawImage(chartCache, getLocalBounds().toFloat());
+    painter.drawTopInfoPanel(g, getWidth(), ChartPainter::topInfoHeight);
 }
 
-void Visualizer::drawTopInfoPanel(Graphics& g, int width, int panelHeight)
+void Visualizer::resized()
 {
-    // Panel background
-    Rectangle<float> panelBounds(10, 5, width - 20, panelHeight - 10);
-    ModernLookAndFeel::drawPanel(g, panelBounds, 10.0f);
-
-    if (measurements.size() == 0)
-        return;
-
-    // Find current/latest measurement
-    const auto& current = measurements.getLast();
-
-    // Calculate statistics
-    float maxOffset = 0, minOffset = 0, avgOffset = 0;
-    for (int i = 0; i < measurements.size(); i++)
-    {
-        float offset = (float)measurements[i].pitchOffset;
-        if (offset > maxOffset) maxOffset = offset;
-        if (offset < minOffset) minOffset = offset;
-        avgOffset += offset;
-    }
-    avgOffset /= measurements.size();
-
-    // Layout: divide into sections
-    float sectionWidth = (panelBounds.getWidth() - 40) / 4.0f;
-    float startX = panelBounds.getX() + 20;
-    float topY = panelBounds.getY() + 8;
-
-    // Section 1: Current Note & Frequency
-    g.setColour(ModernLookAndFeel::Colors::textDim);
-    g.setFont(Font(10.0f));
-    g.drawText("CURRENT NOTE", startX, topY, sectionWidth, 12, Justification::left);
+    chartCacheValid = false;
+}
 
-    g.setColour(ModernLookAndFeel::Colors::textPrimary);
-    g.setFont(Font(24.0f, Font::bold));
-    String noteName = MidiMessage::getMidiNoteName(current.midiPitch, true, true, 4);
-    g.drawText(noteName, startX, topY + 14, sectionWidth, 28, Justification::left);
+Range<int> Visualizer::getVisibleColumns() const
+{
+    Range<int> all(0, measurements.size());
+    Range<int> visible = visibleColumns.getIntersectionWith(all);
+    return visible.isEmpty() ? all : visible;
+}
 
-    g.setColour(ModernLookAndFeel::Colors::textSecondary);
-    g.setFont(Font(12.0f));
-    g.drawText(String(current.frequency, 2) + " Hz", startX, topY + 42, sectionWidth, 16, Justification::left);
-
-    // Section 2: Current Error (cents)
-    startX += sectionWidth;
-    g.setColour(ModernLookAndFeel::Colors::textDim);
-    g.setFont(Font(10.0f));
-    g.drawText("PITCH ERROR", startX, topY, sectionWidth, 12, Justification::left);
-
-    float currentCents = (float)(current.pitchOffset * 100.0);
-    Colour errorColor;
-    if (std::abs(currentCents) < 5.0f)
-        errorColor = ModernLookAndFeel::Colors::meter;
-    else if (std::abs(currentCents) < 15.0f)
-        errorColor = ModernLookAndFeel::Colors::meterWarn;
-    else
-        errorColor = ModernLookAndFeel::Colors::meterBad;
+void Visualizer::setVisibleColumns(Range<int> columns)
+{
+    const int numColumns = measurements.size();
+    int length = jlimit(jmin(minVisibleColumns, numColumns), numColumns, columns.getLength());
+    int start = jlimit(0, numColumns - length, columns.getStart());
 
-    g.setColour(errorColor);
-    g.setFont(Font(24.0f, Font::bold));
-    String errorStr = (currentCents >= 0 ? "+" : "") + String(currentCents, 1) + "c";
-    g.drawText(errorStr, startX, topY + 14, sectionWidth, 28, Justification::left);
+    // showing everything follows the sweep as new notes come in
+    Range<int> newColumns = length >= numColumns ? Range<int>() : Range<int>(start, start + length);
+    if (newColumns.getStart() == visibleColumns.getStart() && newColumns.getEnd() == visibleColumns.getEnd())
+        return;
 
-    // Mini tuning meter
-    Rectangle<float> meterBounds(startX, topY + 46, sectionWidth - 20, 12);
-    ModernLookAndFeel::drawMeter(g, meterBounds, currentCents, -50.0f, 50.0f);
+    visibleColumns = newColumns;
+    chartCacheValid = false;
+    updateScheduler.requestRepaint();
+}
 
-    // Section 3: Statistics
-    startX += sectionWidth;
-    g.setColour(ModernLookAndFeel::Colors::textDim);
-    g.setFont(Font(10.0f));
-    g.drawText("STATISTICS", startX, topY, sectionWidth, 12, Justification::left);
+void Visualizer::mouseWheelMove(const MouseEvent& e, const MouseWheelDetails& wheel)
+{
+    if (measurements.size() < 2 || wheel.deltaY == 0.0f)
+        return;
 
-    g.setColour(ModernLookAndFeel::Colors::textSecondary);
-    g.setFont(Font(11.0f));
-    g.drawText("Max: " + String(maxOffset * 100, 1) + "c", startX, topY + 16, sectionWidth, 14, Justification::left);
-    g.drawText("Min: " + String(minOffset * 100, 1) + "c", startX, topY + 30, sectionWidth, 14, Justification::left);
-    g.drawText("Avg: " + String(avgOffset * 100, 1) + "c", startX, topY + 44, sectionWidth, 14, Justification::left);
+    // zoom around the column under the mouse
+    Range<int> visible = getVisibleColumns();
+    double chartWidth = jmax(1.0, getWidth() - (double)ChartPainter::sidebarWidth);
+    double proportion = jlimit(0.0, 1.0, (e.position.x - ChartPainter::sidebarWidth) / chartWidth);
+    double anchor = visible.getStart() + proportion * visible.getLength();
 
-    // Section 4: Progress
-    startX += sectionWidth;
-    g.setColour(ModernLookAndFeel::Colors::textDim);
-    g.setFont(Font(10.0f));
-    g.drawText("PROGRESS", startX, topY, sectionWidth, 12, Justification::left);
+    int length = roundToInt(visible.getLength() * std::pow(2.0, -4.0 * wheel.deltaY));
+    if (length == visible.getLength())
+        length += wheel.deltaY > 0 ? -1 : 1;
 
-    g.setColour(ModernLookAndFeel::Colors::textPrimary);
-    g.setFont(Font(18.0f, Font::bold));
-    g.drawText(String(measurements.size()) + " pts", startX, topY + 14, sectionWidth, 24, Justification::left);
+    int start = roundToInt(anchor - proportion * length);
+    setVisibleColumns(Range<int>(start, start + length));
+}
 
-    g.setColour(ModernLookAndFeel::Colors::textSecondary);
-    g.setFont(Font(11.0f));
-    g.drawText("Range: " + String(measurements[0].midiPitch) + "-" + String(measurements.getLast().midiPitch),
-               startX, topY + 42, sectionWidth, 14, Justification::left);
+void Visualizer::mouseDown(const MouseEvent& /*e*/)
+{
+    dragStartColumns = getVisibleColumns();
 }
 
-void Visualizer::paint(Graphics& g)
+void Visualizer::mouseDrag(const MouseEvent& e)
 {
-    paint(g, getWidth(), getHeight());
+    if (dragStartColumns.isEmpty())
+        return;
+
+    // pan by whole columns
+    double columnWidth = (getWidth() - (double)ChartPainter::sidebarWidth) / dragStartColumns.getLength();
+    int shift = roundToInt(-e.getDistanceFromDragStartX() / columnWidth);
+    setVisibleColumns(dragStartColumns + shift);
 }
 
-float Visualizer::yFlip(float y)
+void Visualizer::mouseDoubleClick(const MouseEvent& /*e*/)
 {
-    return heightForFlipping - y;
+    setVisibleColumns(Range<int>(0, measurements.size()));
 }
 
-void Visualizer::newMeasurementReady(const VCOTuner::measurement_t& m)
+void Visualizer::measurementsChanged(const MeasurementStore& /*store*/, Range<int> dirtyPitches)
 {
-    bool found = false;
-    for (int i = 0; i < measurements.size(); i++)
+    // a new note moves all columns and a new display range rescales them,
+    // otherwise only the column of the re-measured note has to be redrawn
+    int column = measurements.indexOf(dirtyPitches.getStart());
+    if (measurements.isEmpty())
+        visibleColumns = Range<int>();
+
+    // keep the levels of detail up to date for a single re-measured note
+    if (column >= 0 && dirtyPitches.getLength() == 1)
+        painter.measurementChanged(column);
+
+    Range<double> range = painter.getAutoRange();
+    if (!chartCacheValid
+        || dirtyPitches.getLength() != 1
+        || column < 0
+        || measurements.size() != cachedNumMeasurements
+        || range.getStart() != cachedRange.getStart()
+        || range.getEnd() != cachedRange.getEnd())
     {
-        if (measurements[i].midiPitch == m.midiPitch)
-        {
-            measurements.set(i, m);
-            found = true;
-            repaint();
-        }
+        chartCacheValid = false;
+        updateScheduler.requestRepaint();
+        return;
     }
 
-    if (!found)
-        measurements.add(m);
-
-    repaint();
+    Range<int> columns(column, column + 1);
+    dirtyColumns = dirtyColumns.isEmpty() ? columns : dirtyColumns.getUnionWith(columns);
+    updateScheduler.requestRepaint(painter.getColumnArea(cachedLayout, columns));
+    updateScheduler.requestRepaint(Rectangle<int>(0, 0, getWidth(), ChartPainter::topInfoHeight));
 }
 
 void Visualizer::drawTunerDial(Graphics& g, Rectangle<float> bounds, float cents, int midiNote, float frequency)
@@ -12,9 +12,12 @@
 #define VISUALIZER_H_INCLUDED
 
 #include "VCOTuner.h"
+#include "Measurement/MeasurementStore.h"
+#include "ChartPainter.h"
+#include "UpdateScheduler.h"
 
 class Visualizer: public Component,
-                  public VCOTuner::Listener
+                  public MeasurementStore::Listener
 {
 public:
     Visualizer(VCOTuner* t);
@@ -23,23 +26,52 @@ public:
     void paintWithFixedScaling(Graphics& g, int width, int height, double min, double max);
     void paint(Graphics& g, int width, int height);
     virtual void paint(Graphics& g);
+    virtual void resized();
     
-    virtual void newMeasurementReady(const VCOTuner::measurement_t& m);
+    /** the mouse wheel zooms into a range of notes, dragging pans and a double click shows all */
+    virtual void mouseWheelMove(const MouseEvent& e, const MouseWheelDetails& wheel);
+    virtual void mouseDown(const MouseEvent& e);
+    virtual void mouseDrag(const MouseEvent& e);
+    virtual void mouseDoubleClick(const MouseEvent& e);
     
+    virtual void measurementsChanged(const MeasurementStore& store, Range<int> dirtyPitches);
+    
+    /** removes all measurements from the tuner's store, which all views share */
     void clearCache() { measurements.clear(); }
 
 private:
-    void drawTopInfoPanel(Graphics& g, int width, int panelHeight);
+    static const int minVisibleColumns = 4;
+    
+    /** the zoomed range of measurements, empty shows all of them */
+    Range<int> getVisibleColumns() const;
+    void setVisibleColumns(Range<int> columns);
+    Range<int> visibleColumns;
+    Range<int> dragStartColumns;
+    
+    /** the static layers and the complete chart at the physical pixel size. A
+        re-measured note only redraws its own column from the static layers. */
+    void renderChartCache(float scale);
+    void renderColumns(Range<int> columns);
+    Image backgroundCache;
+    Image chartCache;
+    ChartPainter::ChartLayout cachedLayout;
+    Range<double> cachedRange;
+    int cachedNumMeasurements = 0;
+    float cacheScale = 1.0f;
+    bool chartCacheValid = false;
+    Range<int> dirtyColumns;
+    
     void drawTunerDial(Graphics& g, Rectangle<float> bounds, float cents, int midiNote, float frequency);
     void drawTunerArc(Graphics& g, float centerX, float centerY, float radius, float cents);
 
-    /** holds the list of completed measurements */
-    Array<VCOTuner::measurement_t> measurements;
-    
-    float heightForFlipping;
-    float yFlip(float y);
+    /** the completed measurements, owned by the tuner */
+    MeasurementStore& measurements;
+    ChartPainter painter;
     
     VCOTuner* tuner;
+    
+    /** limits the repaints to the display's frame rate */
+    UpdateScheduler updateScheduler;
 };
 
 